@@ -0,0 +1,103 @@
+// Chunk reassembly throughput for a 32 MiB NumGrid message cut into 64 KiB
+// and 1 MiB protocol::Chunk buffers. Each chunk buffer is verified, then
+// appended to a std::vector (the ad-hoc host loop, in order only) or handed to
+// ChunkAssembler in order and shuffled with every 8th chunk repeated. Every
+// variant ends by verifying the reassembled Any root.
+//
+//   bench_chunks [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/ChunkAssembler.h"
+
+namespace {
+
+using Chunks = std::vector<std::vector<uint8_t>>;
+
+double Ms(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1, int iters) {
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+}
+
+// The host loop this replaces: grow a vector chunk by chunk, trusting order.
+size_t VectorAppend(const Chunks& chunks) {
+    std::vector<uint8_t> buf;
+    for (const auto& c : chunks) {
+        flatbuffers::Verifier verifier(c.data(), c.size());
+        if (!verifier.VerifyBuffer<protocol::Chunk>(nullptr)) return 0;
+        const auto* data = flatbuffers::GetRoot<protocol::Chunk>(c.data())->data();
+        buf.insert(buf.end(), data->data(), data->data() + data->size());
+    }
+    flatbuffers::Verifier verifier(buf.data(), buf.size());
+    return verifier.VerifyBuffer<protocol::Any>(nullptr) ? buf.size() : 0;
+}
+
+size_t Assemble(ChunkAssembler& assembler, const Chunks& chunks) {
+    AssembledMessage msg;
+    for (const auto& c : chunks) {
+        if (assembler.AddBuffer(c.data(), c.size(), msg) == ChunkStatus::Complete) break;
+    }
+    return msg.Root<protocol::Any>() ? msg.Size() : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::atoi(argv[1]) : 20;
+    if (iters <= 0) iters = 20;
+
+    const size_t count = (size_t(32) << 20) / sizeof(double);
+    std::vector<double> nums(count);
+    for (size_t i = 0; i < count; ++i) nums[i] = (double)i * 0.25;
+    flatbuffers::FlatBufferBuilder builder;
+    auto ng = protocol::CreateNumGrid(builder, (int)(count / 1024), 1024, builder.CreateVector(nums));
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+    const uint8_t* msg = builder.GetBufferPointer();
+    const size_t msgSize = builder.GetSize();
+
+    std::printf("%zu MiB message, MiB/s (ms per message)\n", msgSize >> 20);
+    std::printf("%-10s %22s %22s %22s\n", "chunk", "vector append", "assembler in order", "assembler shuffled");
+    size_t sink = 0;
+    for (size_t chunkBytes : {size_t(64) << 10, size_t(1) << 20}) {
+        Chunks inOrder;
+        flatbuffers::FlatBufferBuilder cb;
+        SplitIntoChunks(cb, 1, 0, msg, msgSize, chunkBytes,
+                        [&](const uint8_t* buf, size_t len) { inOrder.emplace_back(buf, buf + len); });
+        Chunks shuffled = inOrder;
+        for (size_t i = 0; i < inOrder.size(); i += 8) shuffled.push_back(inOrder[i]);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+        sink += VectorAppend(inOrder); // warm-up
+        auto t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) sink += VectorAppend(inOrder);
+        const double appendMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+        // A fresh assembler per message: the id is reused by every iteration.
+        t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) {
+            ChunkAssembler assembler;
+            sink += Assemble(assembler, inOrder);
+        }
+        const double orderedMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+        t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) {
+            ChunkAssembler assembler;
+            sink += Assemble(assembler, shuffled);
+        }
+        const double shuffledMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+        auto rate = [&](double ms) { return (double)msgSize / (1 << 20) / (ms / 1000.0); };
+        std::printf("%6zu KiB %12.0f (%7.2f) %12.0f (%7.2f) %12.0f (%7.2f)\n", chunkBytes >> 10, rate(appendMs), appendMs,
+                    rate(orderedMs), orderedMs, rate(shuffledMs), shuffledMs);
+    }
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
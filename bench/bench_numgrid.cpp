@@ -0,0 +1,92 @@
+// NumGrid -> xltypeMulti at 1k, 100k and 1M cells: the per-element Get()
+// loop AnyToXLOPER12 used to run vs the bulk FillNumCells kernel, and the
+// kernel again with the array served from the XLOPER12 payload arena. Every
+// variant includes allocating and releasing the array.
+//
+//   bench_numgrid [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+#include "types/mem.h"
+
+namespace {
+
+double Ms(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1, int iters) {
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::atoi(argv[1]) : 20;
+    if (iters <= 0) iters = 20;
+
+    const int shapes[][2] = {{1000, 1}, {1000, 100}, {10000, 100}};
+    double sink = 0;
+    std::printf("%10s %12s %12s %12s\n", "cells", "Get loop ms", "kernel ms", "arena ms");
+    for (const auto& shape : shapes) {
+        const int rows = shape[0], cols = shape[1];
+        const size_t count = (size_t)rows * cols;
+        std::vector<double> values(count);
+        for (size_t i = 0; i < count; ++i) values[i] = (double)i * 0.25;
+
+        flatbuffers::FlatBufferBuilder builder;
+        auto ng = protocol::CreateNumGrid(builder, rows, cols, builder.CreateVector(values));
+        builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+        const auto* any = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+        const auto* data = any->val_as_NumGrid()->data();
+
+        // Baseline: the former AnyToXLOPER12 body, new[] + one Get() per cell,
+        // released the way xlAutoFree12 does.
+        auto t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) {
+            XLOPER12 multi;
+            multi.xltype = xltypeMulti;
+            multi.val.array.rows = rows;
+            multi.val.array.columns = cols;
+            XLOPER12* cells = multi.val.array.lparray = new XLOPER12[count];
+            for (size_t i = 0; i < count; ++i) {
+                cells[i].xltype = xltypeNum;
+                cells[i].val.num = data->Get((flatbuffers::uoffset_t)i);
+            }
+            sink += cells[count - 1].val.num;
+            FreeDllOwnedContents(&multi);
+        }
+        const double getMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+        // AnyToXLOPER12 + xlAutoFree12: same allocation, bulk fill.
+        xlAutoFree12(AnyToXLOPER12(any)); // warm-up (CPU dispatch, XLOPER12 pool)
+        t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) {
+            LPXLOPER12 op = AnyToXLOPER12(any);
+            sink += op->val.array.lparray[count - 1].val.num;
+            xlAutoFree12(op);
+        }
+        const double kernelMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+        // Same with the payload arena: the array memory stays mapped between
+        // calls, so this is close to the fill alone.
+        EnableXlArena(count * sizeof(XLOPER12) + 64, 1);
+        t0 = std::chrono::steady_clock::now();
+        for (int it = 0; it < iters; ++it) {
+            LPXLOPER12 op = AnyToXLOPER12(any);
+            sink += op->val.array.lparray[count - 1].val.num;
+            xlAutoFree12(op);
+        }
+        const double arenaMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+        DisableXlArena();
+        XlArenaTrim();
+
+        std::printf("%10zu %12.3f %12.3f %12.3f\n", count, getMs, kernelMs, arenaMs);
+    }
+    std::printf("(checksum %g)\n", sink);
+    return 0;
+}
@@ -0,0 +1,179 @@
+// ObjectPool<XLOPER12> acquire/release throughput at 1 to 64 threads: the
+// former implementation (a shard mutex taken on every call) vs the current
+// pool with per-thread magazines. Each thread runs a UDF-like loop that
+// acquires a few values and releases them, a cross-thread phase where one
+// half of the threads acquires and the other half releases, and a grid-sized
+// phase (256 at a time): Acquire per object on the locked pool vs
+// AcquireBulk / ReleaseBulk.
+//
+//   bench_object_pool [operations per thread]
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+#include "types/xlcall.h"
+#include "types/ObjectPool.h"
+
+namespace {
+
+// ObjectPool as it was before magazines: every call locks the thread's shard.
+template <typename T, size_t ShardCount = 16>
+class LockedPool {
+    struct alignas(64) Shard {
+        std::vector<T*> pool;
+        std::mutex mutex;
+    };
+    std::array<Shard, ShardCount> shards_;
+
+    size_t GetShardIndex() const {
+        return std::hash<std::thread::id>{}(std::this_thread::get_id()) % ShardCount;
+    }
+
+public:
+    T* Acquire() {
+        Shard& shard = shards_[GetShardIndex()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.pool.empty()) return new T();
+        T* item = shard.pool.back();
+        shard.pool.pop_back();
+        return item;
+    }
+    void Release(T* item) {
+        Shard& shard = shards_[GetShardIndex()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.pool.push_back(item);
+    }
+    ~LockedPool() {
+        for (auto& shard : shards_)
+            for (T* item : shard.pool) delete item;
+    }
+};
+
+// Runs `body(thread index)` on `threads` threads released together; returns
+// the wall time in seconds.
+double RunThreads(int threads, const std::function<void(int)>& body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load()) std::this_thread::yield();
+            body(t);
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    auto t0 = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto& th : pool) th.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Each thread: acquire 4 values, touch them, release them; `ops` pairs total.
+template <typename Pool>
+double LocalMops(Pool& pool, int threads, long ops) {
+    double s = RunThreads(threads, [&](int) {
+        XLOPER12* held[4];
+        for (long i = 0; i < ops; i += 4) {
+            for (auto& p : held) {
+                p = pool.Acquire();
+                p->xltype = xltypeNum;
+            }
+            for (auto* p : held) pool.Release(p);
+        }
+    });
+    return 2.0 * ops * threads / s / 1e6;
+}
+
+// Even threads acquire and hand values over a queue; odd threads release
+// them (the xlAutoFree12-on-another-thread pattern).
+template <typename Pool>
+double HandoffMops(Pool& pool, int threads, long ops) {
+    if (threads < 2) return 0;
+    const int pairs = threads / 2;
+    std::vector<std::vector<XLOPER12*>> boxes(pairs);
+    std::vector<std::mutex> locks(pairs);
+    double s = RunThreads(pairs * 2, [&](int t) {
+        const int pair = t / 2;
+        std::vector<XLOPER12*> batch;
+        for (long i = 0; i < ops; i += 64) {
+            if (t % 2 == 0) {
+                for (int k = 0; k < 64; ++k) batch.push_back(pool.Acquire());
+                std::lock_guard<std::mutex> lock(locks[pair]);
+                boxes[pair].insert(boxes[pair].end(), batch.begin(), batch.end());
+            } else {
+                {
+                    std::lock_guard<std::mutex> lock(locks[pair]);
+                    batch.swap(boxes[pair]);
+                }
+                for (XLOPER12* p : batch) pool.Release(p);
+            }
+            batch.clear();
+        }
+    });
+    for (auto& box : boxes)
+        for (XLOPER12* p : box) pool.Release(p);
+    return 1.0 * ops * pairs * 2 / s / 1e6;
+}
+
+// Each thread: acquire 256 values at once and release them.
+const size_t kGridBatch = 256;
+
+double GridLockedMops(LockedPool<XLOPER12>& pool, int threads, long ops) {
+    double s = RunThreads(threads, [&](int) {
+        XLOPER12* held[kGridBatch];
+        for (long i = 0; i < ops; i += kGridBatch) {
+            for (auto& p : held) p = pool.Acquire();
+            for (auto* p : held) pool.Release(p);
+        }
+    });
+    return 2.0 * ops * threads / s / 1e6;
+}
+
+double GridBulkMops(ObjectPool<XLOPER12>& pool, int threads, long ops) {
+    double s = RunThreads(threads, [&](int) {
+        XLOPER12* held[kGridBatch];
+        for (long i = 0; i < ops; i += kGridBatch) {
+            pool.AcquireBulk(held, kGridBatch);
+            pool.ReleaseBulk(held, kGridBatch);
+        }
+    });
+    return 2.0 * ops * threads / s / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long ops = (argc > 1) ? std::atol(argv[1]) : 2000000;
+    if (ops <= 0) ops = 2000000;
+
+    std::printf("acquire+release, millions of operations per second\n");
+    std::printf("%8s %16s %16s %16s %16s %16s %16s\n", "threads", "local locked", "local magazine", "handoff locked",
+                "handoff magazine", "grid locked", "grid bulk");
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        double localLocked, localMag, handLocked, handMag, gridLocked, gridBulk;
+        {
+            LockedPool<XLOPER12> pool;
+            localLocked = LocalMops(pool, threads, ops);
+            handLocked = HandoffMops(pool, threads, ops);
+            gridLocked = GridLockedMops(pool, threads, ops);
+        }
+        {
+            ObjectPool<XLOPER12> pool;
+            localMag = LocalMops(pool, threads, ops);
+            handMag = HandoffMops(pool, threads, ops);
+            gridBulk = GridBulkMops(pool, threads, ops);
+        }
+        std::printf("%8d %16.1f %16.1f %16.1f %16.1f %16.1f %16.1f\n", threads, localLocked, localMag, handLocked, handMag,
+                    gridLocked, gridBulk);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Builder growth on large conversions: buffer allocations, bytes copied by
+// growth and time for ConvertAny / ConvertGrid into a default-sized builder
+// vs the Presized entry points (EstimateSerializedSize + ReserveBuilder).
+//
+//   bench_presize [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+
+namespace {
+
+// Counts buffers and the bytes each growth step copies over.
+struct CountingAllocator : flatbuffers::DefaultAllocator {
+    size_t allocations = 0;
+    size_t bytesCopied = 0;
+    uint8_t* allocate(size_t size) override {
+        ++allocations;
+        return flatbuffers::DefaultAllocator::allocate(size);
+    }
+    uint8_t* reallocate_downward(uint8_t* old_p, size_t old_size, size_t new_size, size_t in_use_back,
+                                 size_t in_use_front) override {
+        bytesCopied += in_use_back + in_use_front;
+        return flatbuffers::Allocator::reallocate_downward(old_p, old_size, new_size, in_use_back, in_use_front);
+    }
+};
+
+struct Shape {
+    const char* name;
+    std::vector<XLOPER12> cells;
+    XLOPER12 multi;
+};
+
+XCHAR g_word[] = {6, L'T', L'I', L'C', L'K', L'E', L'R', 0};
+
+// 1M cells (10000 x 100): `kind` 0 all numbers, 1 numbers with a 1-in-7 #N/A,
+// 2 a number / string / boolean mix that stays on the boxed Grid.
+void MakeShape(Shape& s, const char* name, int kind) {
+    const int rows = 10000, cols = 100;
+    s.name = name;
+    s.cells.resize((size_t)rows * cols);
+    std::memset(s.cells.data(), 0, s.cells.size() * sizeof(XLOPER12));
+    for (size_t i = 0; i < s.cells.size(); ++i) {
+        XLOPER12& c = s.cells[i];
+        c.xltype = xltypeNum;
+        c.val.num = (double)i * 0.25;
+        if (kind == 1 && i % 7 == 0) {
+            c.xltype = xltypeErr;
+            c.val.err = xlerrNA;
+        } else if (kind == 2 && i % 3 == 1) {
+            c.xltype = xltypeStr;
+            c.val.str = g_word;
+        } else if (kind == 2 && i % 3 == 2) {
+            c.xltype = xltypeBool;
+            c.val.xbool = (i & 1);
+        }
+    }
+    s.multi.xltype = xltypeMulti;
+    s.multi.val.array.rows = rows;
+    s.multi.val.array.columns = cols;
+    s.multi.val.array.lparray = s.cells.data();
+}
+
+template <typename F>
+void Run(const char* label, F&& convert, int iters, size_t& sink) {
+    CountingAllocator alloc;
+    size_t size = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) {
+        flatbuffers::FlatBufferBuilder builder(1024, &alloc);
+        convert(builder);
+        size = builder.GetSize();
+        sink += size;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+    std::printf("  %-22s %10zu %8.1f %12.1f %10.2f\n", label, size, (double)alloc.allocations / iters,
+                (double)alloc.bytesCopied / iters / (1024.0 * 1024.0), ms);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::atoi(argv[1]) : 10;
+    if (iters <= 0) iters = 10;
+
+    static Shape shapes[3];
+    MakeShape(shapes[0], "numbers", 0);
+    MakeShape(shapes[1], "numbers+NA", 1);
+    MakeShape(shapes[2], "mixed", 2);
+
+    size_t sink = 0;
+    std::printf("  %-22s %10s %8s %12s %10s\n", "", "bytes", "allocs", "copied MB", "ms");
+    for (Shape& s : shapes) {
+        LPXLOPER12 op = &s.multi;
+        std::printf("%s (estimate %zu bytes)\n", s.name, EstimateSerializedSize(op));
+        Run("ConvertAny", [&](flatbuffers::FlatBufferBuilder& b) { b.Finish(ConvertAny(op, b)); }, iters, sink);
+        Run("ConvertAnyPresized", [&](flatbuffers::FlatBufferBuilder& b) { b.Finish(ConvertAnyPresized(op, b)); },
+            iters, sink);
+        Run("ConvertGrid", [&](flatbuffers::FlatBufferBuilder& b) { b.Finish(ConvertGrid(op, b)); }, iters, sink);
+        Run("ConvertGridPresized", [&](flatbuffers::FlatBufferBuilder& b) { b.Finish(ConvertGridPresized(op, b)); },
+            iters, sink);
+    }
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// 100k short-string grid round trip (1000 x 100 cells of 4 to 40 chars):
+// ConvertGrid, then back to an xltypeMulti and released the way xlAutoFree12
+// does. The decode side is timed three ways: one new XCHAR[] per cell (the
+// former GridToXLOPER12 per-cell path), per-cell buffers from the Pascal
+// string slab (the current PerCell path), and the single-block
+// XlGridAlloc::Slab layout for reference.
+//
+//   bench_strings [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+#include "types/mem.h"
+#include "types/pascalstr.h"
+#include "types/utility.h"
+
+namespace {
+
+double Ms(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1, int iters) {
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iters;
+}
+
+// GridToXLOPER12's per-cell decode before the slab: new XLOPER12[] and one
+// new XCHAR[] per string, freed element by element with delete[].
+void HeapRoundTrip(const protocol::Grid* grid, size_t& sink) {
+    const size_t count = grid->data()->size();
+    XLOPER12* cells = new XLOPER12[count];
+    for (size_t i = 0; i < count; ++i) {
+        const auto* str = grid->data()->Get((flatbuffers::uoffset_t)i)->val_as_Str()->val();
+        cells[i].xltype = xltypeStr | xlbitDLLFree;
+        Utf8ToExcelString(str->c_str(), cells[i].val.str);
+    }
+    sink += cells[count - 1].val.str[0];
+    for (size_t i = 0; i < count; ++i) delete[] cells[i].val.str;
+    delete[] cells;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::atoi(argv[1]) : 20;
+    if (iters <= 0) iters = 20;
+
+    const int rows = 1000, cols = 100;
+    const size_t count = (size_t)rows * cols;
+    std::vector<std::wstring> text(count);
+    std::vector<XCHAR*> bodies(count);
+    std::vector<XLOPER12> cells(count);
+    for (size_t i = 0; i < count; ++i) {
+        text[i] = L"item" + std::to_wstring(i) + std::wstring(i % 33, L'x');
+        bodies[i] = new XCHAR[text[i].size() + 2];
+        WritePascalWString(bodies[i], text[i].data(), text[i].size());
+        cells[i].xltype = xltypeStr;
+        cells[i].val.str = bodies[i];
+    }
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = rows;
+    multi.val.array.columns = cols;
+    multi.val.array.lparray = cells.data();
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertGrid(&multi, builder));
+    const auto* grid = flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer());
+
+    size_t sink = 0;
+    // Encode side, common to every variant.
+    auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iters; ++it) {
+        flatbuffers::FlatBufferBuilder b(builder.GetSize() + 1024);
+        b.Finish(ConvertGrid(&multi, b));
+        sink += b.GetSize();
+    }
+    const double encodeMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+    HeapRoundTrip(grid, sink); // warm-up
+    t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iters; ++it) HeapRoundTrip(grid, sink);
+    const double heapMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+    xlAutoFree12(GridToXLOPER12(grid, XlGridAlloc::PerCell)); // warm-up: slab pages
+    t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iters; ++it) {
+        LPXLOPER12 op = GridToXLOPER12(grid, XlGridAlloc::PerCell);
+        sink += op->val.array.lparray[count - 1].val.str[0];
+        xlAutoFree12(op);
+    }
+    const double slabMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+    t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iters; ++it) {
+        LPXLOPER12 op = GridToXLOPER12(grid, XlGridAlloc::Slab);
+        sink += op->val.array.lparray[count - 1].val.str[0];
+        xlAutoFree12(op);
+    }
+    const double blockMs = Ms(t0, std::chrono::steady_clock::now(), iters);
+
+    std::printf("%zu string cells, ms per round trip\n", count);
+    std::printf("%-28s %10.3f\n", "encode (ConvertGrid)", encodeMs);
+    std::printf("%-28s %10.3f\n", "decode+free, new[] per cell", heapMs);
+    std::printf("%-28s %10.3f\n", "decode+free, string slab", slabMs);
+    std::printf("%-28s %10.3f\n", "decode+free, one block", blockMs);
+    ExcelStringSlabStats s = GetExcelStringSlabStats();
+    std::printf("slab pages %zu (%zu KiB)\n(checksum %zu)\n", s.pages, s.reservedBytes / 1024, sink);
+
+    for (XCHAR* p : bodies) delete[] p;
+    return 0;
+}
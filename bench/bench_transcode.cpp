@@ -0,0 +1,155 @@
+// UTF-16 <-> UTF-8: built-in kernels vs the previous Win32 paths on the
+// string shapes seen in grids.
+//
+//   encode: ConvertExcelString's old WideCharToMultiByte double call (size,
+//           then convert) vs Utf16ToUtf8 into a worst-case buffer.
+//   decode: Utf8ToExcelString's old MultiByteToWideChar stack/double call +
+//           temporary + copy vs Utf8ToUtf16 straight into the Pascal buffer.
+//
+//   bench_transcode [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/pascalstr.h"
+#include "types/transcode.h"
+
+namespace {
+
+struct Corpus {
+    const char* name;
+    std::vector<std::vector<XCHAR>> cells;
+    size_t units = 0;
+};
+
+Corpus MakeCorpus(const char* name, size_t cells, size_t len, XCHAR (*gen)(size_t)) {
+    Corpus c;
+    c.name = name;
+    c.cells.resize(cells);
+    for (size_t i = 0; i < cells; ++i) {
+        c.cells[i].resize(len);
+        for (size_t j = 0; j < len; ++j) c.cells[i][j] = gen(i * len + j);
+        c.units += len;
+    }
+    return c;
+}
+
+XCHAR GenTicker(size_t k) { return (XCHAR)(L'A' + (k % 26)); }
+XCHAR GenLatin(size_t k) { return (k % 7 == 0) ? (XCHAR)0x00E9 : (XCHAR)(L'a' + (k % 26)); }
+XCHAR GenCjk(size_t k) { return (XCHAR)(0x4E00 + (k % 0x5000)); }
+
+// Win32 baseline, as ConvertExcelString did it before: one call to size, one
+// to convert into an exactly-sized std::string.
+size_t RunWin32(const Corpus& c) {
+    size_t total = 0;
+    for (const auto& cell : c.cells) {
+        int n = WideCharToMultiByte(CP_UTF8, 0, cell.data(), (int)cell.size(), NULL, 0, NULL, NULL);
+        std::string s((size_t)n, 0);
+        WideCharToMultiByte(CP_UTF8, 0, cell.data(), (int)cell.size(), &s[0], n, NULL, NULL);
+        total += s.size();
+    }
+    return total;
+}
+
+size_t RunKernel(const Corpus& c) {
+    size_t total = 0;
+    for (const auto& cell : c.cells) {
+        std::string s(Utf8MaxBytesForUtf16(cell.size()), 0);
+        s.resize(Utf16ToUtf8(cell.data(), cell.size(), &s[0]));
+        total += s.size();
+    }
+    return total;
+}
+
+// Old Utf8ToExcelString: stack buffer for short input, otherwise size, decode
+// into a temporary, then copy into the Pascal buffer.
+size_t RunWin32Decode(const std::vector<std::string>& cells) {
+    size_t total = 0;
+    for (const auto& cell : cells) {
+        int len = (int)cell.size();
+        XCHAR stackBuf[256];
+        int needed = (len < 256) ? MultiByteToWideChar(CP_UTF8, 0, cell.data(), len, stackBuf, 256) : 0;
+        XCHAR* out;
+        if (needed > 0) {
+            out = new XCHAR[WritePascalWBufferLen((size_t)needed)];
+            WritePascalWString(out, stackBuf, (size_t)needed);
+        } else {
+            needed = MultiByteToWideChar(CP_UTF8, 0, cell.data(), len, NULL, 0);
+            std::vector<XCHAR> temp((size_t)needed);
+            MultiByteToWideChar(CP_UTF8, 0, cell.data(), len, temp.data(), needed);
+            out = new XCHAR[WritePascalWBufferLen((size_t)needed)];
+            WritePascalWString(out, temp.data(), (size_t)needed);
+        }
+        total += (size_t)out[0];
+        delete[] out;
+    }
+    return total;
+}
+
+size_t RunKernelDecode(const std::vector<std::string>& cells) {
+    size_t total = 0;
+    for (const auto& cell : cells) {
+        size_t cap = ClampExcelStringLen(cell.size());
+        XCHAR* out = new XCHAR[WritePascalWBufferLen(cap)];
+        StampPascalWString(out, Utf8ToUtf16(cell.data(), cell.size(), out + 1, cap));
+        total += (size_t)out[0];
+        delete[] out;
+    }
+    return total;
+}
+
+template <typename F>
+double TimeMs(F&& f, int iters, size_t& sink) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) sink += f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iters = (argc > 1) ? std::atoi(argv[1]) : 50;
+    if (iters <= 0) iters = 50;
+
+    std::vector<Corpus> corpora;
+    corpora.push_back(MakeCorpus("ticker-8", 100000, 8, GenTicker));
+    corpora.push_back(MakeCorpus("isin-12", 100000, 12, GenTicker));
+    corpora.push_back(MakeCorpus("ascii-64", 20000, 64, GenTicker));
+    corpora.push_back(MakeCorpus("latin-32", 20000, 32, GenLatin));
+    corpora.push_back(MakeCorpus("cjk-16", 50000, 16, GenCjk));
+
+    size_t sink = 0;
+    std::printf("encode    %12s %12s %8s\n", "win32 MB/s", "kernel MB/s", "speedup");
+    for (const auto& c : corpora) {
+        double mb = (double)(c.units * sizeof(XCHAR)) * iters / (1024.0 * 1024.0);
+        double w = TimeMs([&] { return RunWin32(c); }, iters, sink);
+        double k = TimeMs([&] { return RunKernel(c); }, iters, sink);
+        std::printf("%-10s %12.1f %12.1f %7.2fx\n", c.name, mb / (w / 1000.0), mb / (k / 1000.0), w / k);
+    }
+
+    // Same corpora as UTF-8 input; throughput is quoted in input bytes.
+    std::printf("\ndecode    %12s %12s %8s\n", "win32 MB/s", "kernel MB/s", "speedup");
+    for (const auto& c : corpora) {
+        std::vector<std::string> cells;
+        size_t bytes = 0;
+        for (const auto& cell : c.cells) {
+            std::string s(Utf8MaxBytesForUtf16(cell.size()), 0);
+            s.resize(Utf16ToUtf8(cell.data(), cell.size(), &s[0]));
+            bytes += s.size();
+            cells.push_back(std::move(s));
+        }
+        double mb = (double)bytes * iters / (1024.0 * 1024.0);
+        double w = TimeMs([&] { return RunWin32Decode(cells); }, iters, sink);
+        double k = TimeMs([&] { return RunKernelDecode(cells); }, iters, sink);
+        std::printf("%-10s %12.1f %12.1f %7.2fx\n", c.name, mb / (w / 1000.0), mb / (k / 1000.0), w / k);
+    }
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
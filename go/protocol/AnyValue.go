@@ -20,6 +20,9 @@ const (
 	AnyValueRange       AnyValue = 10
 	AnyValueRefCache    AnyValue = 11
 	AnyValueDate        AnyValue = 12
+	AnyValueColumnGrid  AnyValue = 13
+	AnyValueNumGridEx   AnyValue = 14
+	AnyValueSparseGrid  AnyValue = 15
 )
 
 var EnumNamesAnyValue = map[AnyValue]string{
@@ -36,6 +39,9 @@ var EnumNamesAnyValue = map[AnyValue]string{
 	AnyValueRange:       "Range",
 	AnyValueRefCache:    "RefCache",
 	AnyValueDate:        "Date",
+	AnyValueColumnGrid:  "ColumnGrid",
+	AnyValueNumGridEx:   "NumGridEx",
+	AnyValueSparseGrid:  "SparseGrid",
 }
 
 var EnumValuesAnyValue = map[string]AnyValue{
@@ -52,6 +58,9 @@ var EnumValuesAnyValue = map[string]AnyValue{
 	"Range":       AnyValueRange,
 	"RefCache":    AnyValueRefCache,
 	"Date":        AnyValueDate,
+	"ColumnGrid":  AnyValueColumnGrid,
+	"NumGridEx":   AnyValueNumGridEx,
+	"SparseGrid":  AnyValueSparseGrid,
 }
 
 func (v AnyValue) String() string {
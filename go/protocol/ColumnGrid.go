@@ -0,0 +1,105 @@
+// Code generated by the FlatBuffers compiler. DO NOT EDIT.
+
+package protocol
+
+import (
+	flatbuffers "github.com/google/flatbuffers/go"
+)
+
+type ColumnGrid struct {
+	_tab flatbuffers.Table
+}
+
+func GetRootAsColumnGrid(buf []byte, offset flatbuffers.UOffsetT) *ColumnGrid {
+	n := flatbuffers.GetUOffsetT(buf[offset:])
+	x := &ColumnGrid{}
+	x.Init(buf, n+offset)
+	return x
+}
+
+func FinishColumnGridBuffer(builder *flatbuffers.Builder, offset flatbuffers.UOffsetT) {
+	builder.Finish(offset)
+}
+
+func GetSizePrefixedRootAsColumnGrid(buf []byte, offset flatbuffers.UOffsetT) *ColumnGrid {
+	n := flatbuffers.GetUOffsetT(buf[offset+flatbuffers.SizeUint32:])
+	x := &ColumnGrid{}
+	x.Init(buf, n+offset+flatbuffers.SizeUint32)
+	return x
+}
+
+func FinishSizePrefixedColumnGridBuffer(builder *flatbuffers.Builder, offset flatbuffers.UOffsetT) {
+	builder.FinishSizePrefixed(offset)
+}
+
+func (rcv *ColumnGrid) Init(buf []byte, i flatbuffers.UOffsetT) {
+	rcv._tab.Bytes = buf
+	rcv._tab.Pos = i
+}
+
+func (rcv *ColumnGrid) Table() flatbuffers.Table {
+	return rcv._tab
+}
+
+func (rcv *ColumnGrid) Rows() int32 {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(4))
+	if o != 0 {
+		return rcv._tab.GetInt32(o + rcv._tab.Pos)
+	}
+	return 0
+}
+
+func (rcv *ColumnGrid) MutateRows(n int32) bool {
+	return rcv._tab.MutateInt32Slot(4, n)
+}
+
+func (rcv *ColumnGrid) Cols() int32 {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(6))
+	if o != 0 {
+		return rcv._tab.GetInt32(o + rcv._tab.Pos)
+	}
+	return 0
+}
+
+func (rcv *ColumnGrid) MutateCols(n int32) bool {
+	return rcv._tab.MutateInt32Slot(6, n)
+}
+
+func (rcv *ColumnGrid) Columns(obj *Column, j int) bool {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(8))
+	if o != 0 {
+		x := rcv._tab.Vector(o)
+		x += flatbuffers.UOffsetT(j) * 4
+		x = rcv._tab.Indirect(x)
+		obj.Init(rcv._tab.Bytes, x)
+		return true
+	}
+	return false
+}
+
+func (rcv *ColumnGrid) ColumnsLength() int {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(8))
+	if o != 0 {
+		return rcv._tab.VectorLen(o)
+	}
+	return 0
+}
+
+func ColumnGridStart(builder *flatbuffers.Builder) {
+	builder.StartObject(3)
+}
+func ColumnGridAddRows(builder *flatbuffers.Builder, rows int32) {
+	builder.PrependInt32Slot(0, rows, 0)
+}
+func ColumnGridAddCols(builder *flatbuffers.Builder, cols int32) {
+	builder.PrependInt32Slot(1, cols, 0)
+}
+func ColumnGridAddColumns(builder *flatbuffers.Builder, columns flatbuffers.UOffsetT) {
+	builder.PrependUOffsetTSlot(2, flatbuffers.UOffsetT(columns), 0)
+}
+func ColumnGridStartColumnsVector(builder *flatbuffers.Builder, numElems int) flatbuffers.UOffsetT {
+	return builder.StartVector(4, numElems, 4)
+}
+func ColumnGridEnd(builder *flatbuffers.Builder) flatbuffers.UOffsetT {
+	return builder.EndObject()
+}
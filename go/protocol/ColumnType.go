@@ -0,0 +1,38 @@
+// Code generated by the FlatBuffers compiler. DO NOT EDIT.
+
+package protocol
+
+import "strconv"
+
+type ColumnType byte
+
+const (
+	ColumnTypeNum  ColumnType = 0
+	ColumnTypeInt  ColumnType = 1
+	ColumnTypeBool ColumnType = 2
+	ColumnTypeStr  ColumnType = 3
+	ColumnTypeErr  ColumnType = 4
+)
+
+var EnumNamesColumnType = map[ColumnType]string{
+	ColumnTypeNum:  "Num",
+	ColumnTypeInt:  "Int",
+	ColumnTypeBool: "Bool",
+	ColumnTypeStr:  "Str",
+	ColumnTypeErr:  "Err",
+}
+
+var EnumValuesColumnType = map[string]ColumnType{
+	"Num":  ColumnTypeNum,
+	"Int":  ColumnTypeInt,
+	"Bool": ColumnTypeBool,
+	"Str":  ColumnTypeStr,
+	"Err":  ColumnTypeErr,
+}
+
+func (v ColumnType) String() string {
+	if s, ok := EnumNamesColumnType[v]; ok {
+		return s
+	}
+	return "ColumnType(" + strconv.FormatInt(int64(v), 10) + ")"
+}
@@ -0,0 +1,137 @@
+// Code generated by the FlatBuffers compiler. DO NOT EDIT.
+
+package protocol
+
+import (
+	flatbuffers "github.com/google/flatbuffers/go"
+)
+
+type SparseGrid struct {
+	_tab flatbuffers.Table
+}
+
+func GetRootAsSparseGrid(buf []byte, offset flatbuffers.UOffsetT) *SparseGrid {
+	n := flatbuffers.GetUOffsetT(buf[offset:])
+	x := &SparseGrid{}
+	x.Init(buf, n+offset)
+	return x
+}
+
+func FinishSparseGridBuffer(builder *flatbuffers.Builder, offset flatbuffers.UOffsetT) {
+	builder.Finish(offset)
+}
+
+func GetSizePrefixedRootAsSparseGrid(buf []byte, offset flatbuffers.UOffsetT) *SparseGrid {
+	n := flatbuffers.GetUOffsetT(buf[offset+flatbuffers.SizeUint32:])
+	x := &SparseGrid{}
+	x.Init(buf, n+offset+flatbuffers.SizeUint32)
+	return x
+}
+
+func FinishSizePrefixedSparseGridBuffer(builder *flatbuffers.Builder, offset flatbuffers.UOffsetT) {
+	builder.FinishSizePrefixed(offset)
+}
+
+func (rcv *SparseGrid) Init(buf []byte, i flatbuffers.UOffsetT) {
+	rcv._tab.Bytes = buf
+	rcv._tab.Pos = i
+}
+
+func (rcv *SparseGrid) Table() flatbuffers.Table {
+	return rcv._tab
+}
+
+func (rcv *SparseGrid) Rows() int32 {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(4))
+	if o != 0 {
+		return rcv._tab.GetInt32(o + rcv._tab.Pos)
+	}
+	return 0
+}
+
+func (rcv *SparseGrid) MutateRows(n int32) bool {
+	return rcv._tab.MutateInt32Slot(4, n)
+}
+
+func (rcv *SparseGrid) Cols() int32 {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(6))
+	if o != 0 {
+		return rcv._tab.GetInt32(o + rcv._tab.Pos)
+	}
+	return 0
+}
+
+func (rcv *SparseGrid) MutateCols(n int32) bool {
+	return rcv._tab.MutateInt32Slot(6, n)
+}
+
+func (rcv *SparseGrid) Index(j int) uint32 {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(8))
+	if o != 0 {
+		a := rcv._tab.Vector(o)
+		return rcv._tab.GetUint32(a + flatbuffers.UOffsetT(j*4))
+	}
+	return 0
+}
+
+func (rcv *SparseGrid) IndexLength() int {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(8))
+	if o != 0 {
+		return rcv._tab.VectorLen(o)
+	}
+	return 0
+}
+
+func (rcv *SparseGrid) MutateIndex(j int, n uint32) bool {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(8))
+	if o != 0 {
+		a := rcv._tab.Vector(o)
+		return rcv._tab.MutateUint32(a+flatbuffers.UOffsetT(j*4), n)
+	}
+	return false
+}
+
+func (rcv *SparseGrid) Values(obj *Scalar, j int) bool {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(10))
+	if o != 0 {
+		x := rcv._tab.Vector(o)
+		x += flatbuffers.UOffsetT(j) * 4
+		x = rcv._tab.Indirect(x)
+		obj.Init(rcv._tab.Bytes, x)
+		return true
+	}
+	return false
+}
+
+func (rcv *SparseGrid) ValuesLength() int {
+	o := flatbuffers.UOffsetT(rcv._tab.Offset(10))
+	if o != 0 {
+		return rcv._tab.VectorLen(o)
+	}
+	return 0
+}
+
+func SparseGridStart(builder *flatbuffers.Builder) {
+	builder.StartObject(4)
+}
+func SparseGridAddRows(builder *flatbuffers.Builder, rows int32) {
+	builder.PrependInt32Slot(0, rows, 0)
+}
+func SparseGridAddCols(builder *flatbuffers.Builder, cols int32) {
+	builder.PrependInt32Slot(1, cols, 0)
+}
+func SparseGridAddIndex(builder *flatbuffers.Builder, index flatbuffers.UOffsetT) {
+	builder.PrependUOffsetTSlot(2, flatbuffers.UOffsetT(index), 0)
+}
+func SparseGridStartIndexVector(builder *flatbuffers.Builder, numElems int) flatbuffers.UOffsetT {
+	return builder.StartVector(4, numElems, 4)
+}
+func SparseGridAddValues(builder *flatbuffers.Builder, values flatbuffers.UOffsetT) {
+	builder.PrependUOffsetTSlot(3, flatbuffers.UOffsetT(values), 0)
+}
+func SparseGridStartValuesVector(builder *flatbuffers.Builder, numElems int) flatbuffers.UOffsetT {
+	return builder.StartVector(4, numElems, 4)
+}
+func SparseGridEnd(builder *flatbuffers.Builder) flatbuffers.UOffsetT {
+	return builder.EndObject()
+}
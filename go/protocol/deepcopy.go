@@ -249,6 +249,16 @@ func (rcv *NumGrid) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
 		return 0
 	}
 
+	// The fp12 image (zero-copy layout) is copied byte for byte, keeping its
+	// 8-byte alignment.
+	var fp12Off flatbuffers.UOffsetT
+	if n := rcv.Fp12Length(); n > 0 {
+		if uint64(n) > uint64(len(rcv._tab.Bytes)) {
+			return 0
+		}
+		fp12Off = createFP12Vector(b, rcv.Fp12Bytes())
+	}
+
 	NumGridStartDataVector(b, l)
 	for i := l - 1; i >= 0; i-- {
 		b.PrependFloat64(rcv.Data(i))
@@ -259,9 +269,295 @@ func (rcv *NumGrid) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
 	NumGridAddRows(b, rcv.Rows())
 	NumGridAddCols(b, rcv.Cols())
 	NumGridAddData(b, dataOff)
+	if fp12Off != 0 {
+		NumGridAddFp12(b, fp12Off)
+	}
 	return NumGridEnd(b)
 }
 
+// Clone creates a deep copy of the NumGridEx.
+func (rcv *NumGridEx) Clone() *NumGridEx {
+	if rcv == nil {
+		return nil
+	}
+	return cloneTable(rcv, GetRootAsNumGridEx)
+}
+
+// DeepCopy serializes the NumGridEx into the builder.
+func (rcv *NumGridEx) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
+	if rcv == nil {
+		return 0
+	}
+
+	l := rcv.DataLength()
+	n := rcv.ExcIndexLength()
+	m := rcv.ExcValuesLength()
+	if l < 0 || l > math.MaxInt32 || n < 0 || n > math.MaxInt32 || m < 0 || m > math.MaxInt32 {
+		return 0
+	}
+
+	// Security check: data is [double] (8 bytes per element), exc_index is
+	// [uint] and exc_values is [Scalar] (4 bytes per element each).
+	bufLen := uint64(len(rcv._tab.Bytes))
+	if uint64(l)*8 > bufLen || uint64(n)*4 > bufLen || uint64(m)*4 > bufLen {
+		return 0
+	}
+
+	// Exception Scalars first: nothing else may be built while a vector is
+	// open. Fail closed on an inaccessible element, as Grid.DeepCopy does.
+	valueOffsets := make([]flatbuffers.UOffsetT, m)
+	s := new(Scalar)
+	for i := 0; i < m; i++ {
+		if !rcv.ExcValues(s, i) {
+			return 0
+		}
+		valueOffsets[i] = s.DeepCopy(b)
+	}
+
+	NumGridExStartExcValuesVector(b, m)
+	for i := m - 1; i >= 0; i-- {
+		b.PrependUOffsetT(valueOffsets[i])
+	}
+	valuesOff := b.EndVector(m)
+
+	NumGridExStartExcIndexVector(b, n)
+	for i := n - 1; i >= 0; i-- {
+		b.PrependUint32(rcv.ExcIndex(i))
+	}
+	indexOff := b.EndVector(n)
+
+	NumGridExStartDataVector(b, l)
+	for i := l - 1; i >= 0; i-- {
+		b.PrependFloat64(rcv.Data(i))
+	}
+	dataOff := b.EndVector(l)
+
+	NumGridExStart(b)
+	NumGridExAddRows(b, rcv.Rows())
+	NumGridExAddCols(b, rcv.Cols())
+	NumGridExAddData(b, dataOff)
+	NumGridExAddExcIndex(b, indexOff)
+	NumGridExAddExcValues(b, valuesOff)
+	return NumGridExEnd(b)
+}
+
+// Clone creates a deep copy of the SparseGrid.
+func (rcv *SparseGrid) Clone() *SparseGrid {
+	if rcv == nil {
+		return nil
+	}
+	return cloneTable(rcv, GetRootAsSparseGrid)
+}
+
+// DeepCopy serializes the SparseGrid into the builder.
+func (rcv *SparseGrid) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
+	if rcv == nil {
+		return 0
+	}
+
+	n := rcv.IndexLength()
+	m := rcv.ValuesLength()
+	if n < 0 || n > math.MaxInt32 || m < 0 || m > math.MaxInt32 {
+		return 0
+	}
+
+	// Security check: index is [uint] and values is [Scalar], 4 bytes per
+	// element each.
+	bufLen := uint64(len(rcv._tab.Bytes))
+	if uint64(n)*4 > bufLen || uint64(m)*4 > bufLen {
+		return 0
+	}
+
+	// Fail closed on an inaccessible element, as Grid.DeepCopy does.
+	valueOffsets := make([]flatbuffers.UOffsetT, m)
+	s := new(Scalar)
+	for i := 0; i < m; i++ {
+		if !rcv.Values(s, i) {
+			return 0
+		}
+		valueOffsets[i] = s.DeepCopy(b)
+	}
+
+	SparseGridStartValuesVector(b, m)
+	for i := m - 1; i >= 0; i-- {
+		b.PrependUOffsetT(valueOffsets[i])
+	}
+	valuesOff := b.EndVector(m)
+
+	SparseGridStartIndexVector(b, n)
+	for i := n - 1; i >= 0; i-- {
+		b.PrependUint32(rcv.Index(i))
+	}
+	indexOff := b.EndVector(n)
+
+	SparseGridStart(b)
+	SparseGridAddRows(b, rcv.Rows())
+	SparseGridAddCols(b, rcv.Cols())
+	SparseGridAddIndex(b, indexOff)
+	SparseGridAddValues(b, valuesOff)
+	return SparseGridEnd(b)
+}
+
+// Clone creates a deep copy of the Column.
+func (rcv *Column) Clone() *Column {
+	if rcv == nil {
+		return nil
+	}
+	return cloneTable(rcv, GetRootAsColumn)
+}
+
+// DeepCopy serializes the Column into the builder. Every present typed vector
+// is copied, not just the one selected by Type, so the copy is byte-for-byte
+// equivalent to the source.
+func (rcv *Column) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
+	if rcv == nil {
+		return 0
+	}
+
+	nullsLen := rcv.NullsLength()
+	numsLen := rcv.NumsLength()
+	intsLen := rcv.IntsLength()
+	boolsLen := rcv.BoolsLength()
+	strsLen := rcv.StrsLength()
+	errsLen := rcv.ErrsLength()
+
+	// Security check: ensure the buffer is large enough for every claimed
+	// vector length (element widths: nulls/bools 1, nums 8, ints 4, strs 4
+	// (offsets), errs 2). Same loose lower bound as Grid/NumGrid.
+	bufLen := uint64(len(rcv._tab.Bytes))
+	if uint64(nullsLen) > bufLen || uint64(numsLen)*8 > bufLen ||
+		uint64(intsLen)*4 > bufLen || uint64(boolsLen) > bufLen ||
+		uint64(strsLen)*4 > bufLen || uint64(errsLen)*2 > bufLen {
+		return 0
+	}
+
+	// Strings first (they cannot be created while a vector is open). Fail
+	// closed on an inaccessible element, as RtdConnectRequest.Strings does.
+	var strsOffsets []flatbuffers.UOffsetT
+	if strsLen > 0 {
+		strsOffsets = make([]flatbuffers.UOffsetT, strsLen)
+		for i := 0; i < strsLen; i++ {
+			str := rcv.Strs(i)
+			if str == nil {
+				return 0
+			}
+			strsOffsets[i] = b.CreateByteString(str)
+		}
+	}
+
+	var nullsOff, numsOff, intsOff, boolsOff, strsOff, errsOff flatbuffers.UOffsetT
+	if nulls := rcv.NullsBytes(); nulls != nil {
+		nullsOff = b.CreateByteVector(nulls)
+	}
+	if numsLen > 0 {
+		ColumnStartNumsVector(b, numsLen)
+		for i := numsLen - 1; i >= 0; i-- {
+			b.PrependFloat64(rcv.Nums(i))
+		}
+		numsOff = b.EndVector(numsLen)
+	}
+	if intsLen > 0 {
+		ColumnStartIntsVector(b, intsLen)
+		for i := intsLen - 1; i >= 0; i-- {
+			b.PrependInt32(rcv.Ints(i))
+		}
+		intsOff = b.EndVector(intsLen)
+	}
+	if boolsLen > 0 {
+		ColumnStartBoolsVector(b, boolsLen)
+		for i := boolsLen - 1; i >= 0; i-- {
+			b.PrependBool(rcv.Bools(i))
+		}
+		boolsOff = b.EndVector(boolsLen)
+	}
+	if strsLen > 0 {
+		ColumnStartStrsVector(b, strsLen)
+		for i := strsLen - 1; i >= 0; i-- {
+			b.PrependUOffsetT(strsOffsets[i])
+		}
+		strsOff = b.EndVector(strsLen)
+	}
+	if errsLen > 0 {
+		ColumnStartErrsVector(b, errsLen)
+		for i := errsLen - 1; i >= 0; i-- {
+			b.PrependInt16(int16(rcv.Errs(i)))
+		}
+		errsOff = b.EndVector(errsLen)
+	}
+
+	ColumnStart(b)
+	ColumnAddType(b, rcv.Type())
+	if nullsOff != 0 {
+		ColumnAddNulls(b, nullsOff)
+	}
+	if numsOff != 0 {
+		ColumnAddNums(b, numsOff)
+	}
+	if intsOff != 0 {
+		ColumnAddInts(b, intsOff)
+	}
+	if boolsOff != 0 {
+		ColumnAddBools(b, boolsOff)
+	}
+	if strsOff != 0 {
+		ColumnAddStrs(b, strsOff)
+	}
+	if errsOff != 0 {
+		ColumnAddErrs(b, errsOff)
+	}
+	return ColumnEnd(b)
+}
+
+// Clone creates a deep copy of the ColumnGrid.
+func (rcv *ColumnGrid) Clone() *ColumnGrid {
+	if rcv == nil {
+		return nil
+	}
+	return cloneTable(rcv, GetRootAsColumnGrid)
+}
+
+// DeepCopy serializes the ColumnGrid into the builder.
+func (rcv *ColumnGrid) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
+	if rcv == nil {
+		return 0
+	}
+
+	l := rcv.ColumnsLength()
+	if l < 0 || l > math.MaxInt32 {
+		return 0
+	}
+
+	// Security check: ColumnGrid.Columns is [Column], a vector of 4-byte offsets.
+	if uint64(l)*4 > uint64(len(rcv._tab.Bytes)) {
+		return 0
+	}
+
+	offsets := make([]flatbuffers.UOffsetT, l)
+	c := new(Column)
+	for i := 0; i < l; i++ {
+		if !rcv.Columns(c, i) {
+			// Fail closed, as Grid.DeepCopy does for its Scalar elements.
+			return 0
+		}
+		offsets[i] = c.DeepCopy(b)
+		if offsets[i] == 0 {
+			return 0
+		}
+	}
+
+	ColumnGridStartColumnsVector(b, l)
+	for i := l - 1; i >= 0; i-- {
+		b.PrependUOffsetT(offsets[i])
+	}
+	columnsOff := b.EndVector(l)
+
+	ColumnGridStart(b)
+	ColumnGridAddRows(b, rcv.Rows())
+	ColumnGridAddCols(b, rcv.Cols())
+	ColumnGridAddColumns(b, columnsOff)
+	return ColumnGridEnd(b)
+}
+
 // Clone creates a deep copy of the Range.
 func (rcv *Range) Clone() *Range {
 	if rcv == nil {
@@ -314,6 +610,30 @@ func (rcv *Range) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
 		}
 	}
 
+	// Values: one Any per area, copied before the refs vector is opened. A
+	// nested Range (never produced; it would let a crafted message recurse)
+	// fails closed like an inaccessible element.
+	m := rcv.ValuesLength()
+	if m < 0 || m > math.MaxInt32 || uint64(m)*4 > uint64(len(rcv._tab.Bytes)) {
+		return 0
+	}
+	var valuesOff flatbuffers.UOffsetT
+	if m > 0 {
+		valueOffsets := make([]flatbuffers.UOffsetT, m)
+		a := new(Any)
+		for i := 0; i < m; i++ {
+			if !rcv.Values(a, i) || a.ValType() == AnyValueRange {
+				return 0
+			}
+			valueOffsets[i] = a.DeepCopy(b)
+		}
+		RangeStartValuesVector(b, m)
+		for i := m - 1; i >= 0; i-- {
+			b.PrependUOffsetT(valueOffsets[i])
+		}
+		valuesOff = b.EndVector(m)
+	}
+
 	RangeStartRefsVector(b, l)
 	for i := l - 1; i >= 0; i-- {
 		rcv.Refs(r, i)
@@ -329,6 +649,9 @@ func (rcv *Range) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
 	if formatOff != 0 {
 		RangeAddFormat(b, formatOff)
 	}
+	if valuesOff != 0 {
+		RangeAddValues(b, valuesOff)
+	}
 	return RangeEnd(b)
 }
 
@@ -410,6 +733,21 @@ func (rcv *Any) DeepCopy(b *flatbuffers.Builder) flatbuffers.UOffsetT {
 		if rcv.Val(&t._tab) {
 			valOffset = t.DeepCopy(b)
 		}
+	case AnyValueColumnGrid:
+		t := new(ColumnGrid)
+		if rcv.Val(&t._tab) {
+			valOffset = t.DeepCopy(b)
+		}
+	case AnyValueNumGridEx:
+		t := new(NumGridEx)
+		if rcv.Val(&t._tab) {
+			valOffset = t.DeepCopy(b)
+		}
+	case AnyValueSparseGrid:
+		t := new(SparseGrid)
+		if rcv.Val(&t._tab) {
+			valOffset = t.DeepCopy(b)
+		}
 	}
 
 	AnyStart(b)
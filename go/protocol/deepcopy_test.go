@@ -170,6 +170,32 @@ func TestRange_Clone(t *testing.T) {
 	}
 }
 
+func TestRange_Clone_Values(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildRangeWithValues(b, 2, 2, 1, false))
+
+	clone := GetRootAsRange(b.FinishedBytes(), 0).Clone()
+	if clone == nil || clone.ValuesLength() != 2 || clone.RefsLength() != 2 {
+		t.Fatalf("expected 2 refs and 2 values, got %v", clone)
+	}
+	var a Any
+	var ng NumGrid
+	if !clone.Values(&a, 1) || a.ValType() != AnyValueNumGrid || !a.Val(&ng._tab) {
+		t.Fatal("Failed to get value 1")
+	}
+	if ng.Data(0) != 1 {
+		t.Errorf("expected 1, got %v", ng.Data(0))
+	}
+
+	// A nested Range value fails closed.
+	b.Reset()
+	b.Finish(buildRangeWithValues(b, 1, 0, 1, true))
+	if off := GetRootAsRange(b.FinishedBytes(), 0).DeepCopy(flatbuffers.NewBuilder(0)); off != 0 {
+		t.Errorf("expected DeepCopy to fail closed, got offset %d", off)
+	}
+}
+
 // TestRange_Clone_MultiRef guards the Range.DeepCopy inline-struct vector
 // build: pre-validation followed by a reverse-order prepend must preserve the
 // original Rect order across the clone. A single-ref test cannot catch an
@@ -351,3 +377,259 @@ func TestAsyncHandle_DeepCopy(t *testing.T) {
 		t.Errorf("Expected bytes %v, got %v", payload, gotBytes)
 	}
 }
+
+// buildColumnGrid builds an Any{ColumnGrid} with a 3-row Str column (middle
+// row null) and a 3-row Num column. numRows overrides the Num column length
+// so tests can build a malformed grid.
+func buildColumnGrid(b *flatbuffers.Builder, numRows int) flatbuffers.UOffsetT {
+	a := b.CreateString("a")
+	empty := b.CreateString("")
+	c := b.CreateString("c")
+	ColumnStartStrsVector(b, 3)
+	b.PrependUOffsetT(c)
+	b.PrependUOffsetT(empty)
+	b.PrependUOffsetT(a)
+	strs := b.EndVector(3)
+	nulls := b.CreateByteVector([]byte{0x02})
+	ColumnStart(b)
+	ColumnAddType(b, ColumnTypeStr)
+	ColumnAddNulls(b, nulls)
+	ColumnAddStrs(b, strs)
+	col0 := ColumnEnd(b)
+
+	ColumnStartNumsVector(b, numRows)
+	for i := numRows - 1; i >= 0; i-- {
+		b.PrependFloat64(float64(i) + 0.5)
+	}
+	nums := b.EndVector(numRows)
+	ColumnStart(b)
+	ColumnAddType(b, ColumnTypeNum)
+	ColumnAddNums(b, nums)
+	col1 := ColumnEnd(b)
+
+	ColumnGridStartColumnsVector(b, 2)
+	b.PrependUOffsetT(col1)
+	b.PrependUOffsetT(col0)
+	cols := b.EndVector(2)
+	ColumnGridStart(b)
+	ColumnGridAddRows(b, 3)
+	ColumnGridAddCols(b, 2)
+	ColumnGridAddColumns(b, cols)
+	cg := ColumnGridEnd(b)
+
+	AnyStart(b)
+	AnyAddValType(b, AnyValueColumnGrid)
+	AnyAddVal(b, cg)
+	return AnyEnd(b)
+}
+
+func TestAny_Clone_ColumnGrid(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildColumnGrid(b, 3))
+
+	orig := GetRootAsAny(b.FinishedBytes(), 0)
+	clone := orig.Clone()
+
+	if clone.ValType() != AnyValueColumnGrid {
+		t.Fatalf("Expected AnyValueColumnGrid, got %v", clone.ValType())
+	}
+	var cg ColumnGrid
+	if !clone.Val(&cg._tab) {
+		t.Fatal("Failed to get ColumnGrid from clone")
+	}
+	if cg.Rows() != 3 || cg.Cols() != 2 || cg.ColumnsLength() != 2 {
+		t.Fatalf("Expected 3x2 with 2 columns, got %dx%d with %d", cg.Rows(), cg.Cols(), cg.ColumnsLength())
+	}
+	var c Column
+	cg.Columns(&c, 0)
+	if c.Type() != ColumnTypeStr || c.StrsLength() != 3 || string(c.Strs(2)) != "c" {
+		t.Errorf("Str column mismatch: type %v, len %d", c.Type(), c.StrsLength())
+	}
+	if !bytes.Equal(c.NullsBytes(), []byte{0x02}) {
+		t.Errorf("Null bitmap mismatch: %v", c.NullsBytes())
+	}
+	cg.Columns(&c, 1)
+	if c.Type() != ColumnTypeNum || c.NumsLength() != 3 || c.Nums(1) != 1.5 {
+		t.Errorf("Num column mismatch: type %v, len %d", c.Type(), c.NumsLength())
+	}
+	if c.NullsBytes() != nil {
+		t.Error("Expected no null bitmap on the Num column")
+	}
+}
+
+// buildNumGridEx builds an Any{NumGridEx}: a 2x2 grid of numbers with cell 1
+// replaced by #N/A. excIndex overrides that exception's index so tests can
+// build a malformed table.
+func buildNumGridEx(b *flatbuffers.Builder, excIndex uint32) flatbuffers.UOffsetT {
+	ErrStart(b)
+	ErrAddVal(b, XlErrorNA)
+	errOff := ErrEnd(b)
+	ScalarStart(b)
+	ScalarAddValType(b, ScalarValueErr)
+	ScalarAddVal(b, errOff)
+	exc := ScalarEnd(b)
+
+	NumGridExStartExcValuesVector(b, 1)
+	b.PrependUOffsetT(exc)
+	values := b.EndVector(1)
+	NumGridExStartExcIndexVector(b, 1)
+	b.PrependUint32(excIndex)
+	index := b.EndVector(1)
+	NumGridExStartDataVector(b, 4)
+	b.PrependFloat64(4)
+	b.PrependFloat64(3)
+	b.PrependFloat64(0)
+	b.PrependFloat64(1)
+	data := b.EndVector(4)
+
+	NumGridExStart(b)
+	NumGridExAddRows(b, 2)
+	NumGridExAddCols(b, 2)
+	NumGridExAddData(b, data)
+	NumGridExAddExcIndex(b, index)
+	NumGridExAddExcValues(b, values)
+	ng := NumGridExEnd(b)
+
+	AnyStart(b)
+	AnyAddValType(b, AnyValueNumGridEx)
+	AnyAddVal(b, ng)
+	return AnyEnd(b)
+}
+
+func TestAny_Clone_NumGridEx(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildNumGridEx(b, 1))
+
+	clone := GetRootAsAny(b.FinishedBytes(), 0).Clone()
+	if clone.ValType() != AnyValueNumGridEx {
+		t.Fatalf("Expected AnyValueNumGridEx, got %v", clone.ValType())
+	}
+	var ng NumGridEx
+	if !clone.Val(&ng._tab) {
+		t.Fatal("Failed to get NumGridEx from clone")
+	}
+	if ng.DataLength() != 4 || ng.Data(3) != 4 {
+		t.Errorf("Data mismatch: len %d", ng.DataLength())
+	}
+	if ng.ExcIndexLength() != 1 || ng.ExcIndex(0) != 1 {
+		t.Fatalf("Exception index mismatch: len %d", ng.ExcIndexLength())
+	}
+	var s Scalar
+	if !ng.ExcValues(&s, 0) || s.ValType() != ScalarValueErr {
+		t.Fatal("Expected an Err exception value")
+	}
+	var e Err
+	s.Val(&e._tab)
+	if e.Val() != XlErrorNA {
+		t.Errorf("Expected #N/A, got %v", e.Val())
+	}
+}
+
+// buildSparseGrid builds an Any{SparseGrid}: a 1000x26 grid holding Int 7 at
+// cell idx0 and Int 9 at cell idx1.
+func buildSparseGrid(b *flatbuffers.Builder, idx0, idx1 uint32) flatbuffers.UOffsetT {
+	mk := func(v int32) flatbuffers.UOffsetT {
+		IntStart(b)
+		IntAddVal(b, v)
+		off := IntEnd(b)
+		ScalarStart(b)
+		ScalarAddValType(b, ScalarValueInt)
+		ScalarAddVal(b, off)
+		return ScalarEnd(b)
+	}
+	v0, v1 := mk(7), mk(9)
+	SparseGridStartValuesVector(b, 2)
+	b.PrependUOffsetT(v1)
+	b.PrependUOffsetT(v0)
+	values := b.EndVector(2)
+	SparseGridStartIndexVector(b, 2)
+	b.PrependUint32(idx1)
+	b.PrependUint32(idx0)
+	index := b.EndVector(2)
+
+	SparseGridStart(b)
+	SparseGridAddRows(b, 1000)
+	SparseGridAddCols(b, 26)
+	SparseGridAddIndex(b, index)
+	SparseGridAddValues(b, values)
+	sg := SparseGridEnd(b)
+
+	AnyStart(b)
+	AnyAddValType(b, AnyValueSparseGrid)
+	AnyAddVal(b, sg)
+	return AnyEnd(b)
+}
+
+func TestAny_Clone_SparseGrid(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildSparseGrid(b, 5, 25999))
+
+	clone := GetRootAsAny(b.FinishedBytes(), 0).Clone()
+	if clone.ValType() != AnyValueSparseGrid {
+		t.Fatalf("Expected AnyValueSparseGrid, got %v", clone.ValType())
+	}
+	var sg SparseGrid
+	if !clone.Val(&sg._tab) {
+		t.Fatal("Failed to get SparseGrid from clone")
+	}
+	if sg.Rows() != 1000 || sg.Cols() != 26 {
+		t.Errorf("Dimension mismatch: %dx%d", sg.Rows(), sg.Cols())
+	}
+	if sg.IndexLength() != 2 || sg.Index(1) != 25999 {
+		t.Fatalf("Index mismatch: len %d", sg.IndexLength())
+	}
+	var s Scalar
+	var iv Int
+	if !sg.Values(&s, 1) || !s.Val(&iv._tab) || iv.Val() != 9 {
+		t.Error("Expected Int 9 at the second populated cell")
+	}
+}
+
+// buildRangeWithValues builds a Range of `refs` one-cell rects whose values
+// are 1x1 NumGrids holding `dataLen` doubles each; nested adds a Range value.
+func buildRangeWithValues(b *flatbuffers.Builder, refs, values, dataLen int, nested bool) flatbuffers.UOffsetT {
+	offs := make([]flatbuffers.UOffsetT, 0, values+1)
+	for i := 0; i < values; i++ {
+		NumGridStartDataVector(b, dataLen)
+		for j := 0; j < dataLen; j++ {
+			b.PrependFloat64(float64(i))
+		}
+		data := b.EndVector(dataLen)
+		NumGridStart(b)
+		NumGridAddRows(b, 1)
+		NumGridAddCols(b, 1)
+		NumGridAddData(b, data)
+		ng := NumGridEnd(b)
+		AnyStart(b)
+		AnyAddValType(b, AnyValueNumGrid)
+		AnyAddVal(b, ng)
+		offs = append(offs, AnyEnd(b))
+	}
+	if nested {
+		RangeStart(b)
+		inner := RangeEnd(b)
+		AnyStart(b)
+		AnyAddValType(b, AnyValueRange)
+		AnyAddVal(b, inner)
+		offs = append(offs, AnyEnd(b))
+	}
+	RangeStartValuesVector(b, len(offs))
+	for i := len(offs) - 1; i >= 0; i-- {
+		b.PrependUOffsetT(offs[i])
+	}
+	vals := b.EndVector(len(offs))
+
+	RangeStartRefsVector(b, refs)
+	for i := refs - 1; i >= 0; i-- {
+		CreateRect(b, int32(i), int32(i), 0, 0)
+	}
+	rects := b.EndVector(refs)
+
+	RangeStart(b)
+	RangeAddRefs(b, rects)
+	RangeAddValues(b, vals)
+	return RangeEnd(b)
+}
@@ -1,9 +1,12 @@
 package protocol
 
 import (
+	"encoding/binary"
 	"errors"
 	"fmt"
 	"math"
+
+	flatbuffers "github.com/google/flatbuffers/go"
 )
 
 var (
@@ -13,6 +16,19 @@ var (
 	ErrOverflow = errors.New("dimensions exceed maximum supported limits (int32)")
 	// ErrTooManyRefs indicates that the range has too many references.
 	ErrTooManyRefs = errors.New("too many references (> 65535)")
+	// ErrInvalidColumn indicates that a ColumnGrid column does not hold one
+	// typed value (and, if present, one null bit) per row.
+	ErrInvalidColumn = errors.New("column vector length does not match rows")
+	// ErrInvalidExceptions indicates that a NumGridEx exception table or a
+	// SparseGrid cell table is malformed (length mismatch, out-of-range or
+	// unsorted index).
+	ErrInvalidExceptions = errors.New("invalid exception table")
+	// ErrInvalidFP12 indicates that a NumGrid fp12 image is not an FP12 of
+	// rows x cols doubles, or that the grid also carries a data vector.
+	ErrInvalidFP12 = errors.New("invalid fp12 image")
+	// ErrInvalidRangeValues indicates that a Range's values do not match its
+	// refs one to one, or that a value is itself a Range or malformed.
+	ErrInvalidRangeValues = errors.New("invalid range values")
 )
 
 // validateDims checks that rows*cols is non-negative, fits in int32
@@ -40,15 +56,171 @@ func (rcv *Grid) Validate() error {
 	return validateDims(rcv.Rows(), rcv.Cols(), rcv.DataLength())
 }
 
-// Validate checks if the NumGrid dimensions match the data length.
+// Validate checks if the NumGrid dimensions match the data length. For the
+// fp12 layout it checks the image instead: no data vector, a header matching
+// rows and cols, and exactly rows*cols doubles after it.
 func (rcv *NumGrid) Validate() error {
-	return validateDims(rcv.Rows(), rcv.Cols(), rcv.DataLength())
+	image := rcv.Fp12Bytes()
+	if image == nil {
+		return validateDims(rcv.Rows(), rcv.Cols(), rcv.DataLength())
+	}
+	rows, cols := rcv.Rows(), rcv.Cols()
+	if rcv.DataLength() != 0 {
+		return fmt.Errorf("%w: both data and fp12 are set", ErrInvalidFP12)
+	}
+	if len(image) < fp12HeaderSize || (len(image)-fp12HeaderSize)%8 != 0 {
+		return fmt.Errorf("%w: %d bytes", ErrInvalidFP12, len(image))
+	}
+	if err := validateDims(rows, cols, (len(image)-fp12HeaderSize)/8); err != nil {
+		return err
+	}
+	hdrRows := int32(binary.LittleEndian.Uint32(image[0:]))
+	hdrCols := int32(binary.LittleEndian.Uint32(image[4:]))
+	if hdrRows != rows || hdrCols != cols {
+		return fmt.Errorf("%w: header %d x %d, grid %d x %d", ErrInvalidFP12, hdrRows, hdrCols, rows, cols)
+	}
+	return nil
+}
+
+// Validate checks the NumGridEx dimensions against the data length, and that
+// every exception index is in range and strictly increasing with one value
+// per index.
+func (rcv *NumGridEx) Validate() error {
+	if err := validateDims(rcv.Rows(), rcv.Cols(), rcv.DataLength()); err != nil {
+		return err
+	}
+	return validateCellIndex(uint64(rcv.DataLength()), rcv.ExcIndexLength(), rcv.ExcValuesLength(), rcv.ExcIndex)
+}
+
+// Validate checks the SparseGrid dimensions, and that every cell index is in
+// range and strictly increasing with one value per index.
+func (rcv *SparseGrid) Validate() error {
+	rows, cols := rcv.Rows(), rcv.Cols()
+	if err := validateDims(rows, cols, int(rows)*int(cols)); err != nil {
+		return err
+	}
+	return validateCellIndex(uint64(rows)*uint64(cols), rcv.IndexLength(), rcv.ValuesLength(), rcv.Index)
 }
 
-// Validate checks if the Range has valid references.
+// validateCellIndex checks an (index, value) cell table over `count` cells:
+// as many values as indices, each index < count and strictly increasing.
+// Shared by NumGridEx.Validate and SparseGrid.Validate.
+func validateCellIndex(count uint64, n, values int, index func(int) uint32) error {
+	if n != values {
+		return fmt.Errorf("%w: %d indices, %d values", ErrInvalidExceptions, n, values)
+	}
+	for i := 0; i < n; i++ {
+		idx := index(i)
+		if uint64(idx) >= count || (i > 0 && idx <= index(i-1)) {
+			return fmt.Errorf("%w: index %d at position %d", ErrInvalidExceptions, idx, i)
+		}
+	}
+	return nil
+}
+
+// columnTypedLength returns the length of the typed vector selected by the
+// column's Type, or -1 for an unknown type.
+func columnTypedLength(c *Column) int {
+	switch c.Type() {
+	case ColumnTypeNum:
+		return c.NumsLength()
+	case ColumnTypeInt:
+		return c.IntsLength()
+	case ColumnTypeBool:
+		return c.BoolsLength()
+	case ColumnTypeStr:
+		return c.StrsLength()
+	case ColumnTypeErr:
+		return c.ErrsLength()
+	}
+	return -1
+}
+
+// Validate checks that the ColumnGrid has one column per col, and that each
+// column's typed vector holds one value per row with a null bitmap (if any)
+// covering every row.
+func (rcv *ColumnGrid) Validate() error {
+	rows, cols := rcv.Rows(), rcv.Cols()
+	if rcv.ColumnsLength() != int(cols) {
+		return fmt.Errorf("%w: expected %d columns, got %d", ErrInvalidDimensions, cols, rcv.ColumnsLength())
+	}
+	// The cell count is rows * len(columns); with the check above this only
+	// rejects negative dimensions and an int32 overflow of the total.
+	if err := validateDims(rows, cols, int(rows)*int(cols)); err != nil {
+		return err
+	}
+	c := new(Column)
+	for i := 0; i < int(cols); i++ {
+		if !rcv.Columns(c, i) {
+			return fmt.Errorf("%w: column %d unreadable", ErrInvalidColumn, i)
+		}
+		if n := columnTypedLength(c); n != int(rows) {
+			return fmt.Errorf("%w: column %d (%s) has %d values, want %d", ErrInvalidColumn, i, c.Type(), n, rows)
+		}
+		if n := c.NullsLength(); n != 0 && n < (int(rows)+7)/8 {
+			return fmt.Errorf("%w: column %d null bitmap has %d bytes, want %d", ErrInvalidColumn, i, n, (int(rows)+7)/8)
+		}
+	}
+	return nil
+}
+
+// Validate checks if the Range has valid references and, when present, one
+// well-formed value per reference.
 func (rcv *Range) Validate() error {
 	if rcv.RefsLength() > 65535 {
 		return fmt.Errorf("%w: got %d", ErrTooManyRefs, rcv.RefsLength())
 	}
+	n := rcv.ValuesLength()
+	if n == 0 {
+		return nil
+	}
+	if n != rcv.RefsLength() {
+		return fmt.Errorf("%w: %d values for %d refs", ErrInvalidRangeValues, n, rcv.RefsLength())
+	}
+	a := new(Any)
+	for i := 0; i < n; i++ {
+		if !rcv.Values(a, i) {
+			return fmt.Errorf("%w: value %d unreadable", ErrInvalidRangeValues, i)
+		}
+		if err := validateAreaValue(a); err != nil {
+			return fmt.Errorf("%w: value %d: %v", ErrInvalidRangeValues, i, err)
+		}
+	}
+	return nil
+}
+
+// validateAreaValue checks one Range value: a scalar or a grid in any
+// encoding, never a nested Range or RefCache.
+func validateAreaValue(a *Any) error {
+	var t flatbuffers.Table
+	switch a.ValType() {
+	case AnyValueRange, AnyValueRefCache:
+		return fmt.Errorf("%s is not a cell value", a.ValType())
+	case AnyValueGrid:
+		if a.Val(&t) {
+			g := &Grid{_tab: t}
+			return g.Validate()
+		}
+	case AnyValueNumGrid:
+		if a.Val(&t) {
+			g := &NumGrid{_tab: t}
+			return g.Validate()
+		}
+	case AnyValueColumnGrid:
+		if a.Val(&t) {
+			g := &ColumnGrid{_tab: t}
+			return g.Validate()
+		}
+	case AnyValueNumGridEx:
+		if a.Val(&t) {
+			g := &NumGridEx{_tab: t}
+			return g.Validate()
+		}
+	case AnyValueSparseGrid:
+		if a.Val(&t) {
+			g := &SparseGrid{_tab: t}
+			return g.Validate()
+		}
+	}
 	return nil
 }
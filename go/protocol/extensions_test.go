@@ -1,6 +1,7 @@
 package protocol
 
 import (
+	"errors"
 	flatbuffers "github.com/google/flatbuffers/go"
 	"testing"
 )
@@ -72,3 +73,151 @@ func TestGrid_Validate(t *testing.T) {
 		t.Error("expected error for invalid grid, got nil")
 	}
 }
+
+func TestColumnGrid_Validate(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildColumnGrid(b, 3))
+
+	var cg ColumnGrid
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&cg._tab) {
+		t.Fatal("Failed to get ColumnGrid")
+	}
+	if err := cg.Validate(); err != nil {
+		t.Errorf("expected valid column grid, got error: %v", err)
+	}
+
+	// Num column one value short of rows.
+	b.Reset()
+	b.Finish(buildColumnGrid(b, 2))
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&cg._tab) {
+		t.Fatal("Failed to get ColumnGrid")
+	}
+	if err := cg.Validate(); !errors.Is(err, ErrInvalidColumn) {
+		t.Errorf("expected ErrInvalidColumn, got %v", err)
+	}
+}
+
+func TestNumGridEx_Validate(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildNumGridEx(b, 1))
+
+	var ng NumGridEx
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&ng._tab) {
+		t.Fatal("Failed to get NumGridEx")
+	}
+	if err := ng.Validate(); err != nil {
+		t.Errorf("expected valid grid, got error: %v", err)
+	}
+
+	// Exception index past the last cell.
+	b.Reset()
+	b.Finish(buildNumGridEx(b, 4))
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&ng._tab) {
+		t.Fatal("Failed to get NumGridEx")
+	}
+	if err := ng.Validate(); !errors.Is(err, ErrInvalidExceptions) {
+		t.Errorf("expected ErrInvalidExceptions, got %v", err)
+	}
+}
+
+func TestSparseGrid_Validate(t *testing.T) {
+	t.Parallel()
+	b := flatbuffers.NewBuilder(0)
+	b.Finish(buildSparseGrid(b, 5, 25999))
+
+	var sg SparseGrid
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&sg._tab) {
+		t.Fatal("Failed to get SparseGrid")
+	}
+	if err := sg.Validate(); err != nil {
+		t.Errorf("expected valid grid, got error: %v", err)
+	}
+
+	// Indices out of order.
+	b.Reset()
+	b.Finish(buildSparseGrid(b, 9, 5))
+	if !GetRootAsAny(b.FinishedBytes(), 0).Val(&sg._tab) {
+		t.Fatal("Failed to get SparseGrid")
+	}
+	if err := sg.Validate(); !errors.Is(err, ErrInvalidExceptions) {
+		t.Errorf("expected ErrInvalidExceptions, got %v", err)
+	}
+}
+
+func TestNumGrid_FP12Layout(t *testing.T) {
+	t.Parallel()
+	data := []float64{1.5, -2, 3.25, 4, 5, 6}
+	b := flatbuffers.NewBuilder(0)
+	ng := BuildNumGridFP12(b, 2, 3, data)
+	AnyStart(b)
+	AnyAddValType(b, AnyValueNumGrid)
+	AnyAddVal(b, ng)
+	b.Finish(AnyEnd(b))
+
+	root := GetRootAsAny(b.FinishedBytes(), 0)
+	var grid NumGrid
+	if !root.Val(&grid._tab) {
+		t.Fatal("Failed to get NumGrid")
+	}
+	if err := grid.Validate(); err != nil {
+		t.Fatalf("expected valid fp12 grid, got error: %v", err)
+	}
+	if grid.DataLength() != 0 || grid.Fp12Length() != fp12HeaderSize+8*len(data) {
+		t.Fatalf("unexpected layout: data %d, fp12 %d", grid.DataLength(), grid.Fp12Length())
+	}
+	// The image body must be 8-byte aligned within the finished buffer.
+	vec := grid._tab.Vector(flatbuffers.UOffsetT(grid._tab.Offset(10)))
+	if vec%8 != 0 {
+		t.Errorf("fp12 image at offset %d is not 8-byte aligned", vec)
+	}
+	for i, want := range data {
+		if got := grid.Value(i); got != want {
+			t.Errorf("Value(%d) = %v, want %v", i, got, want)
+		}
+	}
+
+	// Clone keeps the layout.
+	clone := root.Clone()
+	var cloned NumGrid
+	if !clone.Val(&cloned._tab) || cloned.Validate() != nil || cloned.Value(5) != 6 {
+		t.Error("Clone lost the fp12 image")
+	}
+
+	// A header that disagrees with the table is rejected.
+	grid.MutateFp12(0, 3)
+	if err := grid.Validate(); !errors.Is(err, ErrInvalidFP12) {
+		t.Errorf("expected ErrInvalidFP12, got %v", err)
+	}
+
+	if BuildNumGridFP12(flatbuffers.NewBuilder(0), 2, 2, data) != 0 {
+		t.Error("expected 0 for a size mismatch")
+	}
+}
+
+func TestRange_ValidateValues(t *testing.T) {
+	t.Parallel()
+	cases := []struct {
+		name                  string
+		refs, values, dataLen int
+		nested                bool
+		ok                    bool
+	}{
+		{"one per ref", 3, 3, 1, false, true},
+		{"fewer values than refs", 3, 2, 1, false, false},
+		{"malformed grid value", 2, 2, 4, false, false},
+		{"nested range", 1, 0, 1, true, false},
+	}
+	for _, c := range cases {
+		b := flatbuffers.NewBuilder(0)
+		b.Finish(buildRangeWithValues(b, c.refs, c.values, c.dataLen, c.nested))
+		err := GetRootAsRange(b.FinishedBytes(), 0).Validate()
+		if c.ok && err != nil {
+			t.Errorf("%s: expected valid range, got %v", c.name, err)
+		}
+		if !c.ok && !errors.Is(err, ErrInvalidRangeValues) {
+			t.Errorf("%s: expected ErrInvalidRangeValues, got %v", c.name, err)
+		}
+	}
+}
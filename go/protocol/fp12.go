@@ -0,0 +1,59 @@
+package protocol
+
+import (
+	"encoding/binary"
+	"math"
+
+	flatbuffers "github.com/google/flatbuffers/go"
+)
+
+// fp12HeaderSize is the Excel FP12 header in front of the doubles of a
+// NumGrid.fp12 image: int32 rows, int32 columns.
+const fp12HeaderSize = 8
+
+// BuildNumGridFP12 serializes a rows x cols row-major grid as a NumGrid in the
+// zero-copy fp12 layout: the FP12 memory image (header, then the doubles,
+// little-endian) in an 8-byte aligned byte vector, with Data left empty. The
+// C++ receiver can then hand Excel a pointer into the message
+// (NumGridAsFP12) instead of copying the numbers out. Returns 0 when
+// len(data) != rows*cols or the dimensions are invalid.
+func BuildNumGridFP12(b *flatbuffers.Builder, rows, cols int32, data []float64) flatbuffers.UOffsetT {
+	if validateDims(rows, cols, len(data)) != nil {
+		return 0
+	}
+	image := make([]byte, fp12HeaderSize+8*len(data))
+	binary.LittleEndian.PutUint32(image[0:], uint32(rows))
+	binary.LittleEndian.PutUint32(image[4:], uint32(cols))
+	for i, v := range data {
+		binary.LittleEndian.PutUint64(image[fp12HeaderSize+8*i:], math.Float64bits(v))
+	}
+	fp12 := createFP12Vector(b, image)
+
+	NumGridStart(b)
+	NumGridAddRows(b, rows)
+	NumGridAddCols(b, cols)
+	NumGridAddFp12(b, fp12)
+	return NumGridEnd(b)
+}
+
+// createFP12Vector writes an fp12 image with the schema's force_align: 8.
+func createFP12Vector(b *flatbuffers.Builder, image []byte) flatbuffers.UOffsetT {
+	b.Prep(8, len(image))
+	return b.CreateByteVector(image)
+}
+
+// Value returns cell j (row-major) of the grid, read from Data or, for the
+// fp12 layout, from the FP12 image. Out-of-range cells read as 0.
+func (rcv *NumGrid) Value(j int) float64 {
+	if image := rcv.Fp12Bytes(); image != nil {
+		off := fp12HeaderSize + 8*j
+		if j < 0 || off+8 > len(image) {
+			return 0
+		}
+		return math.Float64frombits(binary.LittleEndian.Uint64(image[off:]))
+	}
+	if j < 0 || j >= rcv.DataLength() {
+		return 0
+	}
+	return rcv.Data(j)
+}
@@ -13,17 +13,17 @@ import "testing"
 // If this fails, a member was added to ScalarValue/AnyValue in protocol.fbs.
 // Update every ladder that dispatches on the union tag — go/protocol/deepcopy.go
 // (both switches) AND the C++ converters.cpp ladders (AnyToXLOPER12,
-// GridToXLOPER12's per-cell switch, ConvertScalar/ConvertAny) — then bump the
+// ScalarToCell's per-cell switch, ConvertScalar/ConvertAny) — then bump the
 // expected count here and the matching static_asserts in converters.cpp.
 func TestUnionDeepCopyCompleteness(t *testing.T) {
 	// EnumNames* include the NONE sentinel (value 0), so the counts are
-	// member-count + 1: ScalarValue NONE..Date = 9, AnyValue NONE..Date = 13.
+	// member-count + 1: ScalarValue NONE..Date = 9, AnyValue NONE..SparseGrid = 16.
 	if got := len(EnumNamesScalarValue); got != 9 {
 		t.Fatalf("ScalarValue member count = %d, want 9: a member changed in protocol.fbs — "+
 			"update deepcopy.go's ScalarValue switch and converters.cpp's ScalarValue ladders, then bump this count", got)
 	}
-	if got := len(EnumNamesAnyValue); got != 13 {
-		t.Fatalf("AnyValue member count = %d, want 13: a member changed in protocol.fbs — "+
+	if got := len(EnumNamesAnyValue); got != 16 {
+		t.Fatalf("AnyValue member count = %d, want 16: a member changed in protocol.fbs — "+
 			"update deepcopy.go's AnyValue switch and converters.cpp's AnyValue ladders, then bump this count", got)
 	}
 }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <flatbuffers/flatbuffers.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class StringInterner;
+
+// Reuses FlatBufferBuilders across conversions, the C++ counterpart of
+// builderPool in go/protocol/builder_pool.go.
+//
+// A UDF that builds a fresh FlatBufferBuilder per call pays for its heap
+// buffer (and every growth step) each time. A leased builder comes back
+// Clear()ed with its buffer kept, so steady-state calls allocate nothing.
+// A builder holding more than `maxRetainedBytes` on release (one huge grid)
+// is freed instead of being kept, and at most `maxIdle` builders are kept at
+// once.
+//
+// A pool is not thread-safe. ThreadLocal() hands each thread its own pool,
+// which is the intended use: acquire and release on the same thread, inside
+// one call.
+//
+//     auto lease = BuilderPool::ThreadLocal().Acquire();
+//     lease->Finish(ConvertAny(op, *lease));
+//     Send(lease->GetBufferPointer(), lease->GetSize());
+//     // lease goes out of scope: builder cleared and returned
+//
+// A StringInterner caches offsets into one builder's contents, which a pooled
+// builder loses on every release. Use the lease's own Interner(): it travels
+// with the builder and is Reset() whenever the builder is Clear()ed.
+class BuilderPool {
+public:
+    static constexpr size_t kDefaultMaxRetainedBytes = 1 << 20;
+    static constexpr size_t kDefaultMaxIdle = 4;
+    static constexpr size_t kInitialBuilderSize = 1024; // same as the Go pool
+
+    // RAII handle on a pooled builder; returns it to the pool on destruction
+    // (or Release()). Move-only. Must not outlive its pool.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        flatbuffers::FlatBufferBuilder& operator*() const { return *builder_; }
+        flatbuffers::FlatBufferBuilder* operator->() const { return builder_.get(); }
+        flatbuffers::FlatBufferBuilder* get() const { return builder_.get(); }
+        explicit operator bool() const { return builder_ != nullptr; }
+
+        // An interner bound to this builder, created on first use and kept
+        // with it in the pool. Empty at the start of every lease.
+        StringInterner& Interner();
+
+        // Returns the builder early; the lease is empty afterwards.
+        void Release();
+
+    private:
+        friend class BuilderPool;
+        Lease(BuilderPool* pool, std::unique_ptr<flatbuffers::FlatBufferBuilder> builder,
+              std::unique_ptr<StringInterner> interner);
+
+        BuilderPool* pool_ = nullptr;
+        std::unique_ptr<flatbuffers::FlatBufferBuilder> builder_;
+        std::unique_ptr<StringInterner> interner_;
+    };
+
+    explicit BuilderPool(size_t maxRetainedBytes = kDefaultMaxRetainedBytes, size_t maxIdle = kDefaultMaxIdle)
+        : maxRetainedBytes_(maxRetainedBytes), maxIdle_(maxIdle) {}
+    ~BuilderPool();
+
+    BuilderPool(const BuilderPool&) = delete;
+    BuilderPool& operator=(const BuilderPool&) = delete;
+
+    // The calling thread's pool (default limits), created on first use and
+    // destroyed at thread exit.
+    static BuilderPool& ThreadLocal();
+
+    // An empty builder: an idle one if available, else a new one.
+    Lease Acquire();
+
+    // Frees every idle builder.
+    void Trim();
+
+    size_t Acquires() const { return acquires_; }
+    size_t Reuses() const { return reuses_; }      // Acquire() served from an idle builder
+    size_t Trimmed() const { return trimmed_; }    // builders freed on release for holding over maxRetainedBytes
+    size_t Idle() const { return idle_.size(); }
+    size_t IdleBytes() const;                      // bytes idle builders held when returned
+    double ReuseRate() const { return acquires_ ? (double)reuses_ / (double)acquires_ : 0.0; }
+
+private:
+    struct IdleEntry {
+        std::unique_ptr<flatbuffers::FlatBufferBuilder> builder;
+        std::unique_ptr<StringInterner> interner; // null until a lease asked for one
+        size_t used;                              // GetSize() when returned
+    };
+
+    void Return(std::unique_ptr<flatbuffers::FlatBufferBuilder> builder, std::unique_ptr<StringInterner> interner);
+
+    std::vector<IdleEntry> idle_;
+    size_t maxRetainedBytes_;
+    size_t maxIdle_;
+    size_t acquires_ = 0;
+    size_t reuses_ = 0;
+    size_t trimmed_ = 0;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <flatbuffers/flatbuffers.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "types/protocol_generated.h"
+
+// Reassembles protocol::Chunk messages into the FlatBuffer they were cut from.
+//
+// The first chunk of an id allocates the whole `total_size` buffer once;
+// every chunk (in any order) is copied straight to its offset, and when the
+// last byte arrives the buffer itself is handed back as an AssembledMessage,
+// so a message costs one allocation and one copy of each payload byte, with no
+// growing std::vector in between. Duplicate and overlapping chunks are
+// accepted: bytes already received are not counted twice (their contents are
+// not compared). A chunk for an id that was recently completed, expired or
+// dropped as inconsistent is reported as Stale instead of starting a new
+// message; a refused first chunk leaves no trace, so the sender may retry.
+//
+// Memory is bounded twice: a message larger than `maxMessageBytes` is refused
+// on its first chunk, and so is one that would take the bytes reserved by all
+// partial messages past `maxTotalBytes` (after dropping the timed-out ones).
+// A partial message that receives nothing for `timeout` is dropped on the next
+// Add() or ExpireStale().
+//
+// An assembler is not thread-safe; use one per connection or reader thread.
+//
+//     ChunkAssembler assembler;
+//     AssembledMessage msg;
+//     if (assembler.AddBuffer(buf, len, msg) == ChunkStatus::Complete) {
+//         if (const protocol::Any* any = msg.Root<protocol::Any>()) ...
+//     }
+
+enum class ChunkStatus {
+    Accepted,   // stored; the message is still incomplete
+    Complete,   // stored, and `out` now holds the whole message
+    Duplicate,  // every byte of the chunk had already been received
+    Stale,      // the id was recently completed, expired or dropped
+    Invalid,    // malformed, or inconsistent with earlier chunks of the id
+    OverBudget, // the message would exceed maxMessageBytes or maxTotalBytes
+};
+
+const char* ChunkStatusName(ChunkStatus status);
+
+// A reassembled message. Owns its buffer; move-only.
+class AssembledMessage {
+public:
+    static constexpr size_t kAlignment = 16; // FlatBuffers needs the largest scalar alignment
+
+    AssembledMessage() = default;
+    AssembledMessage(AssembledMessage&&) noexcept = default;
+    AssembledMessage& operator=(AssembledMessage&&) noexcept = default;
+    AssembledMessage(const AssembledMessage&) = delete;
+    AssembledMessage& operator=(const AssembledMessage&) = delete;
+
+    uint64_t Id() const { return id_; }
+    uint32_t MsgType() const { return msgType_; }
+    const uint8_t* Data() const { return data_.get(); }
+    size_t Size() const { return size_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+    // The root table of the message if the buffer verifies as a T, nullptr
+    // otherwise. Points into this message's buffer; nothing is copied.
+    template <typename T>
+    const T* Root(const flatbuffers::Verifier::Options& opts = flatbuffers::Verifier::Options()) const {
+        if (!data_) return nullptr;
+        flatbuffers::Verifier verifier(data_.get(), size_, opts);
+        return verifier.VerifyBuffer<T>(nullptr) ? flatbuffers::GetRoot<T>(data_.get()) : nullptr;
+    }
+
+    void Reset() {
+        data_.reset();
+        size_ = 0;
+    }
+
+private:
+    friend class ChunkAssembler;
+    struct AlignedDelete {
+        void operator()(uint8_t* p) const;
+    };
+    using Buffer = std::unique_ptr<uint8_t[], AlignedDelete>;
+    static Buffer Allocate(size_t size);
+
+    Buffer data_;
+    size_t size_ = 0;
+    uint64_t id_ = 0;
+    uint32_t msgType_ = 0;
+};
+
+class ChunkAssembler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Limits {
+        size_t maxMessageBytes = size_t(256) << 20; // per id
+        size_t maxTotalBytes = size_t(1) << 30;     // reserved by all partial messages
+        std::chrono::milliseconds timeout{30000};   // since the id's last chunk; 0 = never
+    };
+
+    struct Stats {
+        size_t pending = 0;      // partial messages held
+        size_t pendingBytes = 0; // bytes reserved for them
+        size_t completed = 0;
+        size_t duplicates = 0;
+        size_t stale = 0;
+        size_t rejected = 0;     // Invalid or OverBudget
+        size_t expired = 0;
+        uint64_t bytesCopied = 0;
+    };
+
+    // Finished ids remembered for Stale detection.
+    static constexpr size_t kRecentIds = 1024;
+
+    ChunkAssembler() : ChunkAssembler(Limits()) {}
+    explicit ChunkAssembler(const Limits& limits) : limits_(limits) {}
+
+    ChunkAssembler(const ChunkAssembler&) = delete;
+    ChunkAssembler& operator=(const ChunkAssembler&) = delete;
+
+    // Stores one chunk. On Complete, `out` receives the message and the id is
+    // forgotten; `out` is left alone otherwise.
+    ChunkStatus Add(uint64_t id, uint32_t totalSize, uint32_t offset, const uint8_t* data, size_t len,
+                    uint32_t msgType, AssembledMessage& out, Clock::time_point now = Clock::now());
+    ChunkStatus Add(const protocol::Chunk* chunk, AssembledMessage& out, Clock::time_point now = Clock::now());
+
+    // Verifies `buf` as a Chunk FlatBuffer first; Invalid if it does not.
+    ChunkStatus AddBuffer(const void* buf, size_t size, AssembledMessage& out, Clock::time_point now = Clock::now());
+
+    // Drops partial messages idle for longer than the timeout. Returns how many.
+    size_t ExpireStale(Clock::time_point now = Clock::now());
+
+    // Drops every partial message and forgets the recent ids.
+    void Clear();
+
+    Stats GetStats() const;
+    const Limits& GetLimits() const { return limits_; }
+
+private:
+    struct Partial {
+        AssembledMessage::Buffer data;
+        uint32_t totalSize = 0;
+        uint32_t msgType = 0;
+        uint32_t received = 0;
+        std::map<uint32_t, uint32_t> ranges; // received [begin, end), disjoint and non-adjacent
+        Clock::time_point lastActivity;
+    };
+
+    // Records [begin, end) and returns how many of its bytes are new.
+    static uint32_t MarkReceived(Partial& p, uint32_t begin, uint32_t end);
+    void Drop(std::unordered_map<uint64_t, Partial>::iterator it);
+    void Remember(uint64_t id);
+    ChunkStatus Reject(ChunkStatus status);
+
+    Limits limits_;
+    std::unordered_map<uint64_t, Partial> partials_;
+    std::unordered_set<uint64_t> recent_;
+    std::deque<uint64_t> recentOrder_;
+    size_t pendingBytes_ = 0;
+    Clock::time_point nextSweep_{};
+    Stats stats_;
+};
+
+// Cuts `size` bytes into Chunk FlatBuffers carrying at most `chunkBytes` of
+// payload each, in offset order, and passes each finished buffer to `sink`.
+// `builder` is cleared and reused for every chunk. Returns the chunk count
+// (0 if there is nothing to send, `chunkBytes` is 0, or `size` does not fit
+// a Chunk's uint32 total_size).
+size_t SplitIntoChunks(flatbuffers::FlatBufferBuilder& builder, uint64_t id, uint32_t msgType, const uint8_t* data,
+                       size_t size, size_t chunkBytes, const std::function<void(const uint8_t*, size_t)>& sink);
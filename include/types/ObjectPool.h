@@ -6,18 +6,116 @@
 #include <array>
 #include <thread>
 #include <functional>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 // A thread-safe object pool with sharded locking to reduce contention.
-template <typename T, size_t ShardCount = 16>
+//
+// Each thread keeps a magazine: a fixed array of up to MagazineSize objects
+// it acquires from and releases to without any lock. An empty magazine is
+// refilled with half a magazine from the thread's shard under one lock; a
+// full one spills half back the same way. Objects may be released on a
+// different thread from the one that acquired them.
+//
+// A magazine outlives neither its thread nor its pool: on thread exit it
+// spills into the shards, and the pool's destructor frees the objects still
+// held by other threads' magazines. Destroying a pool while another thread is
+// still calling Acquire/Release on it is undefined, as before.
+//
+// Each shard holds at most maxPerShard idle objects; a spill past that frees
+// the excess instead of keeping it, so a burst does not pin its peak for the
+// life of the process. Trim / TrimIdle give memory back on demand and
+// GetStats reports the counters.
+template <typename T, size_t ShardCount = 16, size_t MagazineSize = 64>
 class ObjectPool {
+    static_assert(MagazineSize >= 2, "a magazine moves MagazineSize / 2 objects per refill or spill");
+
 private:
     // Align each shard to 64 bytes to prevent false sharing between threads on different cores.
     struct alignas(64) Shard {
         std::vector<T*> pool;
         std::mutex mutex;
+        // Written under mutex, read by GetStats / TrimIdle without it.
+        std::atomic<size_t> size{0};
+        std::atomic<size_t> refills{0};
+        std::atomic<size_t> spills{0};
+        std::atomic<size_t> frees{0};
+        std::atomic<int64_t> lastUse{0}; // steady_clock ticks of the last refill/spill
+    };
+
+    struct Registry;
+
+    // Counters are only written by the owning thread; relaxed load + store is
+    // enough and keeps the fast path free of locked instructions.
+    static void Bump(std::atomic<size_t>& counter, size_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    struct Magazine {
+        std::shared_ptr<Registry> registry;
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> acquires{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> releases{0};
+        T* items[MagazineSize];
+    };
+
+    // Shared between a pool and the magazines of every thread that used it,
+    // so a magazine can tell at thread exit whether its pool still exists.
+    struct Registry {
+        std::mutex mutex;
+        ObjectPool* pool; // null once the pool is destroyed
+        std::vector<Magazine*> magazines;
+        // Counters of magazines whose thread has exited.
+        size_t acquires = 0;
+        size_t misses = 0;
+        size_t releases = 0;
+        explicit Registry(ObjectPool* p) : pool(p) {}
+    };
+
+    // The calling thread's magazines, one per pool it has touched (usually
+    // one). Destroyed at thread exit: spills into live pools.
+    struct LocalMagazines {
+        std::vector<std::unique_ptr<Magazine>> list;
+        ~LocalMagazines() {
+            for (auto& mag : list) {
+                Registry& reg = *mag->registry;
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                if (reg.pool) {
+                    reg.pool->Spill(*mag, mag->count.load(std::memory_order_relaxed));
+                    reg.magazines.erase(std::find(reg.magazines.begin(), reg.magazines.end(), mag.get()));
+                    reg.acquires += mag->acquires.load(std::memory_order_relaxed);
+                    reg.misses += mag->misses.load(std::memory_order_relaxed);
+                    reg.releases += mag->releases.load(std::memory_order_relaxed);
+                }
+            }
+        }
     };
 
     std::array<Shard, ShardCount> shards_;
+    std::shared_ptr<Registry> registry_ = std::make_shared<Registry>(this);
+    std::atomic<size_t> maxPerShard_;
+
+    static int64_t Now() {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // Frees idle objects of `shard` down to `keep`. Caller holds shard.mutex.
+    static size_t TrimShardLocked(Shard& shard, size_t keep) {
+        size_t freed = 0;
+        while (shard.pool.size() > keep) {
+            delete shard.pool.back();
+            shard.pool.pop_back();
+            ++freed;
+        }
+        shard.pool.shrink_to_fit();
+        shard.size.store(shard.pool.size(), std::memory_order_relaxed);
+        shard.frees.fetch_add(freed, std::memory_order_relaxed);
+        return freed;
+    }
 
     // Helper to determine the shard index for the current thread.
     // We use a simple hash of the thread ID.
@@ -26,45 +124,280 @@ private:
         return h % ShardCount;
     }
 
-public:
-    T* Acquire() {
-        size_t idx = GetShardIndex();
-        Shard& shard = shards_[idx];
+    Magazine& LocalMagazine() {
+        static thread_local LocalMagazines local;
+        for (auto& mag : local.list) {
+            if (mag->registry.get() == registry_.get()) return *mag;
+        }
+        return Register(local);
+    }
+
+    Magazine& Register(LocalMagazines& local) {
+        local.list.push_back(std::unique_ptr<Magazine>(new Magazine()));
+        Magazine& mag = *local.list.back();
+        mag.registry = registry_;
+        std::lock_guard<std::mutex> lock(registry_->mutex);
+        registry_->magazines.push_back(&mag);
+        return mag;
+    }
+
+    // Moves up to half a magazine from the thread's shard into `mag`.
+    void Refill(Magazine& mag) {
+        Shard& shard = shards_[GetShardIndex()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const size_t count = mag.count.load(std::memory_order_relaxed);
+        size_t n = std::min(shard.pool.size(), MagazineSize / 2);
+        std::copy(shard.pool.end() - n, shard.pool.end(), mag.items + count);
+        shard.pool.resize(shard.pool.size() - n);
+        mag.count.store(count + n, std::memory_order_relaxed);
+        shard.size.store(shard.pool.size(), std::memory_order_relaxed);
+        shard.refills.fetch_add(1, std::memory_order_relaxed);
+        shard.lastUse.store(Now(), std::memory_order_relaxed);
+    }
+
+    // Moves the top `n` objects of `mag` into the thread's shard; whatever
+    // would take the shard past maxPerShard is freed instead.
+    void Spill(Magazine& mag, size_t n) {
+        Shard& shard = shards_[GetShardIndex()];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const size_t count = mag.count.load(std::memory_order_relaxed);
+        const size_t limit = maxPerShard_.load(std::memory_order_relaxed);
+        const size_t room = shard.pool.size() < limit ? limit - shard.pool.size() : 0;
+        const size_t keep = std::min(n, room);
+        shard.pool.insert(shard.pool.end(), mag.items + count - n, mag.items + count - n + keep);
+        for (size_t i = count - n + keep; i < count; ++i) delete mag.items[i];
+        mag.count.store(count - n, std::memory_order_relaxed);
+        shard.size.store(shard.pool.size(), std::memory_order_relaxed);
+        shard.spills.fetch_add(1, std::memory_order_relaxed);
+        if (n > keep) shard.frees.fetch_add(n - keep, std::memory_order_relaxed);
+        shard.lastUse.store(Now(), std::memory_order_relaxed);
+    }
+
+    // Puts n objects (nulls skipped) into `mag` until it is full and the rest
+    // into the thread's shard as one run under one lock; whatever would take
+    // the shard past maxPerShard is freed. Returns the non-null count.
+    size_t Stash(Magazine& mag, T* const* items, size_t n) {
+        size_t count = mag.count.load(std::memory_order_relaxed);
+        size_t i = 0, stashed = 0;
+        for (; i < n && count < MagazineSize; ++i) {
+            if (items[i]) {
+                mag.items[count++] = items[i];
+                ++stashed;
+            }
+        }
+        mag.count.store(count, std::memory_order_relaxed);
+        if (i == n) return stashed;
 
+        Shard& shard = shards_[GetShardIndex()];
         std::lock_guard<std::mutex> lock(shard.mutex);
-        if (shard.pool.empty()) {
-            return new T();
+        const size_t limit = maxPerShard_.load(std::memory_order_relaxed);
+        size_t freed = 0;
+        for (; i < n; ++i) {
+            if (!items[i]) continue;
+            ++stashed;
+            if (shard.pool.size() < limit) {
+                shard.pool.push_back(items[i]);
+            } else {
+                delete items[i];
+                ++freed;
+            }
+        }
+        shard.size.store(shard.pool.size(), std::memory_order_relaxed);
+        shard.spills.fetch_add(1, std::memory_order_relaxed);
+        if (freed) shard.frees.fetch_add(freed, std::memory_order_relaxed);
+        shard.lastUse.store(Now(), std::memory_order_relaxed);
+        return stashed;
+    }
+
+public:
+    static constexpr size_t kDefaultMaxPerShard = 4096;
+
+    // Occupancy and traffic counters (see GetStats). Counters are cumulative
+    // since construction; sizes are current. Taken without stopping other
+    // threads, so the fields are individually current, not one snapshot.
+    struct Stats {
+        size_t acquires = 0;  // Acquire calls
+        size_t hits = 0;      // Acquire calls served from the pool
+        size_t misses = 0;    // Acquire calls that allocated a new T
+        size_t releases = 0;  // Release calls (non-null)
+        size_t frees = 0;     // pooled objects deleted by the shard limit, Trim or Clear
+        size_t pooled = 0;    // idle objects in shards and live threads' magazines
+        size_t pooledBytes = 0;
+        std::array<size_t, ShardCount> shardSize{};    // idle objects per shard
+        std::array<size_t, ShardCount> shardRefills{}; // magazine refills served per shard
+        std::array<size_t, ShardCount> shardSpills{};  // magazine spills received per shard
+        std::array<size_t, ShardCount> shardFrees{};   // objects freed per shard
+    };
+
+    // maxPerShard bounds the idle objects each shard keeps (the high-water
+    // mark); per-thread magazines add at most MagazineSize each on top.
+    explicit ObjectPool(size_t maxPerShard = kDefaultMaxPerShard) : maxPerShard_(maxPerShard) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    T* Acquire() {
+        Magazine& mag = LocalMagazine();
+        Bump(mag.acquires);
+        if (mag.count.load(std::memory_order_relaxed) == 0) {
+            Refill(mag);
+            if (mag.count.load(std::memory_order_relaxed) == 0) {
+                Bump(mag.misses);
+                return new T();
+            }
         }
-        T* item = shard.pool.back();
-        shard.pool.pop_back();
-        return item;
+        const size_t count = mag.count.load(std::memory_order_relaxed) - 1;
+        mag.count.store(count, std::memory_order_relaxed);
+        return mag.items[count];
     }
 
     void Release(T* item) {
         if (!item) return;
 
-        // We release back to the current thread's shard, not necessarily the one it came from.
+        // We release to the current thread's magazine, not necessarily the one it came from.
         // This is fine as it keeps thread-local caches hot and balances naturally.
-        size_t idx = GetShardIndex();
-        Shard& shard = shards_[idx];
+        Magazine& mag = LocalMagazine();
+        Bump(mag.releases);
+        if (mag.count.load(std::memory_order_relaxed) == MagazineSize) Spill(mag, MagazineSize / 2);
+        const size_t count = mag.count.load(std::memory_order_relaxed);
+        mag.items[count] = item;
+        mag.count.store(count + 1, std::memory_order_relaxed);
+    }
 
-        std::lock_guard<std::mutex> lock(shard.mutex);
-        shard.pool.push_back(item);
+    // Acquires n objects into out[0..n): first from the thread's magazine
+    // (no lock), then as one run from its shard (one lock), then with new T.
+    // If an allocation throws, the objects already taken go back to the pool
+    // and the exception propagates.
+    void AcquireBulk(T** out, size_t n) {
+        if (n == 0) return;
+        Magazine& mag = LocalMagazine();
+
+        const size_t count = mag.count.load(std::memory_order_relaxed);
+        size_t got = std::min(count, n);
+        std::copy(mag.items + count - got, mag.items + count, out);
+        mag.count.store(count - got, std::memory_order_relaxed);
+
+        if (got < n) {
+            Shard& shard = shards_[GetShardIndex()];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const size_t take = std::min(shard.pool.size(), n - got);
+            std::copy(shard.pool.end() - take, shard.pool.end(), out + got);
+            shard.pool.resize(shard.pool.size() - take);
+            shard.size.store(shard.pool.size(), std::memory_order_relaxed);
+            shard.refills.fetch_add(1, std::memory_order_relaxed);
+            shard.lastUse.store(Now(), std::memory_order_relaxed);
+            got += take;
+        }
+
+        const size_t pooled = got;
+        try {
+            for (; got < n; ++got) out[got] = new T();
+        } catch (...) {
+            Stash(mag, out, got);
+            throw;
+        }
+        Bump(mag.acquires, n);
+        Bump(mag.misses, n - pooled);
     }
 
-    void Clear() {
-        // Lock and clear all shards
+    // Releases n objects (nulls skipped) with at most one shard lock.
+    void ReleaseBulk(T* const* items, size_t n) {
+        if (n == 0) return;
+        Magazine& mag = LocalMagazine();
+        Bump(mag.releases, Stash(mag, items, n));
+    }
+
+    // Changes the per-shard high-water mark. Shards already above it shrink
+    // on their next spill or Trim.
+    void SetMaxPerShard(size_t maxPerShard) {
+        maxPerShard_.store(maxPerShard, std::memory_order_relaxed);
+    }
+
+    size_t MaxPerShard() const {
+        return maxPerShard_.load(std::memory_order_relaxed);
+    }
+
+    // Spills the calling thread's magazine, then frees idle objects until the
+    // shards hold at most targetBytes (split evenly across shards). Other
+    // threads' magazines are not touched. Returns the objects freed.
+    size_t Trim(size_t targetBytes = 0) {
+        Magazine& mag = LocalMagazine();
+        if (mag.count.load(std::memory_order_relaxed) > 0) Spill(mag, mag.count.load(std::memory_order_relaxed));
+        const size_t keep = targetBytes / sizeof(T) / ShardCount;
+        size_t freed = 0;
         for (auto& shard : shards_) {
             std::lock_guard<std::mutex> lock(shard.mutex);
-            for (T* item : shard.pool) {
-                delete item;
+            freed += TrimShardLocked(shard, keep);
+        }
+        return freed;
+    }
+
+    // Empties every shard that has seen no refill or spill for `idle` (the
+    // calling thread's magazine is left alone). Meant to be called from a
+    // timer or a calculation-ended handler. Returns the objects freed.
+    size_t TrimIdle(std::chrono::steady_clock::duration idle) {
+        const int64_t cutoff = Now() - idle.count();
+        size_t freed = 0;
+        for (auto& shard : shards_) {
+            if (shard.lastUse.load(std::memory_order_relaxed) > cutoff) continue;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.lastUse.load(std::memory_order_relaxed) > cutoff) continue;
+            freed += TrimShardLocked(shard, 0);
+        }
+        return freed;
+    }
+
+    Stats GetStats() const {
+        Stats stats;
+        for (size_t i = 0; i < ShardCount; ++i) {
+            const Shard& shard = shards_[i];
+            stats.shardSize[i] = shard.size.load(std::memory_order_relaxed);
+            stats.shardRefills[i] = shard.refills.load(std::memory_order_relaxed);
+            stats.shardSpills[i] = shard.spills.load(std::memory_order_relaxed);
+            stats.shardFrees[i] = shard.frees.load(std::memory_order_relaxed);
+            stats.pooled += stats.shardSize[i];
+            stats.frees += stats.shardFrees[i];
+        }
+        {
+            std::lock_guard<std::mutex> lock(registry_->mutex);
+            stats.acquires = registry_->acquires;
+            stats.misses = registry_->misses;
+            stats.releases = registry_->releases;
+            for (const Magazine* mag : registry_->magazines) {
+                stats.acquires += mag->acquires.load(std::memory_order_relaxed);
+                stats.misses += mag->misses.load(std::memory_order_relaxed);
+                stats.releases += mag->releases.load(std::memory_order_relaxed);
+                stats.pooled += mag->count.load(std::memory_order_relaxed);
             }
-            shard.pool.clear();
         }
+        stats.hits = stats.acquires - stats.misses;
+        stats.pooledBytes = stats.pooled * sizeof(T);
+        return stats;
+    }
+
+    // Frees the pooled objects in the shards and in the calling thread's
+    // magazine. Other threads' magazines (at most MagazineSize objects each)
+    // are left alone: they are only safe to touch from their own thread.
+    void Clear() {
+        Trim(0);
     }
 
     ~ObjectPool() {
-        Clear();
+        {
+            std::lock_guard<std::mutex> lock(registry_->mutex);
+            for (Magazine* mag : registry_->magazines) {
+                const size_t count = mag->count.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < count; ++i) delete mag->items[i];
+                mag->count.store(0, std::memory_order_relaxed);
+            }
+            registry_->magazines.clear();
+            registry_->pool = nullptr;
+        }
+        for (auto& shard : shards_) {
+            for (T* item : shard.pool) {
+                delete item;
+            }
+            shard.pool.clear();
+        }
     }
 };
 
@@ -4,29 +4,29 @@
 
 #include "types/xlcall.h"
 #include "types/pascalstr.h"
-#include <vector>
+#include "types/mem.h"
 #include <string>
 #include <cstring>
 #include <cwchar>
-#include <utility> // for std::move
 
 // A helper class to manage XLOPER12 memory for arguments passed to Excel.
 // This is safer than using TempStr12/TempInt12 for generic wrappers because it
 // manages memory lifetime explicitly and avoids ring buffer limits.
+// String payloads come from NewExcelStringBuffer (the Pascal string slab for
+// short strings) and are released on destruction.
 class ScopedXLOPER12 {
 public:
     ScopedXLOPER12() {
         m_op.xltype = xltypeNil;
     }
 
-    // Move constructor
-    ScopedXLOPER12(ScopedXLOPER12&& other) noexcept : m_op(other.m_op), m_buffer(std::move(other.m_buffer)) {
-        // If we moved a string, we must update the pointer to the new buffer location
-        // because std::vector move might transfer ownership but the pointer value in m_op
-        // needs to be valid.
-        if (m_op.xltype == xltypeStr) {
-            m_op.val.str = m_buffer.data();
-        }
+    ~ScopedXLOPER12() {
+        FreeExcelStringBuffer(m_buffer);
+    }
+
+    // Move constructor: the string buffer changes owner, its address does not.
+    ScopedXLOPER12(ScopedXLOPER12&& other) noexcept : m_op(other.m_op), m_buffer(other.m_buffer) {
+        other.m_buffer = nullptr;
         other.m_op.xltype = xltypeNil;
     }
 
@@ -36,11 +36,10 @@ public:
 
     ScopedXLOPER12& operator=(ScopedXLOPER12&& other) noexcept {
         if (this != &other) {
+            FreeExcelStringBuffer(m_buffer);
             m_op = other.m_op;
-            m_buffer = std::move(other.m_buffer);
-            if (m_op.xltype == xltypeStr) {
-                m_op.val.str = m_buffer.data();
-            }
+            m_buffer = other.m_buffer;
+            other.m_buffer = nullptr;
             other.m_op.xltype = xltypeNil;
         }
         return *this;
@@ -90,10 +89,10 @@ public:
             // (The previous open-coded path clamped the body copy but copied
             // the original — possibly oversized — prefix verbatim.)
             size_t len = (size_t)op->val.str[0];
-            m_buffer.resize(WritePascalWBufferLen(len));
-            WritePascalWString(m_buffer.data(), op->val.str + 1, len);
+            m_buffer = NewExcelStringBuffer(WritePascalWBufferLen(len));
+            WritePascalWString(m_buffer, op->val.str + 1, len);
             m_op.xltype = xltypeStr;
-            m_op.val.str = m_buffer.data();
+            m_op.val.str = m_buffer;
         } else {
             m_op = *op;
         }
@@ -120,15 +119,15 @@ private:
             return;
         }
         size_t len = std::wcslen(str);
-        m_buffer.resize(WritePascalWBufferLen(len)); // len prefix + body + NUL
-        WritePascalWString(m_buffer.data(), str, len);
+        m_buffer = NewExcelStringBuffer(WritePascalWBufferLen(len)); // len prefix + body + NUL
+        WritePascalWString(m_buffer, str, len);
 
         m_op.xltype = xltypeStr;
-        m_op.val.str = m_buffer.data();
+        m_op.val.str = m_buffer;
     }
 
-    XLOPER12 m_op;
-    std::vector<wchar_t> m_buffer; // Used for xltypeStr
+    XLOPER12 m_op{};
+    XCHAR* m_buffer = nullptr; // Used for xltypeStr
 };
 
 // A helper class to manage the result XLOPER12 from Excel callbacks.
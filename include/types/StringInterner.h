@@ -0,0 +1,78 @@
+#pragma once
+
+#include <windows.h>
+
+#include "types/xlcall.h"
+#include "types/protocol_generated.h"
+#include <flatbuffers/flatbuffers.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Opt-in string dedup for the Excel -> FlatBuffers converters.
+//
+// Grids tend to repeat a handful of strings (currency codes, status flags,
+// sector names) thousands of times. Passed to ConvertGrid / ConvertMultiToAny /
+// ConvertScalar, an interner hashes each Excel Pascal string on its raw UTF-16
+// body -- before any transcoding -- and hands back the offset serialized for
+// the first occurrence, the same sharing FlatBuffers' CreateSharedString does
+// but without transcoding the repeats. For grid cells the whole Scalar/Str
+// table pair is shared too: a FlatBuffers vector may reference one table any
+// number of times, and readers cannot tell the difference.
+//
+// An interner is bound to one builder's contents: call Reset() whenever that
+// builder is Clear()ed or reused. It also resets itself when handed a
+// different builder or one that has shrunk since its last use, but that check
+// cannot see a builder cleared and regrown past its old size. With a
+// BuilderPool, use the lease's Interner(), which the pool resets on release.
+// Not thread-safe; use one per builder/thread.
+class StringInterner {
+public:
+    // Strings longer than this are serialized normally and never cached:
+    // repeated values are short, and caching long ones only costs key memory.
+    static constexpr size_t kMaxInternLen = 256;
+
+    // `tableSize` bounds the number of distinct strings remembered (rounded
+    // up to a power of two). Once it is 3/4 full, new strings are serialized
+    // without being cached; existing entries keep hitting.
+    explicit StringInterner(size_t tableSize = 4096);
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Offset of a string equal to `str` (Excel Pascal, may be null) in `builder`,
+    // serialized on first use.
+    flatbuffers::Offset<flatbuffers::String> Intern(flatbuffers::FlatBufferBuilder& builder, const XCHAR* str);
+
+    // Same, returning a Scalar{Str} table shared by every equal cell.
+    flatbuffers::Offset<protocol::Scalar> InternScalar(flatbuffers::FlatBufferBuilder& builder, const XCHAR* str);
+
+    // Forget every entry (counters are kept).
+    void Reset();
+
+    size_t Hits() const { return hits_; }
+    size_t Misses() const { return misses_; }
+    size_t Size() const { return used_; }
+    size_t TableSize() const { return slots_.size(); }
+
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        uint32_t keyPos = 0; // body offset into keys_
+        uint32_t len = 0;
+        flatbuffers::uoffset_t str = 0;    // 0 = empty slot
+        flatbuffers::uoffset_t scalar = 0; // 0 = no Scalar table yet
+    };
+
+    Slot* Find(const XCHAR* str, bool* hit);
+    void Claim(Slot* slot, const XCHAR* str, flatbuffers::uoffset_t strOff);
+    void SyncBuilder(const flatbuffers::FlatBufferBuilder& builder);
+
+    std::vector<Slot> slots_;
+    std::vector<XCHAR> keys_;
+    size_t used_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    const flatbuffers::FlatBufferBuilder* builder_ = nullptr;
+    size_t builderSize_ = 0;
+};
@@ -2,7 +2,9 @@
 #include <windows.h>
 #include "types/xlcall.h"
 #include "types/protocol_generated.h" // Needed for protocol:: types
+#include "types/StringInterner.h"
 #include <flatbuffers/flatbuffers.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -24,6 +26,10 @@
  *       never crashes. Populating `sheet_name` is purely additive — callers
  *       that previously saw an always-empty name are unaffected.
  *
+ * Names may be cached by idSheet (opt-in, see SetSheetNameCacheEnabled), and the name
+ * is written with CreateSharedString, so ranges on one sheet converted into
+ * the same builder share a single copy.
+ *
  * @param op      Reference XLOPER12. Other xltypes yield an empty Range
  *                (only the format string is carried).
  * @param builder Destination FlatBufferBuilder.
@@ -31,19 +37,183 @@
  * @return Offset to the constructed protocol::Range.
  */
 flatbuffers::Offset<protocol::Range> ConvertRange(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder, const std::string& format = "");
+
+/**
+ * @brief Serialize an Excel Pascal string (`[0]`=length, UTF-16 body) as a
+ *        FlatBuffers string, transcoding straight into builder memory.
+ *
+ * Equivalent to `builder.CreateString(ConvertExcelString(str))` and
+ * byte-identical on the wire, but without the intermediate std::string: the
+ * worst-case UTF-8 size is reserved inside the builder, the body is
+ * transcoded in place and the reservation trimmed. Used for every string cell
+ * produced by ConvertScalar / ConvertAny / ConvertGrid.
+ *
+ * @param builder Destination FlatBufferBuilder (must not be inside a table).
+ * @param str     Excel Pascal string; null is serialized as "".
+ * @return Offset to the new flatbuffers::String.
+ */
+flatbuffers::Offset<flatbuffers::String> CreateStringFromExcel(flatbuffers::FlatBufferBuilder& builder, const XCHAR* str);
+
+/**
+ * @brief ConvertRange plus the referenced cell values, so the receiver needs
+ *        no second round trip to read them.
+ *
+ * Each area is read with one `xlCoerce` call (released through
+ * ScopedXLOPER12Result) and stored in `Range.values[i]` for `refs[i]`,
+ * converted like ConvertAny: a single cell as a scalar, larger areas in the
+ * grid encoding ConvertMultiToAny selects. `values` is all or nothing: if any
+ * area cannot be read, the field is omitted and the Range is otherwise the
+ * same as ConvertRange's.
+ *
+ * @param xlret Optional. Receives xlretSuccess or the first failing xlCoerce
+ *              code. xlretUncalced means an area is not yet calculated: return
+ *              from the UDF and Excel calls it again once it is.
+ */
+flatbuffers::Offset<protocol::Range> ConvertRangeWithValues(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder,
+                                                            const std::string& format = "", int* xlret = nullptr);
+
+// Rect coalescing for multi-area references. When enabled (it is off by
+// default), ConvertRange / ConvertRangeWithValues and RangeToXLOPER12 pass
+// their rects through CoalesceRefs first, so a UNION/OFFSET selection of many
+// adjacent strips travels and is coerced as a few areas.
+//
+// CoalesceRefs drops rects wholly inside another one (checked for up to 1024
+// rects), merges rects with the same row span whose columns touch or overlap
+// and, likewise, the same column span with touching rows, repeating until
+// nothing merges; then sorts row-major. The cells covered are unchanged, but
+// a cell in two overlapping areas is now counted once (SUM over a union
+// differs) and area numbers (INDEX's area_num) change. If any rect is
+// malformed (first > last) nothing is changed. Returns the new count.
+size_t CoalesceRefs(XLREF12* refs, size_t count);
+void SetRectCoalescing(bool enabled);
+bool RectCoalescingEnabled();
+
+// Sheet-name cache for ConvertRange. When enabled (it is off by default),
+// names are cached by idSheet for the whole DLL: a cached xltypeRef needs no
+// Excel callback and a cached xltypeSRef only xlSheetId. The DLL cannot see a
+// rename or a reused idSheet, so a cached name goes stale until the cache is
+// invalidated; enable it only if you call InvalidateSheetNameCache at the
+// start of each recalc (e.g. alongside XlArenaBeginEpoch) and after a rename.
+// Disabling the cache also empties it.
+void InvalidateSheetNameCache();
+void SetSheetNameCacheEnabled(bool enabled);
+bool SheetNameCacheEnabled();
+
+struct SheetNameCacheStats {
+    size_t entries = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0; // lookups that called xlSheetNm
+    uint64_t epoch = 0;  // InvalidateSheetNameCache calls
+};
+SheetNameCacheStats GetSheetNameCacheStats();
 flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbuffers::FlatBufferBuilder& builder);
 flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder);
 flatbuffers::Offset<protocol::NumGrid> ConvertNumGrid(FP12* fp, flatbuffers::FlatBufferBuilder& builder);
+// Serializes a rows x cols row-major grid as a NumGrid in the zero-copy
+// `fp12` layout: an FP12 image (header, then the doubles) in an 8-byte
+// aligned byte vector, with `data` left empty. Receivers read it through
+// NumGridAsFP12 (no copy), NumGridToFP12 or AnyToXLOPER12.
+flatbuffers::Offset<protocol::NumGrid> CreateNumGridFP12(flatbuffers::FlatBufferBuilder& builder, int rows, int cols, const double* data);
 flatbuffers::Offset<protocol::Any> ConvertAny(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder);
 
+// Dedup overloads: with a non-null `interner`, string cells that repeat are
+// serialized once and shared (see StringInterner.h). A null interner is the
+// plain conversion above; the output decodes identically either way.
+flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbuffers::FlatBufferBuilder& builder, StringInterner* interner);
+flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder, StringInterner* interner);
+
 // Flatbuffers -> Excel
+
+// How GridToXLOPER12 allocates the result array.
+enum class XlGridAlloc {
+    // new XLOPER12[count] plus one XCHAR buffer per string cell; string
+    // elements carry xlbitDLLFree and are freed one by one.
+    PerCell,
+    // One pre-sized block (NewXLOPER12Slab) for the elements and every string
+    // body; freed with a single deallocation. String elements carry no
+    // xlbitDLLFree.
+    Slab,
+};
+
 LPXLOPER12 AnyToXLOPER12(const protocol::Any* any);
+// Same, with Grid payloads allocated as `gridAlloc`.
+LPXLOPER12 AnyToXLOPER12(const protocol::Any* any, XlGridAlloc gridAlloc);
 LPXLOPER12 RangeToXLOPER12(const protocol::Range* range);
 LPXLOPER12 GridToXLOPER12(const protocol::Grid* grid);
+LPXLOPER12 GridToXLOPER12(const protocol::Grid* grid, XlGridAlloc alloc);
+// Rebuilds the row-major xltypeMulti from a column-major protocol::ColumnGrid
+// (null cells become xltypeNil). Malformed payloads yield #VALUE!.
+LPXLOPER12 ColumnGridToXLOPER12(const protocol::ColumnGrid* grid);
+// Bulk-fills the dense numbers of a protocol::NumGridEx, then patches each
+// exception cell. Malformed payloads (including unsorted or out-of-range
+// exception indices) yield #VALUE!.
+LPXLOPER12 NumGridExToXLOPER12(const protocol::NumGridEx* grid);
+// Expands a protocol::SparseGrid: an all-xltypeNil array with the listed
+// cells filled in. Same validation and #VALUE! failure as NumGridExToXLOPER12.
+LPXLOPER12 SparseGridToXLOPER12(const protocol::SparseGrid* grid);
 FP12* NumGridToFP12(const protocol::NumGrid* grid);
+// Zero-copy view of a NumGrid in the `fp12` layout: a pointer to the FP12
+// image inside the received message, or null when the grid does not use that
+// layout, the image header or size does not match rows/cols, or the image is
+// not 8-byte aligned in memory (fall back to NumGridToFP12 then). The FP12 is
+// only valid while the message buffer is; keep it alive until Excel has
+// copied the return value.
+const FP12* NumGridAsFP12(const protocol::NumGrid* grid);
+
+// One-pass census of an xltypeMulti, taken before anything is serialized so
+// that the array encoding (and builder sizing) comes from a single scan.
+// Cells are classified the way ConvertScalar serializes them: ownership bits
+// are masked, and anything other than a number, integer, boolean, string or
+// error counts as nil.
+struct GridProfile {
+    int rows = 0;
+    int cols = 0;
+    size_t cells = 0;   // rows * cols
+
+    size_t nums = 0;    // xltypeNum
+    size_t ints = 0;    // xltypeInt
+    size_t bools = 0;   // xltypeBool
+    size_t strs = 0;    // xltypeStr
+    size_t errs = 0;    // xltypeErr
+    size_t nils = 0;    // everything else
+
+    size_t integralNums = 0; // xltypeNum cells holding a whole number in int32 range
+    size_t strUnits = 0;     // UTF-16 code units across all string cells
+
+    // True when no column mixes value types (nils allowed). columnTypes then
+    // holds one ColumnType per column, an all-nil column being typed Num.
+    bool columnsHomogeneous = false;
+    std::vector<protocol::ColumnType> columnTypes;
+
+    size_t Populated() const { return cells - nils; }
+    bool AllNumbers() const { return nums == cells; }
+    // Upper bound on the UTF-8 size of every string cell (3 bytes per unit).
+    size_t StrBytesUpperBound() const { return strUnits * 3; }
+};
+
+// Profiles the cells of `xMulti`. Returns false, with `out` left at zero
+// cells, when the dimensions are invalid or lparray is null. Runs of eight
+// cells in a row are classified together with AVX2 gathers over the XLOPER12
+// stride when the CPU supports it.
+bool ProfileGrid(const XLOPER12& xMulti, GridProfile& out);
+
+// Builder pre-sizing. A large conversion into a default builder otherwise
+// grows its buffer by realloc + copy many times over.
+//
+// EstimateSerializedSize returns an upper estimate of the bytes ConvertAny(op)
+// appends (arrays are profiled to find the encoding); ReserveBuilder makes
+// room for that many bytes in one allocation. It only sizes an empty builder
+// (fresh, Clear()ed or leased); one that already holds data grows as usual.
+// ConvertAnyPresized / ConvertGridPresized do both before converting; their
+// output is identical to ConvertAny / ConvertGrid.
+size_t EstimateSerializedSize(LPXLOPER12 op);
+void ReserveBuilder(flatbuffers::FlatBufferBuilder& builder, size_t bytes);
+flatbuffers::Offset<protocol::Any> ConvertAnyPresized(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder);
+flatbuffers::Offset<protocol::Grid> ConvertGridPresized(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder);
 
 // Helper for internal use (also exported if needed)
 flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& xMulti, flatbuffers::FlatBufferBuilder& builder);
+flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& xMulti, flatbuffers::FlatBufferBuilder& builder, StringInterner* interner);
 
 // A date cell's position RELATIVE to the anchor (caller top-left) plus the
 // number-format code to apply. Produced by CollectDateCells, consumed by the
@@ -57,6 +227,7 @@ struct DateCell {
 // Walks `any` and appends one DateCell per Date value:
 //   - scalar Date           -> {0,0}
 //   - Grid with Date cells   -> one entry per Date element at its (row,col)
+//   - NumGridEx / SparseGrid -> one entry per Date cell at its (row,col)
 //   - anything else          -> nothing (NumGrid/numeric/string carry no dates)
 // format = the Date.format field if non-empty, else auto from the serial's
 // fractional part: integer serial -> L"yyyy-mm-dd", else L"yyyy-mm-dd hh:mm:ss".
@@ -1,7 +1,12 @@
 #pragma once
 #include <windows.h>
 #include "types/xlcall.h"
+#include "types/ObjectPool.h"
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <thread>
+#include <vector>
 
 // Signature for Excel-callback functions exported by the XLL.
 // Excel resolves these symbols by literal name from the PE export table,
@@ -25,6 +30,57 @@ LPXLOPER12 NewXLOPER12();
  */
 void ReleaseXLOPER12(LPXLOPER12 p);
 
+/**
+ * Allocates `n` XLOPER12s at once (e.g. an Excel12v argument list or per-cell
+ * temporaries), each initialized to empty like NewXLOPER12. Takes at most one
+ * pool lock instead of one per XLOPER12.
+ *
+ * @param out Receives the n pointers.
+ * @param n   Number of XLOPER12s.
+ */
+void NewXLOPER12Batch(LPXLOPER12* out, size_t n);
+
+/**
+ * Releases `n` XLOPER12s back to the pool without freeing their content
+ * (the batch counterpart of ReleaseXLOPER12; null entries are skipped).
+ *
+ * @param items XLOPER12s previously obtained from NewXLOPER12 /
+ *              NewXLOPER12Batch.
+ * @param n     Number of entries in `items`.
+ */
+void ReleaseXLOPER12Batch(LPXLOPER12 const* items, size_t n);
+
+/** The pool behind NewXLOPER12 / ReleaseXLOPER12. */
+typedef ObjectPool<XLOPER12> XLOPER12Pool;
+
+/**
+ * Sets how many idle XLOPER12s each pool shard keeps
+ * (XLOPER12Pool::kDefaultMaxPerShard by default); releases past that are
+ * freed instead of pooled.
+ */
+void SetXLOPER12PoolLimit(size_t maxPerShard);
+
+/**
+ * Frees pooled XLOPER12s until at most `targetBytes` stay idle in the shards.
+ *
+ * @return Number of XLOPER12s freed.
+ */
+size_t TrimXLOPER12Pool(size_t targetBytes = 0);
+
+/**
+ * Frees the pooled XLOPER12s of every shard unused for `idle` or longer.
+ * Meant for a timer or calculation-ended handler.
+ *
+ * @return Number of XLOPER12s freed.
+ */
+size_t TrimIdleXLOPER12Pool(std::chrono::milliseconds idle);
+
+/**
+ * @return Acquire/hit/miss/free counters and per-shard occupancy of the
+ *         XLOPER12 pool, for monitoring.
+ */
+XLOPER12Pool::Stats GetXLOPER12PoolStats();
+
 /**
  * Creates an XLOPER12 String (Pascal-style wide string) managed by the DLL.
  *
@@ -37,24 +93,329 @@ void ReleaseXLOPER12(LPXLOPER12 p);
 LPXLOPER12 NewExcelString(const std::wstring& str);
 
 /**
- * Creates an FP12 array managed by a ring buffer (valid for return to Excel).
+ * Creates an FP12 array from the calling thread's FP12 arena (valid for
+ * return to Excel).
+ *
+ * The arena rotates through 8 buffers per thread, so the pointer stays valid
+ * until the same thread has called NewFP12 8 more times. Buffers are reused
+ * across calls; one that is oversized for the current request (above the
+ * per-slot share of SetFP12ArenaLimit) is released when its slot comes round
+ * again, so a one-off huge grid is not pinned for the thread's lifetime.
  *
  * @note FP12 is used with the "K%" type. Excel copies the data, so it only
  *       needs to persist until return.
  *
  * @param rows Number of rows.
  * @param cols Number of columns.
- * @return Pointer to a ring-buffer-managed FP12 array.
+ * @return Pointer to an arena-managed FP12 array.
+ * @throws std::bad_alloc on negative or overflowing dimensions.
  */
 FP12* NewFP12(int rows, int cols);
 
+/** Default per-thread retention limit of the FP12 arena (1 MiB). */
+const size_t kDefaultFP12RetainedBytes = 1 << 20;
+
+/**
+ * Sets how many bytes of FP12 buffers a thread keeps for reuse. A buffer
+ * larger than limit / 8 and more than twice the size of the request that
+ * next lands in its slot is freed instead of reused. Live FP12s are never
+ * freed early, so a thread may hold more while returning large grids.
+ *
+ * The limit is applied as each slot comes round again, so a thread that makes
+ * no further NewFP12 calls keeps what it holds; RequestFP12ArenaTrim frees
+ * such threads' buffers at once.
+ */
+void SetFP12ArenaLimit(size_t maxRetainedBytesPerThread);
+
+/**
+ * Debug mode: buffers are never reused. A retired FP12 is poisoned (rows and
+ * columns -1, signaling-NaN values) and quarantined (last 64 per thread), so
+ * reads through a stale pointer are visible and CheckFP12 reports it. Costs
+ * one allocation per NewFP12; meant for tests and debug builds.
+ */
+void SetFP12DebugChecks(bool enabled);
+
+/** Result of CheckFP12. */
+enum class FP12State {
+    Live,    // one of the calling thread's last 8 NewFP12 results
+    Stale,   // retired and still quarantined (debug mode only)
+    Unknown, // not from this thread's arena, or retired and since freed
+};
+
+/**
+ * Classifies `fp` against the calling thread's FP12 arena. Only pointer
+ * identity is compared; `fp` is never dereferenced. Without debug mode a
+ * buffer is reused in place, so a stale pointer can read as Live.
+ *
+ * @param fp         Pointer previously returned by NewFP12.
+ * @param generation Optional; receives the NewFP12 call number (1-based, per
+ *                   thread) that produced `fp` when it is Live or Stale.
+ */
+FP12State CheckFP12(const FP12* fp, uint64_t* generation = nullptr);
+
+/**
+ * Frees every FP12 buffer of the calling thread. Any FP12 it returned
+ * earlier becomes invalid.
+ */
+void TrimFP12Arena();
+
+/**
+ * Frees the FP12 buffers of every thread, including idle ones, from the
+ * calling thread. A thread that is inside NewFP12 at that moment trims its
+ * arena at the start of its next call instead. Every FP12 returned before the
+ * call becomes invalid, so call it only when no calculation is running (e.g.
+ * from a calculation-ended handler).
+ */
+void RequestFP12ArenaTrim();
+
+/** FP12 arena counters for one thread (see GetFP12ArenaStats). */
+struct FP12ArenaStats {
+    std::thread::id thread;
+    size_t retainedBytes = 0; // buffer bytes held: live, reusable and quarantined
+    size_t liveBytes = 0;     // bytes of the FP12s still inside the 8-call window
+    size_t allocations = 0;   // buffers allocated
+    size_t reuses = 0;        // NewFP12 calls served from a kept buffer
+    size_t trims = 0;         // TrimFP12Arena / RequestFP12ArenaTrim passes
+    uint64_t generation = 0;  // NewFP12 calls made by the thread
+};
+
+/**
+ * @return The calling thread's FP12 arena counters.
+ */
+FP12ArenaStats GetFP12ArenaStats();
+
+/**
+ * @return One entry per thread that has used NewFP12 and is still running.
+ *         Counters of other threads are read without stopping them, so each
+ *         is individually current but the set is not a single snapshot.
+ */
+std::vector<FP12ArenaStats> GetAllFP12ArenaStats();
+
+/**
+ * Allocates a single block holding an xltypeMulti element array of `count`
+ * zeroed XLOPER12s followed by `extraBytes` of payload (the Pascal string
+ * bodies the elements point at). A 32-byte header in front of the elements
+ * tags the block and holds its size.
+ *
+ * FreeDllOwnedContents recognizes a slab by its element pointer (without a
+ * lock, and without reading in front of arrays it did not allocate) and
+ * releases the whole block with one deallocation, before any element walk.
+ * While the XLOPER12 arena is enabled (EnableXlArena) the block is carved
+ * from the calling thread's arena chunk instead of the heap. Elements must
+ * therefore NOT carry xlbitDLLFree on their strings: the bodies belong to the
+ * slab, not to the element.
+ *
+ * @param count      Number of elements.
+ * @param extraBytes Payload bytes placed directly after the elements.
+ * @return The element array (payload starts at `array + count`).
+ * @throws std::bad_alloc on overflow or allocation failure.
+ */
+XLOPER12* NewXLOPER12Slab(size_t count, size_t extraBytes);
+
+/**
+ * Allocates an uninitialized `new XLOPER12[count]` element array for an
+ * xltypeMulti result (counted as a Multi payload by GetMemStats). Released by
+ * FreeDllOwnedContents / xlAutoFree12, or FreeXLOPER12Array.
+ *
+ * @throws std::bad_alloc on allocation failure.
+ */
+XLOPER12* NewXLOPER12Array(size_t count);
+
+/**
+ * Frees an array from NewXLOPER12Array without looking at its elements (for
+ * cleanup paths whose elements may be uninitialized). Null is ignored.
+ *
+ * @param count The count it was allocated with.
+ */
+void FreeXLOPER12Array(XLOPER12* array, size_t count);
+
+/**
+ * Allocates a buffer of `units` XCHARs for an xltypeStr body.
+ *
+ * With the arena enabled the buffer comes from the calling thread's arena
+ * chunk and is registered. Otherwise buffers of up to 256 units come from the
+ * Pascal string slab (size classes of 16/32/64/128/256 XCHARs with per-thread
+ * free lists) and larger ones are heap blocks with a 32-byte size header.
+ * Release the result with
+ * FreeExcelStringBuffer, or let FreeDllOwnedContents / xlAutoFree12 do it.
+ *
+ * @param units Buffer length in XCHARs (see WritePascalWBufferLen).
+ * @return Uninitialized buffer.
+ * @throws std::bad_alloc on allocation failure.
+ */
+XCHAR* NewExcelStringBuffer(size_t units);
+
+/**
+ * Releases a buffer from NewExcelStringBuffer on any thread: back to the slab
+ * or the arena, else delete[]. Null is ignored.
+ */
+void FreeExcelStringBuffer(XCHAR* p);
+
+/** Pascal string slab occupancy (see GetExcelStringSlabStats). */
+struct ExcelStringSlabStats {
+    size_t pages = 0;              // 64 KiB slab pages, kept for the process lifetime
+    size_t reservedBytes = 0;      // pages * 64 KiB
+    size_t freeBlocks = 0;         // blocks on the shared free lists
+    size_t threadCachedBlocks = 0; // blocks cached by the calling thread
+};
+
+/**
+ * @return Slab page and free-list counts.
+ */
+ExcelStringSlabStats GetExcelStringSlabStats();
+
+/**
+ * Allocates an XLMREF12 with room for `refs` rectangles (count and rectangles
+ * uninitialized), from the arena when enabled. Otherwise a single-rect
+ * XLMREF12 is a block of the string slab (no heap allocation) and larger ones
+ * come from `new char[]`, sized exactly (XLMREF12 already holds one XLREF12).
+ * Released by FreeDllOwnedContents / xlAutoFree12 like NewExcelStringBuffer.
+ *
+ * @param refs Number of XLREF12 entries.
+ * @return Uninitialized XLMREF12.
+ * @throws std::bad_alloc on overflow or allocation failure.
+ */
+LPXLMREF12 NewXLMREF12(size_t refs);
+
+/**
+ * Enables the per-thread XLOPER12 payload arena.
+ *
+ * While enabled, the DLL-owned payloads of UDF return values (string bodies,
+ * XLMREF12 buffers, and the element arrays of every grid encoding) are
+ * bump-allocated from fixed-size chunks owned by the calling thread instead of
+ * one heap allocation each. Every chunk counts its outstanding results; a
+ * chunk is reused only after it has been retired (full, a new recalc epoch
+ * began, or its thread exited) AND Excel has called xlAutoFree12 on every
+ * result carved from it. Payloads larger than a chunk get a heap block of
+ * their own, counted as a dedicated chunk.
+ *
+ * Allocation takes no lock unless the thread needs a new chunk, and a free
+ * finds its chunk by masking the payload address (chunks are aligned to their
+ * size), so only chunk changes go through the arena lock.
+ *
+ * The XLOPER12 structs themselves still come from the object pool.
+ *
+ * @note Payloads already handed out keep working after Disable / re-Enable.
+ *       Calling this again changes the chunk size for chunks made afterwards.
+ *
+ * @param chunkBytes    Chunk size (rounded up to a power of two, minimum 4 KiB).
+ * @param maxFreeChunks Drained chunks kept for reuse; the rest are freed.
+ */
+void EnableXlArena(size_t chunkBytes = 1 << 20, size_t maxFreeChunks = 8);
+
+/**
+ * Disables the arena: new payloads come from the heap again and the free
+ * chunks are released, as is the caller's current chunk once drained. Chunks
+ * with outstanding results are freed as those results are; other threads'
+ * current chunks are freed when those threads exit.
+ */
+void DisableXlArena();
+
+/**
+ * @return True while the arena is enabled.
+ */
+bool XlArenaEnabled();
+
+/**
+ * Starts a new recalculation epoch, typically from a calculation-event
+ * handler. Each thread's current chunk is retired (the caller's immediately,
+ * other threads' on their next allocation), so chunks never mix results from
+ * two recalcs and are recycled once that recalc's results are freed.
+ */
+void XlArenaBeginEpoch();
+
+/**
+ * Frees the drained chunks kept for reuse.
+ */
+void XlArenaTrim();
+
+/** Arena occupancy counters (see GetXlArenaStats). */
+struct XlArenaStats {
+    size_t chunks = 0;        // chunks allocated, including free ones
+    size_t freeChunks = 0;    // drained chunks kept for reuse
+    size_t reservedBytes = 0; // bytes held by all chunks
+    size_t liveResults = 0;   // payloads not yet freed by xlAutoFree12
+    size_t liveBytes = 0;     // bytes of those payloads
+    size_t recycled = 0;      // chunks returned to the free list
+    size_t epochs = 0;        // XlArenaBeginEpoch calls
+};
+
+/**
+ * @return The arena counters. Chunk counts are read under the arena lock;
+ *         live results of chunks other threads are still filling are read
+ *         without stopping them.
+ */
+XlArenaStats GetXlArenaStats();
+
+/**
+ * Payload kinds tracked by GetMemStats: pooled XLOPER12 structs handed out by
+ * NewXLOPER12, string buffers, xltypeMulti element arrays (heap and slab),
+ * XLMREF12 buffers, and FP12 results inside their validity window.
+ */
+enum class MemKind { XLOPER12, Str, Multi, Ref, FP12 };
+const size_t kMemKinds = 5;
+
+/** @return "xloper12", "str", "multi", "ref" or "fp12". */
+const char* MemKindName(MemKind kind);
+
+/** Live-memory counters for one MemKind. */
+struct MemKindStats {
+    int64_t liveObjects = 0;  // allocated and not yet freed
+    int64_t liveBytes = 0;
+    int64_t peakObjects = 0;  // highest liveObjects since start / ResetMemStatsPeaks
+    int64_t peakBytes = 0;
+    uint64_t allocations = 0; // cumulative
+    uint64_t frees = 0;       // cumulative
+};
+
+/** Snapshot returned by GetMemStats. */
+struct MemStats {
+    bool enabled = false; // built with TYPES_MEM_STATS; all counters are 0 otherwise
+    std::chrono::steady_clock::time_point taken;
+    MemKindStats kinds[kMemKinds];
+
+    const MemKindStats& operator[](MemKind kind) const { return kinds[(size_t)kind]; }
+};
+
+/**
+ * Snapshot of the live objects and bytes per payload kind, for leak hunting
+ * and pool sizing from telemetry.
+ *
+ * Accounting is compiled in only when the library is built with
+ * TYPES_MEM_STATS (CMake option XLLGEN_TYPES_MEM_STATS=ON); otherwise every
+ * hook is an empty inline function and `enabled` is false. When on, each
+ * thread counts into its own counters (plain stores, no shared cache line)
+ * and moves its net live change into shared totals every 64 objects or
+ * 256 KiB; this sums both. Live counts and totals are exact once the threads
+ * are quiet. A peak is exact for one thread and otherwise an estimate, high by
+ * at most one batch per thread.
+ *
+ * Allocations are counted in NewXLOPER12(Batch), NewExcelStringBuffer,
+ * NewXLOPER12Array / NewXLOPER12Slab, NewXLMREF12 and NewFP12. A heap
+ * string FreeDllOwnedContents did not allocate (e.g. a caller's new[] string
+ * tagged xlbitDLLFree) is freed but not counted. Element arrays and XLMREF12s
+ * are counted on free by their dimensions, so only hand xlAutoFree12 arrays
+ * from the allocators above.
+ */
+MemStats GetMemStats();
+
+/** Resets every peak to the current live value. */
+void ResetMemStatsPeaks();
+
+/**
+ * @return Allocations of `kind` per second between two snapshots (0 when
+ *         `later` is not after `earlier`).
+ */
+double AllocationsPerSecond(const MemStats& earlier, const MemStats& later, MemKind kind);
+
 /**
  * Frees ONLY the DLL-owned heap buffers hanging off an XLOPER12's value union
  * — the `xltypeStr` buffer, the `xltypeMulti` element strings plus the element
  * array, or the `xltypeRef` mref buffer. It does NOT release the XLOPER12 struct
  * itself (the pool / ReleaseXLOPER12 is the caller's job) and never touches
  * borrowed / Excel-owned pointers. Within a multi, an element string is freed
- * only when it carries `xlbitDLLFree` (our ownership marker).
+ * only when it carries `xlbitDLLFree` (our ownership marker). An element array
+ * from NewXLOPER12Slab is released as one block instead.
  *
  * This is the single definition of the ownership-critical free logic that used
  * to be copy-pasted between `xlAutoFree12` (mem.cpp) and the `GridToXLOPER12`
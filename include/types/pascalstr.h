@@ -19,7 +19,8 @@
 // `kMaxExcelStringLen` is the hard Excel limit. A length of exactly 32767 is
 // LEGAL and is copied through verbatim; only 32768+ is clamped.
 //
-// `WritePascalWString` is the ONE place that encodes this layout. Every call
+// `WritePascalWString` is the ONE place that encodes this layout (in-place
+// producers finish with `StampPascalWString`, which it shares). Every call
 // site is responsible for allocating a buffer of AT LEAST
 // `WritePascalWBufferLen(srcLen)` XCHARs and keeps its own ownership /
 // free strategy — this helper never allocates and never frees.
@@ -42,6 +43,18 @@ inline size_t WritePascalWBufferLen(size_t srcLen) {
     return ClampExcelStringLen(srcLen) + 2; // [0]=len prefix, body, trailing NUL
 }
 
+// Stamp the length prefix and trailing NUL around a body that a producer has
+// already written in place at dst[1 .. len] (e.g. a transcoder decoding
+// straight into the final buffer). Same clamp and layout as WritePascalWString;
+// `dst` must hold at least `WritePascalWBufferLen(len)` XCHARs. Returns the
+// clamped length.
+inline size_t StampPascalWString(XCHAR* dst, size_t len) {
+    size_t clampedLen = ClampExcelStringLen(len);
+    dst[0] = (XCHAR)clampedLen;
+    dst[clampedLen + 1] = 0; // trailing NUL (safety; not required by Excel)
+    return clampedLen;
+}
+
 // Encode `src[0 .. len)` into the Excel Pascal wide-string `dst`.
 //
 //   - clamps `len` to kMaxExcelStringLen (32767); a `len` of exactly 32767 is
@@ -59,10 +72,8 @@ inline size_t WritePascalWBufferLen(size_t srcLen) {
 // UTF-16 code units — `len` is a code-unit count, exactly as Excel expects.
 inline size_t WritePascalWString(XCHAR* dst, const XCHAR* src, size_t len) {
     size_t clampedLen = ClampExcelStringLen(len);
-    dst[0] = (XCHAR)clampedLen;
     if (clampedLen > 0) {
         std::memcpy(dst + 1, src, clampedLen * sizeof(XCHAR));
     }
-    dst[clampedLen + 1] = 0; // trailing NUL (safety; not required by Excel)
-    return clampedLen;
+    return StampPascalWString(dst, clampedLen);
 }
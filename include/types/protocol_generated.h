@@ -56,6 +56,18 @@ struct GridBuilder;
 struct NumGrid;
 struct NumGridBuilder;
 
+struct NumGridEx;
+struct NumGridExBuilder;
+
+struct SparseGrid;
+struct SparseGridBuilder;
+
+struct Column;
+struct ColumnBuilder;
+
+struct ColumnGrid;
+struct ColumnGridBuilder;
+
 struct Any;
 struct AnyBuilder;
 
@@ -303,6 +315,45 @@ template<> struct ScalarValueTraits<protocol::Date> {
 bool VerifyScalarValue(::flatbuffers::Verifier &verifier, const void *obj, ScalarValue type);
 bool VerifyScalarValueVector(::flatbuffers::Verifier &verifier, const ::flatbuffers::Vector<::flatbuffers::Offset<void>> *values, const ::flatbuffers::Vector<ScalarValue> *types);
 
+enum class ColumnType : uint8_t {
+  Num = 0,
+  Int = 1,
+  Bool = 2,
+  Str = 3,
+  Err = 4,
+  MIN = Num,
+  MAX = Err
+};
+
+inline const ColumnType (&EnumValuesColumnType())[5] {
+  static const ColumnType values[] = {
+    ColumnType::Num,
+    ColumnType::Int,
+    ColumnType::Bool,
+    ColumnType::Str,
+    ColumnType::Err
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesColumnType() {
+  static const char * const names[6] = {
+    "Num",
+    "Int",
+    "Bool",
+    "Str",
+    "Err",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameColumnType(ColumnType e) {
+  if (::flatbuffers::IsOutRange(e, ColumnType::Num, ColumnType::Err)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesColumnType()[index];
+}
+
 enum class AnyValue : uint8_t {
   NONE = 0,
   Bool = 1,
@@ -317,11 +368,14 @@ enum class AnyValue : uint8_t {
   Range = 10,
   RefCache = 11,
   Date = 12,
+  ColumnGrid = 13,
+  NumGridEx = 14,
+  SparseGrid = 15,
   MIN = NONE,
-  MAX = Date
+  MAX = SparseGrid
 };
 
-inline const AnyValue (&EnumValuesAnyValue())[13] {
+inline const AnyValue (&EnumValuesAnyValue())[16] {
   static const AnyValue values[] = {
     AnyValue::NONE,
     AnyValue::Bool,
@@ -335,13 +389,16 @@ inline const AnyValue (&EnumValuesAnyValue())[13] {
     AnyValue::NumGrid,
     AnyValue::Range,
     AnyValue::RefCache,
-    AnyValue::Date
+    AnyValue::Date,
+    AnyValue::ColumnGrid,
+    AnyValue::NumGridEx,
+    AnyValue::SparseGrid
   };
   return values;
 }
 
 inline const char * const *EnumNamesAnyValue() {
-  static const char * const names[14] = {
+  static const char * const names[17] = {
     "NONE",
     "Bool",
     "Num",
@@ -355,13 +412,16 @@ inline const char * const *EnumNamesAnyValue() {
     "Range",
     "RefCache",
     "Date",
+    "ColumnGrid",
+    "NumGridEx",
+    "SparseGrid",
     nullptr
   };
   return names;
 }
 
 inline const char *EnumNameAnyValue(AnyValue e) {
-  if (::flatbuffers::IsOutRange(e, AnyValue::NONE, AnyValue::Date)) return "";
+  if (::flatbuffers::IsOutRange(e, AnyValue::NONE, AnyValue::SparseGrid)) return "";
   const size_t index = static_cast<size_t>(e);
   return EnumNamesAnyValue()[index];
 }
@@ -418,6 +478,18 @@ template<> struct AnyValueTraits<protocol::Date> {
   static const AnyValue enum_value = AnyValue::Date;
 };
 
+template<> struct AnyValueTraits<protocol::ColumnGrid> {
+  static const AnyValue enum_value = AnyValue::ColumnGrid;
+};
+
+template<> struct AnyValueTraits<protocol::NumGridEx> {
+  static const AnyValue enum_value = AnyValue::NumGridEx;
+};
+
+template<> struct AnyValueTraits<protocol::SparseGrid> {
+  static const AnyValue enum_value = AnyValue::SparseGrid;
+};
+
 bool VerifyAnyValue(::flatbuffers::Verifier &verifier, const void *obj, AnyValue type);
 bool VerifyAnyValueVector(::flatbuffers::Verifier &verifier, const ::flatbuffers::Vector<::flatbuffers::Offset<void>> *values, const ::flatbuffers::Vector<AnyValue> *types);
 
@@ -918,7 +990,8 @@ struct Range FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_SHEET_NAME = 4,
     VT_REFS = 6,
-    VT_FORMAT = 8
+    VT_FORMAT = 8,
+    VT_VALUES = 10
   };
   const ::flatbuffers::String *sheet_name() const {
     return GetPointer<const ::flatbuffers::String *>(VT_SHEET_NAME);
@@ -929,6 +1002,9 @@ struct Range FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const ::flatbuffers::String *format() const {
     return GetPointer<const ::flatbuffers::String *>(VT_FORMAT);
   }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Any>> *values() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Any>> *>(VT_VALUES);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_SHEET_NAME) &&
@@ -937,6 +1013,9 @@ struct Range FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
            verifier.VerifyVector(refs()) &&
            VerifyOffset(verifier, VT_FORMAT) &&
            verifier.VerifyString(format()) &&
+           VerifyOffset(verifier, VT_VALUES) &&
+           verifier.VerifyVector(values()) &&
+           verifier.VerifyVectorOfTables(values()) &&
            verifier.EndTable();
   }
 };
@@ -954,6 +1033,9 @@ struct RangeBuilder {
   void add_format(::flatbuffers::Offset<::flatbuffers::String> format) {
     fbb_.AddOffset(Range::VT_FORMAT, format);
   }
+  void add_values(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Any>>> values) {
+    fbb_.AddOffset(Range::VT_VALUES, values);
+  }
   explicit RangeBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -969,8 +1051,10 @@ inline ::flatbuffers::Offset<Range> CreateRange(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     ::flatbuffers::Offset<::flatbuffers::String> sheet_name = 0,
     ::flatbuffers::Offset<::flatbuffers::Vector<const protocol::Rect *>> refs = 0,
-    ::flatbuffers::Offset<::flatbuffers::String> format = 0) {
+    ::flatbuffers::Offset<::flatbuffers::String> format = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Any>>> values = 0) {
   RangeBuilder builder_(_fbb);
+  builder_.add_values(values);
   builder_.add_format(format);
   builder_.add_refs(refs);
   builder_.add_sheet_name(sheet_name);
@@ -981,15 +1065,18 @@ inline ::flatbuffers::Offset<Range> CreateRangeDirect(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     const char *sheet_name = nullptr,
     const std::vector<protocol::Rect> *refs = nullptr,
-    const char *format = nullptr) {
+    const char *format = nullptr,
+    const std::vector<::flatbuffers::Offset<protocol::Any>> *values = nullptr) {
   auto sheet_name__ = sheet_name ? _fbb.CreateString(sheet_name) : 0;
   auto refs__ = refs ? _fbb.CreateVectorOfStructs<protocol::Rect>(*refs) : 0;
   auto format__ = format ? _fbb.CreateString(format) : 0;
+  auto values__ = values ? _fbb.CreateVector<::flatbuffers::Offset<protocol::Any>>(*values) : 0;
   return protocol::CreateRange(
       _fbb,
       sheet_name__,
       refs__,
-      format__);
+      format__,
+      values__);
 }
 
 struct Scalar FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
@@ -1182,7 +1269,8 @@ struct NumGrid FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_ROWS = 4,
     VT_COLS = 6,
-    VT_DATA = 8
+    VT_DATA = 8,
+    VT_FP12 = 10
   };
   int32_t rows() const {
     return GetField<int32_t>(VT_ROWS, 0);
@@ -1193,12 +1281,17 @@ struct NumGrid FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const ::flatbuffers::Vector<double> *data() const {
     return GetPointer<const ::flatbuffers::Vector<double> *>(VT_DATA);
   }
+  const ::flatbuffers::Vector<uint8_t> *fp12() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_FP12);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<int32_t>(verifier, VT_ROWS, 4) &&
            VerifyField<int32_t>(verifier, VT_COLS, 4) &&
            VerifyOffset(verifier, VT_DATA) &&
            verifier.VerifyVector(data()) &&
+           VerifyOffset(verifier, VT_FP12) &&
+           verifier.VerifyVector(fp12()) &&
            verifier.EndTable();
   }
 };
@@ -1216,6 +1309,9 @@ struct NumGridBuilder {
   void add_data(::flatbuffers::Offset<::flatbuffers::Vector<double>> data) {
     fbb_.AddOffset(NumGrid::VT_DATA, data);
   }
+  void add_fp12(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> fp12) {
+    fbb_.AddOffset(NumGrid::VT_FP12, fp12);
+  }
   explicit NumGridBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -1231,8 +1327,10 @@ inline ::flatbuffers::Offset<NumGrid> CreateNumGrid(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     int32_t rows = 0,
     int32_t cols = 0,
-    ::flatbuffers::Offset<::flatbuffers::Vector<double>> data = 0) {
+    ::flatbuffers::Offset<::flatbuffers::Vector<double>> data = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> fp12 = 0) {
   NumGridBuilder builder_(_fbb);
+  builder_.add_fp12(fp12);
   builder_.add_data(data);
   builder_.add_cols(cols);
   builder_.add_rows(rows);
@@ -1243,13 +1341,421 @@ inline ::flatbuffers::Offset<NumGrid> CreateNumGridDirect(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     int32_t rows = 0,
     int32_t cols = 0,
-    const std::vector<double> *data = nullptr) {
+    const std::vector<double> *data = nullptr,
+    const std::vector<uint8_t> *fp12 = nullptr) {
   auto data__ = data ? _fbb.CreateVector<double>(*data) : 0;
+  if (fp12) { _fbb.ForceVectorAlignment(fp12->size(), sizeof(uint8_t), 8); }
+  auto fp12__ = fp12 ? _fbb.CreateVector<uint8_t>(*fp12) : 0;
   return protocol::CreateNumGrid(
       _fbb,
       rows,
       cols,
-      data__);
+      data__,
+      fp12__);
+}
+
+struct NumGridEx FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef NumGridExBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_ROWS = 4,
+    VT_COLS = 6,
+    VT_DATA = 8,
+    VT_EXC_INDEX = 10,
+    VT_EXC_VALUES = 12
+  };
+  int32_t rows() const {
+    return GetField<int32_t>(VT_ROWS, 0);
+  }
+  int32_t cols() const {
+    return GetField<int32_t>(VT_COLS, 0);
+  }
+  const ::flatbuffers::Vector<double> *data() const {
+    return GetPointer<const ::flatbuffers::Vector<double> *>(VT_DATA);
+  }
+  const ::flatbuffers::Vector<uint32_t> *exc_index() const {
+    return GetPointer<const ::flatbuffers::Vector<uint32_t> *>(VT_EXC_INDEX);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>> *exc_values() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>> *>(VT_EXC_VALUES);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_ROWS, 4) &&
+           VerifyField<int32_t>(verifier, VT_COLS, 4) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           VerifyOffset(verifier, VT_EXC_INDEX) &&
+           verifier.VerifyVector(exc_index()) &&
+           VerifyOffset(verifier, VT_EXC_VALUES) &&
+           verifier.VerifyVector(exc_values()) &&
+           verifier.VerifyVectorOfTables(exc_values()) &&
+           verifier.EndTable();
+  }
+};
+
+struct NumGridExBuilder {
+  typedef NumGridEx Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_rows(int32_t rows) {
+    fbb_.AddElement<int32_t>(NumGridEx::VT_ROWS, rows, 0);
+  }
+  void add_cols(int32_t cols) {
+    fbb_.AddElement<int32_t>(NumGridEx::VT_COLS, cols, 0);
+  }
+  void add_data(::flatbuffers::Offset<::flatbuffers::Vector<double>> data) {
+    fbb_.AddOffset(NumGridEx::VT_DATA, data);
+  }
+  void add_exc_index(::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> exc_index) {
+    fbb_.AddOffset(NumGridEx::VT_EXC_INDEX, exc_index);
+  }
+  void add_exc_values(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>>> exc_values) {
+    fbb_.AddOffset(NumGridEx::VT_EXC_VALUES, exc_values);
+  }
+  explicit NumGridExBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<NumGridEx> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<NumGridEx>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<NumGridEx> CreateNumGridEx(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<double>> data = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> exc_index = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>>> exc_values = 0) {
+  NumGridExBuilder builder_(_fbb);
+  builder_.add_exc_values(exc_values);
+  builder_.add_exc_index(exc_index);
+  builder_.add_data(data);
+  builder_.add_cols(cols);
+  builder_.add_rows(rows);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<NumGridEx> CreateNumGridExDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    const std::vector<double> *data = nullptr,
+    const std::vector<uint32_t> *exc_index = nullptr,
+    const std::vector<::flatbuffers::Offset<protocol::Scalar>> *exc_values = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<double>(*data) : 0;
+  auto exc_index__ = exc_index ? _fbb.CreateVector<uint32_t>(*exc_index) : 0;
+  auto exc_values__ = exc_values ? _fbb.CreateVector<::flatbuffers::Offset<protocol::Scalar>>(*exc_values) : 0;
+  return protocol::CreateNumGridEx(
+      _fbb,
+      rows,
+      cols,
+      data__,
+      exc_index__,
+      exc_values__);
+}
+
+struct SparseGrid FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef SparseGridBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_ROWS = 4,
+    VT_COLS = 6,
+    VT_INDEX = 8,
+    VT_VALUES = 10
+  };
+  int32_t rows() const {
+    return GetField<int32_t>(VT_ROWS, 0);
+  }
+  int32_t cols() const {
+    return GetField<int32_t>(VT_COLS, 0);
+  }
+  const ::flatbuffers::Vector<uint32_t> *index() const {
+    return GetPointer<const ::flatbuffers::Vector<uint32_t> *>(VT_INDEX);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>> *values() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>> *>(VT_VALUES);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_ROWS, 4) &&
+           VerifyField<int32_t>(verifier, VT_COLS, 4) &&
+           VerifyOffset(verifier, VT_INDEX) &&
+           verifier.VerifyVector(index()) &&
+           VerifyOffset(verifier, VT_VALUES) &&
+           verifier.VerifyVector(values()) &&
+           verifier.VerifyVectorOfTables(values()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SparseGridBuilder {
+  typedef SparseGrid Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_rows(int32_t rows) {
+    fbb_.AddElement<int32_t>(SparseGrid::VT_ROWS, rows, 0);
+  }
+  void add_cols(int32_t cols) {
+    fbb_.AddElement<int32_t>(SparseGrid::VT_COLS, cols, 0);
+  }
+  void add_index(::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> index) {
+    fbb_.AddOffset(SparseGrid::VT_INDEX, index);
+  }
+  void add_values(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>>> values) {
+    fbb_.AddOffset(SparseGrid::VT_VALUES, values);
+  }
+  explicit SparseGridBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<SparseGrid> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<SparseGrid>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<SparseGrid> CreateSparseGrid(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> index = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Scalar>>> values = 0) {
+  SparseGridBuilder builder_(_fbb);
+  builder_.add_values(values);
+  builder_.add_index(index);
+  builder_.add_cols(cols);
+  builder_.add_rows(rows);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<SparseGrid> CreateSparseGridDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    const std::vector<uint32_t> *index = nullptr,
+    const std::vector<::flatbuffers::Offset<protocol::Scalar>> *values = nullptr) {
+  auto index__ = index ? _fbb.CreateVector<uint32_t>(*index) : 0;
+  auto values__ = values ? _fbb.CreateVector<::flatbuffers::Offset<protocol::Scalar>>(*values) : 0;
+  return protocol::CreateSparseGrid(
+      _fbb,
+      rows,
+      cols,
+      index__,
+      values__);
+}
+
+struct Column FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef ColumnBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_TYPE = 4,
+    VT_NULLS = 6,
+    VT_NUMS = 8,
+    VT_INTS = 10,
+    VT_BOOLS = 12,
+    VT_STRS = 14,
+    VT_ERRS = 16
+  };
+  protocol::ColumnType type() const {
+    return static_cast<protocol::ColumnType>(GetField<uint8_t>(VT_TYPE, 0));
+  }
+  const ::flatbuffers::Vector<uint8_t> *nulls() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_NULLS);
+  }
+  const ::flatbuffers::Vector<double> *nums() const {
+    return GetPointer<const ::flatbuffers::Vector<double> *>(VT_NUMS);
+  }
+  const ::flatbuffers::Vector<int32_t> *ints() const {
+    return GetPointer<const ::flatbuffers::Vector<int32_t> *>(VT_INTS);
+  }
+  const ::flatbuffers::Vector<uint8_t> *bools() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_BOOLS);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::String>> *strs() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::String>> *>(VT_STRS);
+  }
+  const ::flatbuffers::Vector<int16_t> *errs() const {
+    return GetPointer<const ::flatbuffers::Vector<int16_t> *>(VT_ERRS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint8_t>(verifier, VT_TYPE, 1) &&
+           VerifyOffset(verifier, VT_NULLS) &&
+           verifier.VerifyVector(nulls()) &&
+           VerifyOffset(verifier, VT_NUMS) &&
+           verifier.VerifyVector(nums()) &&
+           VerifyOffset(verifier, VT_INTS) &&
+           verifier.VerifyVector(ints()) &&
+           VerifyOffset(verifier, VT_BOOLS) &&
+           verifier.VerifyVector(bools()) &&
+           VerifyOffset(verifier, VT_STRS) &&
+           verifier.VerifyVector(strs()) &&
+           verifier.VerifyVectorOfStrings(strs()) &&
+           VerifyOffset(verifier, VT_ERRS) &&
+           verifier.VerifyVector(errs()) &&
+           verifier.EndTable();
+  }
+};
+
+struct ColumnBuilder {
+  typedef Column Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_type(protocol::ColumnType type) {
+    fbb_.AddElement<uint8_t>(Column::VT_TYPE, static_cast<uint8_t>(type), 0);
+  }
+  void add_nulls(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> nulls) {
+    fbb_.AddOffset(Column::VT_NULLS, nulls);
+  }
+  void add_nums(::flatbuffers::Offset<::flatbuffers::Vector<double>> nums) {
+    fbb_.AddOffset(Column::VT_NUMS, nums);
+  }
+  void add_ints(::flatbuffers::Offset<::flatbuffers::Vector<int32_t>> ints) {
+    fbb_.AddOffset(Column::VT_INTS, ints);
+  }
+  void add_bools(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> bools) {
+    fbb_.AddOffset(Column::VT_BOOLS, bools);
+  }
+  void add_strs(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::String>>> strs) {
+    fbb_.AddOffset(Column::VT_STRS, strs);
+  }
+  void add_errs(::flatbuffers::Offset<::flatbuffers::Vector<int16_t>> errs) {
+    fbb_.AddOffset(Column::VT_ERRS, errs);
+  }
+  explicit ColumnBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Column> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Column>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Column> CreateColumn(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    protocol::ColumnType type = protocol::ColumnType::Num,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> nulls = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<double>> nums = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<int32_t>> ints = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> bools = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<::flatbuffers::String>>> strs = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<int16_t>> errs = 0) {
+  ColumnBuilder builder_(_fbb);
+  builder_.add_errs(errs);
+  builder_.add_strs(strs);
+  builder_.add_bools(bools);
+  builder_.add_ints(ints);
+  builder_.add_nums(nums);
+  builder_.add_nulls(nulls);
+  builder_.add_type(type);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Column> CreateColumnDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    protocol::ColumnType type = protocol::ColumnType::Num,
+    const std::vector<uint8_t> *nulls = nullptr,
+    const std::vector<double> *nums = nullptr,
+    const std::vector<int32_t> *ints = nullptr,
+    const std::vector<uint8_t> *bools = nullptr,
+    const std::vector<::flatbuffers::Offset<::flatbuffers::String>> *strs = nullptr,
+    const std::vector<int16_t> *errs = nullptr) {
+  auto nulls__ = nulls ? _fbb.CreateVector<uint8_t>(*nulls) : 0;
+  auto nums__ = nums ? _fbb.CreateVector<double>(*nums) : 0;
+  auto ints__ = ints ? _fbb.CreateVector<int32_t>(*ints) : 0;
+  auto bools__ = bools ? _fbb.CreateVector<uint8_t>(*bools) : 0;
+  auto strs__ = strs ? _fbb.CreateVector<::flatbuffers::Offset<::flatbuffers::String>>(*strs) : 0;
+  auto errs__ = errs ? _fbb.CreateVector<int16_t>(*errs) : 0;
+  return protocol::CreateColumn(
+      _fbb,
+      type,
+      nulls__,
+      nums__,
+      ints__,
+      bools__,
+      strs__,
+      errs__);
+}
+
+struct ColumnGrid FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef ColumnGridBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_ROWS = 4,
+    VT_COLS = 6,
+    VT_COLUMNS = 8
+  };
+  int32_t rows() const {
+    return GetField<int32_t>(VT_ROWS, 0);
+  }
+  int32_t cols() const {
+    return GetField<int32_t>(VT_COLS, 0);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Column>> *columns() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<protocol::Column>> *>(VT_COLUMNS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_ROWS, 4) &&
+           VerifyField<int32_t>(verifier, VT_COLS, 4) &&
+           VerifyOffset(verifier, VT_COLUMNS) &&
+           verifier.VerifyVector(columns()) &&
+           verifier.VerifyVectorOfTables(columns()) &&
+           verifier.EndTable();
+  }
+};
+
+struct ColumnGridBuilder {
+  typedef ColumnGrid Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_rows(int32_t rows) {
+    fbb_.AddElement<int32_t>(ColumnGrid::VT_ROWS, rows, 0);
+  }
+  void add_cols(int32_t cols) {
+    fbb_.AddElement<int32_t>(ColumnGrid::VT_COLS, cols, 0);
+  }
+  void add_columns(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Column>>> columns) {
+    fbb_.AddOffset(ColumnGrid::VT_COLUMNS, columns);
+  }
+  explicit ColumnGridBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<ColumnGrid> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<ColumnGrid>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<ColumnGrid> CreateColumnGrid(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<protocol::Column>>> columns = 0) {
+  ColumnGridBuilder builder_(_fbb);
+  builder_.add_columns(columns);
+  builder_.add_cols(cols);
+  builder_.add_rows(rows);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<ColumnGrid> CreateColumnGridDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t rows = 0,
+    int32_t cols = 0,
+    const std::vector<::flatbuffers::Offset<protocol::Column>> *columns = nullptr) {
+  auto columns__ = columns ? _fbb.CreateVector<::flatbuffers::Offset<protocol::Column>>(*columns) : 0;
+  return protocol::CreateColumnGrid(
+      _fbb,
+      rows,
+      cols,
+      columns__);
 }
 
 struct Any FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
@@ -1301,6 +1807,15 @@ struct Any FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const protocol::Date *val_as_Date() const {
     return val_type() == protocol::AnyValue::Date ? static_cast<const protocol::Date *>(val()) : nullptr;
   }
+  const protocol::ColumnGrid *val_as_ColumnGrid() const {
+    return val_type() == protocol::AnyValue::ColumnGrid ? static_cast<const protocol::ColumnGrid *>(val()) : nullptr;
+  }
+  const protocol::NumGridEx *val_as_NumGridEx() const {
+    return val_type() == protocol::AnyValue::NumGridEx ? static_cast<const protocol::NumGridEx *>(val()) : nullptr;
+  }
+  const protocol::SparseGrid *val_as_SparseGrid() const {
+    return val_type() == protocol::AnyValue::SparseGrid ? static_cast<const protocol::SparseGrid *>(val()) : nullptr;
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint8_t>(verifier, VT_VAL_TYPE, 1) &&
@@ -1358,6 +1873,18 @@ template<> inline const protocol::Date *Any::val_as<protocol::Date>() const {
   return val_as_Date();
 }
 
+template<> inline const protocol::ColumnGrid *Any::val_as<protocol::ColumnGrid>() const {
+  return val_as_ColumnGrid();
+}
+
+template<> inline const protocol::NumGridEx *Any::val_as<protocol::NumGridEx>() const {
+  return val_as_NumGridEx();
+}
+
+template<> inline const protocol::SparseGrid *Any::val_as<protocol::SparseGrid>() const {
+  return val_as_SparseGrid();
+}
+
 struct AnyBuilder {
   typedef Any Table;
   ::flatbuffers::FlatBufferBuilder &fbb_;
@@ -2530,6 +3057,18 @@ inline bool VerifyAnyValue(::flatbuffers::Verifier &verifier, const void *obj, A
       auto ptr = reinterpret_cast<const protocol::Date *>(obj);
       return verifier.VerifyTable(ptr);
     }
+    case AnyValue::ColumnGrid: {
+      auto ptr = reinterpret_cast<const protocol::ColumnGrid *>(obj);
+      return verifier.VerifyTable(ptr);
+    }
+    case AnyValue::NumGridEx: {
+      auto ptr = reinterpret_cast<const protocol::NumGridEx *>(obj);
+      return verifier.VerifyTable(ptr);
+    }
+    case AnyValue::SparseGrid: {
+      auto ptr = reinterpret_cast<const protocol::SparseGrid *>(obj);
+      return verifier.VerifyTable(ptr);
+    }
     default: return true;
   }
 }
@@ -0,0 +1,75 @@
+#pragma once
+#include <windows.h>
+#include "types/xlcall.h"
+#include <cstddef>
+
+// =============================================================================
+// Built-in UTF-16 <-> UTF-8 transcoding for the Excel <-> FlatBuffers hot path.
+// =============================================================================
+//
+// Excel hands us UTF-16 (XCHAR) Pascal strings; FlatBuffers stores UTF-8. The
+// Win32 route (WideCharToMultiByte / MultiByteToWideChar) needs one call to size
+// and a second to convert, and cannot write into caller memory whose size is
+// only an upper bound. These kernels transcode in a single pass into a
+// caller-provided buffer sized by an upper bound, with an SSE2/AVX2 all-ASCII
+// fast path (tickers, ISINs, codes) and a scalar path for everything else.
+//
+// Error handling matches the Win32 CP_UTF8 conversions (flags 0): an unpaired
+// surrogate or ill-formed UTF-8 sequence is replaced by U+FFFD. Output is never
+// NUL-terminated; the returned count is authoritative.
+
+/**
+ * Upper bound on the UTF-8 bytes produced from `len` UTF-16 code units.
+ *
+ * Every code unit yields at most 3 bytes (a BMP character, or U+FFFD for a lone
+ * surrogate); a surrogate pair is 2 units -> 4 bytes, which is below the bound.
+ *
+ * @param len Number of UTF-16 code units.
+ * @return Worst-case UTF-8 byte count (3 * len).
+ */
+inline size_t Utf8MaxBytesForUtf16(size_t len) {
+    return len * 3;
+}
+
+/**
+ * Transcodes UTF-16 to UTF-8 in one pass.
+ *
+ * @param src UTF-16 code units (may be null only when `len` is 0).
+ * @param len Number of code units in `src`.
+ * @param dst Destination with room for at least Utf8MaxBytesForUtf16(len) bytes.
+ * @return Number of bytes written to `dst`.
+ */
+size_t Utf16ToUtf8(const XCHAR* src, size_t len, char* dst);
+
+/**
+ * Exact number of UTF-8 bytes Utf16ToUtf8 would write for `src[0 .. len)`.
+ *
+ * @param src UTF-16 code units (may be null only when `len` is 0).
+ * @param len Number of code units in `src`.
+ * @return UTF-8 byte count.
+ */
+size_t Utf8LengthOfUtf16(const XCHAR* src, size_t len);
+
+/**
+ * Transcodes UTF-8 to UTF-16 in one pass, stopping once `dstCap` code units
+ * have been written.
+ *
+ * Validation, counting and widening happen in the same pass, so callers can
+ * decode straight into their final buffer (e.g. the body of a Pascal string)
+ * sized by the bound below. Ill-formed input is replaced by U+FFFD, one per
+ * maximal ill-formed subpart (the Unicode "best practice" policy): overlongs,
+ * encoded surrogates, values above U+10FFFF and truncated sequences never
+ * reach the output. When only one unit of room is left for a supplementary
+ * character, its high surrogate is written and decoding stops -- the same
+ * code-unit truncation the Pascal clamp applies everywhere else.
+ *
+ * Output is never NUL-terminated. A UTF-8 byte never yields more than one
+ * UTF-16 unit, so `len` units always suffice for the whole input.
+ *
+ * @param src    UTF-8 bytes (may be null only when `len` is 0).
+ * @param len    Number of bytes in `src`.
+ * @param dst    Destination with room for `dstCap` code units.
+ * @param dstCap Maximum number of code units to write.
+ * @return Number of code units written to `dst`.
+ */
+size_t Utf8ToUtf16(const char* src, size_t len, XCHAR* dst, size_t dstCap);
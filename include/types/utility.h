@@ -20,6 +20,10 @@ std::wstring ConvertToWString(const char* str);
 std::wstring PascalToWString(const wchar_t* pstr);
 std::string ConvertExcelString(const wchar_t* wstr);
 void Utf8ToExcelString(const char* utf8, XCHAR*& outStr);
+// Same decode into a NewExcelStringBuffer buffer (slab-backed when short);
+// free it with FreeExcelStringBuffer or through xlAutoFree12. Utf8ToExcelString
+// keeps returning a caller-owned new[] buffer.
+XCHAR* Utf8ToExcelStringBuffer(const char* utf8);
 
 // Cell Helper
 bool IsSingleCell(LPXLOPER12 pxRef);
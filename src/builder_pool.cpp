@@ -0,0 +1,87 @@
+#include "types/BuilderPool.h"
+#include "types/StringInterner.h"
+
+BuilderPool::Lease::Lease(BuilderPool* pool, std::unique_ptr<flatbuffers::FlatBufferBuilder> builder,
+                          std::unique_ptr<StringInterner> interner)
+    : pool_(pool), builder_(std::move(builder)), interner_(std::move(interner)) {}
+
+BuilderPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), builder_(std::move(other.builder_)), interner_(std::move(other.interner_)) {
+    other.pool_ = nullptr;
+}
+
+BuilderPool::Lease& BuilderPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Release();
+        pool_ = other.pool_;
+        builder_ = std::move(other.builder_);
+        interner_ = std::move(other.interner_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+BuilderPool::Lease::~Lease() {
+    Release();
+}
+
+StringInterner& BuilderPool::Lease::Interner() {
+    if (!interner_) interner_.reset(new StringInterner());
+    return *interner_;
+}
+
+void BuilderPool::Lease::Release() {
+    if (builder_ && pool_) pool_->Return(std::move(builder_), std::move(interner_));
+    builder_.reset();
+    interner_.reset();
+    pool_ = nullptr;
+}
+
+BuilderPool::~BuilderPool() = default;
+
+BuilderPool& BuilderPool::ThreadLocal() {
+    thread_local BuilderPool pool;
+    return pool;
+}
+
+BuilderPool::Lease BuilderPool::Acquire() {
+    ++acquires_;
+    if (!idle_.empty()) {
+        IdleEntry entry = std::move(idle_.back());
+        idle_.pop_back();
+        ++reuses_;
+        return Lease(this, std::move(entry.builder), std::move(entry.interner));
+    }
+    return Lease(this,
+                 std::unique_ptr<flatbuffers::FlatBufferBuilder>(new flatbuffers::FlatBufferBuilder(kInitialBuilderSize)),
+                 nullptr);
+}
+
+void BuilderPool::Return(std::unique_ptr<flatbuffers::FlatBufferBuilder> builder,
+                         std::unique_ptr<StringInterner> interner) {
+    // The builder API exposes no capacity, so retention goes by what this
+    // lease wrote. A buffer grows by at most half again to fit its contents,
+    // so a kept buffer stays within about twice the limit unless a lease
+    // reserved (ReserveBuilder) far more than it then wrote.
+    const size_t used = builder->GetSize();
+    if (used > maxRetainedBytes_) {
+        ++trimmed_;
+        return;
+    }
+    if (idle_.size() >= maxIdle_) return;
+    builder->Clear();
+    // Its offsets point into the contents just cleared. The interner's own
+    // size check cannot see this once the next lease regrows the builder.
+    if (interner) interner->Reset();
+    idle_.push_back(IdleEntry{std::move(builder), std::move(interner), used});
+}
+
+void BuilderPool::Trim() {
+    idle_.clear();
+}
+
+size_t BuilderPool::IdleBytes() const {
+    size_t total = 0;
+    for (const auto& entry : idle_) total += entry.used;
+    return total;
+}
@@ -0,0 +1,196 @@
+#include "types/ChunkAssembler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <new>
+
+const char* ChunkStatusName(ChunkStatus status) {
+    switch (status) {
+        case ChunkStatus::Accepted: return "accepted";
+        case ChunkStatus::Complete: return "complete";
+        case ChunkStatus::Duplicate: return "duplicate";
+        case ChunkStatus::Stale: return "stale";
+        case ChunkStatus::Invalid: return "invalid";
+        case ChunkStatus::OverBudget: return "over budget";
+    }
+    return "unknown";
+}
+
+void AssembledMessage::AlignedDelete::operator()(uint8_t* p) const {
+    ::operator delete(p, std::align_val_t(kAlignment));
+}
+
+AssembledMessage::Buffer AssembledMessage::Allocate(size_t size) {
+    // Uninitialised: every byte is written by a chunk before the buffer is
+    // handed out.
+    return Buffer(static_cast<uint8_t*>(::operator new(size, std::align_val_t(kAlignment), std::nothrow)));
+}
+
+uint32_t ChunkAssembler::MarkReceived(Partial& p, uint32_t begin, uint32_t end) {
+    std::map<uint32_t, uint32_t>& ranges = p.ranges;
+    auto it = ranges.upper_bound(begin);
+    if (it != ranges.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= end) return 0; // already covered (ranges never touch, so one range or none)
+        if (prev->second >= begin) it = prev;
+    }
+    uint32_t mergedBegin = begin, mergedEnd = end, seen = 0;
+    while (it != ranges.end() && it->first <= end) {
+        const uint32_t lo = std::max(it->first, begin), hi = std::min(it->second, end);
+        if (hi > lo) seen += hi - lo;
+        mergedBegin = std::min(mergedBegin, it->first);
+        mergedEnd = std::max(mergedEnd, it->second);
+        it = ranges.erase(it);
+    }
+    ranges.emplace(mergedBegin, mergedEnd);
+    return (end - begin) - seen;
+}
+
+void ChunkAssembler::Drop(std::unordered_map<uint64_t, Partial>::iterator it) {
+    pendingBytes_ -= it->second.totalSize;
+    Remember(it->first);
+    partials_.erase(it);
+}
+
+void ChunkAssembler::Remember(uint64_t id) {
+    if (!recent_.insert(id).second) return;
+    recentOrder_.push_back(id);
+    if (recentOrder_.size() > kRecentIds) {
+        recent_.erase(recentOrder_.front());
+        recentOrder_.pop_front();
+    }
+}
+
+ChunkStatus ChunkAssembler::Reject(ChunkStatus status) {
+    ++stats_.rejected;
+    return status;
+}
+
+ChunkStatus ChunkAssembler::Add(uint64_t id, uint32_t totalSize, uint32_t offset, const uint8_t* data, size_t len,
+                                uint32_t msgType, AssembledMessage& out, Clock::time_point now) {
+    if (limits_.timeout.count() > 0 && now >= nextSweep_) {
+        ExpireStale(now);
+        nextSweep_ = now + std::max(limits_.timeout / 4, std::chrono::milliseconds(1));
+    }
+
+    const bool inBounds = data && len > 0 && offset < totalSize && len <= (size_t)(totalSize - offset);
+    auto it = partials_.find(id);
+    if (it == partials_.end()) {
+        if (recent_.count(id)) {
+            ++stats_.stale;
+            return ChunkStatus::Stale;
+        }
+        // Nothing is held for the id yet, so a refused first chunk is not
+        // remembered: a later valid chunk (or a retry once memory frees up)
+        // still starts the message.
+        if (!inBounds) return Reject(ChunkStatus::Invalid);
+        if (totalSize > limits_.maxMessageBytes) return Reject(ChunkStatus::OverBudget);
+        if (pendingBytes_ + totalSize > limits_.maxTotalBytes) {
+            ExpireStale(now);
+            if (pendingBytes_ + totalSize > limits_.maxTotalBytes) return Reject(ChunkStatus::OverBudget);
+        }
+        Partial p;
+        p.data = AssembledMessage::Allocate(totalSize);
+        if (!p.data) return Reject(ChunkStatus::OverBudget);
+        p.totalSize = totalSize;
+        p.msgType = msgType;
+        it = partials_.emplace(id, std::move(p)).first;
+        pendingBytes_ += totalSize;
+    } else if (!inBounds || totalSize != it->second.totalSize || msgType != it->second.msgType) {
+        // The sender and this assembler disagree about the message; none of
+        // it can be trusted any more.
+        Drop(it);
+        return Reject(ChunkStatus::Invalid);
+    }
+
+    Partial& p = it->second;
+    p.lastActivity = now;
+    const uint32_t fresh = MarkReceived(p, offset, offset + (uint32_t)len);
+    if (fresh == 0) {
+        ++stats_.duplicates;
+        return ChunkStatus::Duplicate;
+    }
+    std::memcpy(p.data.get() + offset, data, len);
+    stats_.bytesCopied += len;
+    p.received += fresh;
+    if (p.received < p.totalSize) return ChunkStatus::Accepted;
+
+    out.data_ = std::move(p.data);
+    out.size_ = p.totalSize;
+    out.id_ = id;
+    out.msgType_ = p.msgType;
+    pendingBytes_ -= p.totalSize;
+    partials_.erase(it);
+    Remember(id);
+    ++stats_.completed;
+    return ChunkStatus::Complete;
+}
+
+ChunkStatus ChunkAssembler::Add(const protocol::Chunk* chunk, AssembledMessage& out, Clock::time_point now) {
+    if (!chunk) {
+        ++stats_.rejected;
+        return ChunkStatus::Invalid;
+    }
+    const flatbuffers::Vector<uint8_t>* data = chunk->data();
+    return Add(chunk->id(), chunk->total_size(), chunk->offset(), data ? data->data() : nullptr, data ? data->size() : 0,
+               chunk->msg_type(), out, now);
+}
+
+ChunkStatus ChunkAssembler::AddBuffer(const void* buf, size_t size, AssembledMessage& out, Clock::time_point now) {
+    if (!buf) {
+        ++stats_.rejected;
+        return ChunkStatus::Invalid;
+    }
+    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(buf), size);
+    if (!verifier.VerifyBuffer<protocol::Chunk>(nullptr)) {
+        ++stats_.rejected;
+        return ChunkStatus::Invalid;
+    }
+    return Add(flatbuffers::GetRoot<protocol::Chunk>(buf), out, now);
+}
+
+size_t ChunkAssembler::ExpireStale(Clock::time_point now) {
+    if (limits_.timeout.count() <= 0) return 0;
+    size_t dropped = 0;
+    for (auto it = partials_.begin(); it != partials_.end();) {
+        auto next = std::next(it);
+        if (now - it->second.lastActivity > limits_.timeout) {
+            Drop(it);
+            ++dropped;
+        }
+        it = next;
+    }
+    stats_.expired += dropped;
+    return dropped;
+}
+
+void ChunkAssembler::Clear() {
+    partials_.clear();
+    recent_.clear();
+    recentOrder_.clear();
+    pendingBytes_ = 0;
+}
+
+ChunkAssembler::Stats ChunkAssembler::GetStats() const {
+    Stats s = stats_;
+    s.pending = partials_.size();
+    s.pendingBytes = pendingBytes_;
+    return s;
+}
+
+size_t SplitIntoChunks(flatbuffers::FlatBufferBuilder& builder, uint64_t id, uint32_t msgType, const uint8_t* data,
+                       size_t size, size_t chunkBytes, const std::function<void(const uint8_t*, size_t)>& sink) {
+    if (!data || size == 0 || chunkBytes == 0 || size > std::numeric_limits<uint32_t>::max()) return 0;
+    size_t count = 0;
+    for (size_t offset = 0; offset < size; offset += chunkBytes) {
+        const size_t len = std::min(chunkBytes, size - offset);
+        builder.Clear();
+        auto payload = builder.CreateVector(data + offset, len);
+        builder.Finish(protocol::CreateChunk(builder, id, (uint32_t)size, (uint32_t)offset, payload, msgType));
+        sink(builder.GetBufferPointer(), builder.GetSize());
+        ++count;
+    }
+    return count;
+}
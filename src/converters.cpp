@@ -3,12 +3,21 @@
 #include "types/utility.h"
 #include "types/ScopeGuard.h"
 #include "types/ScopedXLOPER12.h"
+#include "types/transcode.h"
+#include "simd.h"
 #include <vector>
 #include <algorithm>
+#include <cstddef> // for offsetof
+#include <cstdint>
 #include <limits>
 #include <new>
 #include <cstring> // for std::memset
 #include <cmath>   // for std::floor
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
 
 
 // Excel -> FlatBuffers Converters
@@ -33,6 +42,17 @@ static inline DWORD BaseXlType(const XLOPER12& op) {
     return op.xltype & ~kXlOwnerBits;
 }
 
+// True for array elements that serialize as Nil: xltypeNil, xltypeMissing
+// and anything else without a scalar value (see ConvertScalar).
+static inline bool IsNilCell(const XLOPER12& cell) {
+    switch (BaseXlType(cell)) {
+        case xltypeNum: case xltypeInt: case xltypeBool: case xltypeStr: case xltypeErr:
+            return false;
+        default:
+            return true;
+    }
+}
+
 // The canonical "return an error XLOPER12 to Excel" block (R5 §4.7 dedup).
 // This 4-line pattern used to be copy-pasted ~10x; security fixes
 // (BUG-014/015/017 lineage) must land here exactly once.
@@ -95,7 +115,7 @@ static bool ValidateGridDims(int rows, int cols, size_t* outCount) {
 // / NumGrid->FP12 site had retyped (R31, BUG-015/017 lineage). The backing
 // store is headerBytes + count*elemSize bytes, and that total must not overflow
 // size_t — live on the 32-bit Excel target, where count can reach INT_MAX.
-// (NewFP12 reserves a 2*sizeof(int) header, so it passes headerBytes; the
+// (NewFP12 allocates a 2*sizeof(int) header, so it passes headerBytes; the
 // XLOPER12 multi paths pass 0.) On any failure *outCount is 0 and it returns
 // false. Do not weaken any check. Payload-size validation (data()->size()
 // vs count) stays at the call site: it inspects the FlatBuffer, not the
@@ -109,7 +129,60 @@ static bool ValidateGridAlloc(int rows, int cols, size_t elemSize, size_t header
     return true;
 }
 
+// CreateStringFromExcel is the only code that touches builder internals.
+// FlatBufferBuilder keeps its vector_downward protected; naming the member
+// through a derived type is enough to form a pointer-to-member (no object of
+// this type is ever created). The asserts pin the FlatBuffers release from
+// cmake/flatbuffers.cmake: after an upgrade, check the layout below against
+// CreateString (TestCreateStringFromExcelMatchesCreateString) before
+// bumping them.
+namespace {
+struct BuilderInternals : flatbuffers::FlatBufferBuilder {
+    static_assert(FLATBUFFERS_VERSION_MAJOR == 25,
+                  "CreateStringFromExcel mirrors FlatBuffers 25.x CreateString; re-verify it for this release");
+    static_assert(std::is_same<decltype(buf_), flatbuffers::vector_downward<flatbuffers::uoffset_t>>::value,
+                  "FlatBufferBuilder::buf_ changed type; re-verify CreateStringFromExcel");
+
+    static flatbuffers::vector_downward<flatbuffers::uoffset_t>& Buf(flatbuffers::FlatBufferBuilder& b) {
+        return b.*(&BuilderInternals::buf_);
+    }
+    static void CheckNotNested(flatbuffers::FlatBufferBuilder& b) { (b.*(&BuilderInternals::NotNested))(); }
+};
+} // namespace
+
+flatbuffers::Offset<flatbuffers::String> CreateStringFromExcel(flatbuffers::FlatBufferBuilder& builder, const XCHAR* str) {
+    const size_t len = str ? (size_t)str[0] : 0;
+    BuilderInternals::CheckNotNested(builder); // as CreateString does
+    const size_t S0 = builder.GetSize();
+
+    // The builder grows downward, so the string's final address depends on
+    // its UTF-8 length. Reserve the worst case (+1 NUL, +3 alignment pad),
+    // transcode at the low end of the reservation, then slide the bytes up to
+    // their final slot and release the slack. The slide stays inside the
+    // builder's own (cache-hot) buffer: no std::string, no heap allocation.
+    auto& buf = BuilderInternals::Buf(builder);
+    const size_t reserve = Utf8MaxBytesForUtf16(len) + 1 + (sizeof(flatbuffers::uoffset_t) - 1);
+    uint8_t* p = buf.make_space(reserve);
+    const size_t n = len ? Utf16ToUtf8(str + 1, len, reinterpret_cast<char*>(p)) : 0;
+
+    // Same layout CreateString produces: body, NUL, zero pad so the length
+    // prefix that follows lands on a uoffset_t boundary.
+    const size_t pad = (~(S0 + n + 1) + 1) & (sizeof(flatbuffers::uoffset_t) - 1);
+    uint8_t* body = p + reserve - pad - 1 - n;
+    if (n && body != p) std::memmove(body, p, n);
+    std::memset(body + n, 0, 1 + pad);
+    buf.pop((size_t)(body - p));
+
+    builder.PushElement(static_cast<flatbuffers::uoffset_t>(n));
+    return flatbuffers::Offset<flatbuffers::String>(builder.GetSize());
+}
+
 flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbuffers::FlatBufferBuilder& builder) {
+    return ConvertScalar(cell, builder, nullptr);
+}
+
+flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbuffers::FlatBufferBuilder& builder,
+                                                    StringInterner* interner) {
     try {
         // Mask xlbitDLLFree/xlbitXLFree: multi elements built by
         // GridToXLOPER12 carry xlbitDLLFree on their string cells, and this
@@ -123,7 +196,8 @@ flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbu
         } else if (type == xltypeBool) {
             return protocol::CreateScalar(builder, protocol::ScalarValue::Bool, protocol::CreateBool(builder, cell.val.xbool).Union());
         } else if (type == xltypeStr) {
-            return protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, builder.CreateString(ConvertExcelString(cell.val.str))).Union());
+            if (interner) return interner->InternScalar(builder, cell.val.str);
+            return protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, CreateStringFromExcel(builder, cell.val.str)).Union());
         } else if (type == xltypeErr) {
             return protocol::CreateScalar(builder, protocol::ScalarValue::Err, protocol::CreateErr(builder, ExcelErrorToProtocol(cell.val.err)).Union());
         } else {
@@ -135,6 +209,11 @@ flatbuffers::Offset<protocol::Scalar> ConvertScalar(const XLOPER12& cell, flatbu
 }
 
 flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder) {
+    return ConvertGrid(op, builder, nullptr);
+}
+
+flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder,
+                                                StringInterner* interner) {
     try {
         if (BaseXlType(*op) == xltypeMulti) {
             int rows = op->val.array.rows;
@@ -154,8 +233,18 @@ flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::Flat
             std::vector<flatbuffers::Offset<protocol::Scalar>> elements;
             elements.reserve(count);
 
+            // Empty cells all share one Nil Scalar table instead of
+            // serializing one each (a vector may reference a table any
+            // number of times).
+            flatbuffers::Offset<protocol::Scalar> nilScalar;
             for (size_t i = 0; i < count; ++i) {
-                elements.push_back(ConvertScalar(op->val.array.lparray[i], builder));
+                const XLOPER12& cell = op->val.array.lparray[i];
+                if (IsNilCell(cell)) {
+                    if (nilScalar.IsNull()) nilScalar = ConvertScalar(cell, builder, interner);
+                    elements.push_back(nilScalar);
+                } else {
+                    elements.push_back(ConvertScalar(cell, builder, interner));
+                }
             }
 
             auto vec = builder.CreateVector(elements);
@@ -164,7 +253,7 @@ flatbuffers::Offset<protocol::Grid> ConvertGrid(LPXLOPER12 op, flatbuffers::Flat
 
         // Handle scalar as 1x1 Grid
         std::vector<flatbuffers::Offset<protocol::Scalar>> elements;
-        elements.push_back(ConvertScalar(*op, builder));
+        elements.push_back(ConvertScalar(*op, builder, interner));
 
         auto vec = builder.CreateVector(elements);
         return protocol::CreateGrid(builder, 1, 1, vec);
@@ -192,6 +281,93 @@ flatbuffers::Offset<protocol::NumGrid> ConvertNumGrid(FP12* fp, flatbuffers::Fla
     }
 }
 
+flatbuffers::Offset<protocol::NumGrid> CreateNumGridFP12(flatbuffers::FlatBufferBuilder& builder, int rows, int cols,
+                                                         const double* data) {
+    try {
+        size_t count = 0;
+        if (!ValidateGridAlloc(rows, cols, sizeof(double), 0, &count) || (count > 0 && !data)) {
+            return protocol::CreateNumGrid(builder, 0, 0, 0);
+        }
+
+        // The FP12 image, written straight into the builder: header, then the
+        // doubles. force_align: 8 on the schema field, hence the alignment.
+        const size_t bytes = offsetof(FP12, array) + count * sizeof(double);
+        uint8_t* image = nullptr;
+        auto fp12 = flatbuffers::Offset<flatbuffers::Vector<uint8_t>>(
+            builder.CreateUninitializedVector(bytes, sizeof(uint8_t), alignof(double), &image));
+        flatbuffers::WriteScalar<int32_t>(image, rows);
+        flatbuffers::WriteScalar<int32_t>(image + sizeof(int32_t), cols);
+#if FLATBUFFERS_LITTLEENDIAN
+        std::memcpy(image + offsetof(FP12, array), data, count * sizeof(double));
+#else
+        for (size_t i = 0; i < count; ++i) {
+            flatbuffers::WriteScalar<double>(image + offsetof(FP12, array) + i * sizeof(double), data[i]);
+        }
+#endif
+        return protocol::CreateNumGrid(builder, rows, cols, 0, fp12);
+    } catch (...) {
+        return protocol::CreateNumGrid(builder, 0, 0, 0);
+    }
+}
+
+// --- Sheet-name cache ---------------------------------------------------------
+// idSheet -> UTF-8 name. A workbook with many caller-aware formulas otherwise
+// asks Excel for the same few names on every call. Off by default: nothing
+// tells the DLL about a rename, so only a caller that invalidates the cache
+// (per recalc and after renames) may turn it on. Readers share the lock;
+// only a miss or an invalidation takes it exclusively. Failed lookups are not
+// cached.
+namespace {
+
+std::shared_mutex sheetNameMutex;
+std::unordered_map<IDSHEET, std::string> sheetNames;
+std::atomic<bool> sheetNameCacheEnabled{false};
+std::atomic<uint64_t> sheetNameHits{0};
+std::atomic<uint64_t> sheetNameMisses{0};
+std::atomic<uint64_t> sheetNameEpoch{0};
+
+bool FindSheetName(IDSHEET id, std::string& out) {
+    std::shared_lock<std::shared_mutex> lock(sheetNameMutex);
+    auto it = sheetNames.find(id);
+    if (it == sheetNames.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void StoreSheetName(IDSHEET id, uint64_t epoch, const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(sheetNameMutex);
+    // A lookup that straddled an invalidation may hold a pre-rename name.
+    if (sheetNameEpoch.load(std::memory_order_relaxed) != epoch) return;
+    sheetNames.emplace(id, name);
+}
+
+} // namespace
+
+void SetSheetNameCacheEnabled(bool enabled) {
+    sheetNameCacheEnabled.store(enabled, std::memory_order_relaxed);
+    if (!enabled) InvalidateSheetNameCache();
+}
+
+bool SheetNameCacheEnabled() {
+    return sheetNameCacheEnabled.load(std::memory_order_relaxed);
+}
+
+void InvalidateSheetNameCache() {
+    std::unique_lock<std::shared_mutex> lock(sheetNameMutex);
+    sheetNames.clear();
+    sheetNameEpoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+SheetNameCacheStats GetSheetNameCacheStats() {
+    SheetNameCacheStats stats;
+    std::shared_lock<std::shared_mutex> lock(sheetNameMutex);
+    stats.entries = sheetNames.size();
+    stats.hits = sheetNameHits.load(std::memory_order_relaxed);
+    stats.misses = sheetNameMisses.load(std::memory_order_relaxed);
+    stats.epoch = sheetNameEpoch.load(std::memory_order_relaxed);
+    return stats;
+}
+
 // Resolve the workbook/worksheet name ("[Book1]Sheet1") for a reference
 // XLOPER12 using only C-API entry points that are legal from non-macro,
 // thread-safe ('$'-registered) worksheet functions. xll-gen v0.5.0 makes
@@ -204,6 +380,9 @@ flatbuffers::Offset<protocol::NumGrid> ConvertNumGrid(FP12* fp, flatbuffers::Fla
 //   - xltypeSRef (same-sheet reference, no idSheet): first call the no-arg
 //     xlSheetId to learn the active sheet id, then hand that ref to xlSheetNm.
 //
+// Names are cached by idSheet (see above), so a cached xltypeRef costs no
+// callback and a cached xltypeSRef only the xlSheetId call.
+//
 // Returns the name as UTF-8. On ANY failure — no live Excel (pexcel12 NULL in
 // unit tests → xlretFailed), not in a calc context, wrong return type, or an
 // exception in conversion — it degrades to an empty string. It never throws.
@@ -235,6 +414,18 @@ static std::string LookupSheetName(LPXLOPER12 op) {
             return std::string();
         }
 
+        const IDSHEET id = refForName->val.mref.idSheet;
+        const bool cacheable = id != 0 && sheetNameCacheEnabled.load(std::memory_order_relaxed);
+        const uint64_t epoch = sheetNameEpoch.load(std::memory_order_relaxed);
+        if (cacheable) {
+            std::string cached;
+            if (FindSheetName(id, cached)) {
+                sheetNameHits.fetch_add(1, std::memory_order_relaxed);
+                return cached;
+            }
+            sheetNameMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+
         ScopedXLOPER12Result xName;
         if (Excel12(xlSheetNm, xName, 1, refForName) != xlretSuccess) {
             return std::string();
@@ -244,43 +435,148 @@ static std::string LookupSheetName(LPXLOPER12 op) {
         }
 
         // Excel returns a Pascal-style wide string ("[Book1]Sheet1").
-        std::wstring ws = PascalToWString(xName.get()->val.str);
-        return WideToUtf8(ws);
+        std::string name = ConvertExcelString(xName.get()->val.str);
+        if (cacheable) StoreSheetName(id, epoch, name);
+        return name;
     } catch (...) {
         return std::string();
     }
     // ScopedXLOPER12Result destructors free any Excel-allocated payloads here.
 }
 
-flatbuffers::Offset<protocol::Range> ConvertRange(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder, const std::string& format) {
+// --- Rect coalescing -----------------------------------------------------------
+
+static std::atomic<bool> rectCoalescing{false};
+
+void SetRectCoalescing(bool enabled) {
+    rectCoalescing.store(enabled, std::memory_order_relaxed);
+}
+
+bool RectCoalescingEnabled() {
+    return rectCoalescing.load(std::memory_order_relaxed);
+}
+
+static bool RowMajorLess(const XLREF12& a, const XLREF12& b) {
+    if (a.rwFirst != b.rwFirst) return a.rwFirst < b.rwFirst;
+    if (a.colFirst != b.colFirst) return a.colFirst < b.colFirst;
+    if (a.rwLast != b.rwLast) return a.rwLast < b.rwLast;
+    return a.colLast < b.colLast;
+}
+
+static bool Contains(const XLREF12& outer, const XLREF12& inner) {
+    return outer.rwFirst <= inner.rwFirst && inner.rwLast <= outer.rwLast &&
+           outer.colFirst <= inner.colFirst && inner.colLast <= outer.colLast;
+}
+
+// Containment is checked pairwise, so only up to this many rects.
+static const size_t kContainmentCheckLimit = 1024;
+
+// One pass over `n` rects sorted by (fixed span, start): merges neighbours
+// whose fixed span is equal and whose other span touches or overlaps. The
+// span accessors pick rows or columns. Returns the new count.
+template <typename Span, typename Start, typename End>
+static size_t MergeAligned(XLREF12* refs, size_t n, Span span, Start start, End end) {
+    std::sort(refs, refs + n, [&](const XLREF12& a, const XLREF12& b) {
+        if (span(a) != span(b)) return span(a) < span(b);
+        return start(a) < start(b);
+    });
+    size_t out = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (out > 0) {
+            XLREF12& last = refs[out - 1];
+            // int64: a span ending at the last row/column must not overflow.
+            if (span(last) == span(refs[i]) && (int64_t)start(refs[i]) <= (int64_t)end(last) + 1) {
+                if (end(refs[i]) > end(last)) end(last) = end(refs[i]);
+                continue;
+            }
+        }
+        refs[out++] = refs[i];
+    }
+    return out;
+}
+
+size_t CoalesceRefs(XLREF12* refs, size_t count) {
+    if (!refs || count == 0) return count;
+    for (size_t i = 0; i < count; ++i) {
+        // A malformed rect has no well-defined cells to merge: leave it all.
+        if (refs[i].rwFirst > refs[i].rwLast || refs[i].colFirst > refs[i].colLast) return count;
+    }
+
+    size_t n = count;
+    for (;;) {
+        const size_t before = n;
+        if (n <= kContainmentCheckLimit) {
+            // Largest first, so each rect only needs checking against kept ones.
+            std::sort(refs, refs + n, [](const XLREF12& a, const XLREF12& b) {
+                const int64_t areaA = (int64_t)(a.rwLast - a.rwFirst + 1) * (a.colLast - a.colFirst + 1);
+                const int64_t areaB = (int64_t)(b.rwLast - b.rwFirst + 1) * (b.colLast - b.colFirst + 1);
+                return areaA > areaB;
+            });
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                bool covered = false;
+                for (size_t j = 0; j < kept && !covered; ++j) covered = Contains(refs[j], refs[i]);
+                if (!covered) refs[kept++] = refs[i];
+            }
+            n = kept;
+        }
+        // Same rows, touching columns: row strips.
+        n = MergeAligned(refs, n,
+                         [](const XLREF12& r) { return ((int64_t)r.rwFirst << 32) | (uint32_t)r.rwLast; },
+                         [](const XLREF12& r) { return r.colFirst; },
+                         [](XLREF12& r) -> COL& { return r.colLast; });
+        // Same columns, touching rows: stacks of strips.
+        n = MergeAligned(refs, n,
+                         [](const XLREF12& r) { return ((int64_t)r.colFirst << 32) | (uint32_t)r.colLast; },
+                         [](const XLREF12& r) { return r.rwFirst; },
+                         [](XLREF12& r) -> RW& { return r.rwLast; });
+        if (n == before) break;
+    }
+    std::sort(refs, refs + n, RowMajorLess);
+    return n;
+}
+
+// The rects of a reference XLOPER12, coalesced when that is enabled. Empty
+// for other xltypes.
+static std::vector<XLREF12> CollectRefs(LPXLOPER12 op) {
+    std::vector<XLREF12> refs;
+    const DWORD type = op ? BaseXlType(*op) : 0;
+    if (type == xltypeRef && op->val.mref.lpmref) {
+        const XLMREF12* mref = op->val.mref.lpmref;
+        refs.assign(mref->reftbl, mref->reftbl + mref->count);
+    } else if (type == xltypeSRef) {
+        refs.push_back(op->val.sref.ref);
+    }
+    if (refs.size() > 1 && RectCoalescingEnabled()) refs.resize(CoalesceRefs(refs.data(), refs.size()));
+    return refs;
+}
+
+// ConvertRange's table for the rects `refs` (from CollectRefs), with `values`
+// (built beforehand, may be null) attached.
+static flatbuffers::Offset<protocol::Range> BuildRange(
+    LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder, const std::string& format,
+    const std::vector<XLREF12>& refs,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<protocol::Any>>> values) {
     try {
         // Resolve the sheet name once per call (not per rect). Empty on any
         // failure / outside a live Excel calc context — purely additive, so
         // existing consumers that never saw a populated name are unaffected.
+        // Shared: ranges on one sheet converted into the same builder point
+        // at a single copy of the name.
         std::string sheetName = LookupSheetName(op);
         flatbuffers::Offset<flatbuffers::String> sheetOff =
-            sheetName.empty() ? 0 : builder.CreateString(sheetName);
+            sheetName.empty() ? 0 : builder.CreateSharedString(sheetName);
 
         auto fmtOff = builder.CreateString(format);
 
-        if (op->xltype & xltypeRef) {
+        if (op && (op->xltype & (xltypeRef | xltypeSRef))) {
             std::vector<protocol::Rect> rects;
-            int count = op->val.mref.lpmref->count;
-            for(int i=0; i<count; ++i) {
-                auto& r = op->val.mref.lpmref->reftbl[i];
+            rects.reserve(refs.size());
+            for (const XLREF12& r : refs) {
                 rects.emplace_back(r.rwFirst, r.rwLast, r.colFirst, r.colLast);
             }
             auto vec = builder.CreateVectorOfStructs(rects);
-
-            return protocol::CreateRange(builder, sheetOff, vec, fmtOff);
-        }
-        // SRRef
-        if (op->xltype & xltypeSRef) {
-            std::vector<protocol::Rect> rects;
-            auto& r = op->val.sref.ref;
-            rects.emplace_back(r.rwFirst, r.rwLast, r.colFirst, r.colLast);
-            auto vec = builder.CreateVectorOfStructs(rects);
-            return protocol::CreateRange(builder, sheetOff, vec, fmtOff);
+            return protocol::CreateRange(builder, sheetOff, vec, fmtOff, values);
         }
 
         return protocol::CreateRange(builder, sheetOff, 0, fmtOff);
@@ -289,34 +585,513 @@ flatbuffers::Offset<protocol::Range> ConvertRange(LPXLOPER12 op, flatbuffers::Fl
     }
 }
 
-// Helper for converting Multi to Any
-flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& op, flatbuffers::FlatBufferBuilder& builder) {
+flatbuffers::Offset<protocol::Range> ConvertRange(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder, const std::string& format) {
+    std::vector<XLREF12> refs;
     try {
-        // Check if it's homogenous numbers -> NumGrid
-        // Else -> Grid
-        bool allNums = true;
+        refs = CollectRefs(op);
+    } catch (...) {
+        return protocol::CreateRange(builder, 0, 0, 0);
+    }
+    return BuildRange(op, builder, format, refs, 0);
+}
 
-        size_t count = 0;
-        if (!ValidateGridDims(op.val.array.rows, op.val.array.columns, &count)) {
-            // Fallback to empty Grid
-            return protocol::CreateAny(builder, protocol::AnyValue::Grid, protocol::CreateGrid(builder, 0, 0, 0).Union());
+// Reads one area with xlCoerce (no target type: a single cell comes back as a
+// scalar, anything larger as an xltypeMulti) and serializes it like
+// ConvertAny, so grids take whichever encoding ConvertMultiToAny picks. The
+// Excel-allocated result is released by ScopedXLOPER12Result.
+static int CoerceArea(LPXLOPER12 area, flatbuffers::FlatBufferBuilder& builder,
+                      flatbuffers::Offset<protocol::Any>& out) {
+    ScopedXLOPER12Result value;
+    const int ret = Excel12(xlCoerce, value, 1, area);
+    if (ret != xlretSuccess) return ret;
+    out = ConvertAny(value, builder);
+    return xlretSuccess;
+}
+
+flatbuffers::Offset<protocol::Range> ConvertRangeWithValues(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder,
+                                                            const std::string& format, int* xlret) {
+    int ret = xlretSuccess;
+    std::vector<XLREF12> refs;
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<protocol::Any>>> values = 0;
+    try {
+        // Values follow the rects that are sent, so coalescing (when on) also
+        // saves xlCoerce calls.
+        refs = CollectRefs(op);
+        std::vector<flatbuffers::Offset<protocol::Any>> areas(refs.size());
+        if (!refs.empty() && BaseXlType(*op) == xltypeSRef) {
+            ret = CoerceArea(op, builder, areas[0]);
+        } else if (!refs.empty()) {
+            // One single-area reference per rect, on the same sheet.
+            XLMREF12 single;
+            single.count = 1;
+            XLOPER12 area;
+            area.xltype = xltypeRef;
+            area.val.mref.lpmref = &single;
+            area.val.mref.idSheet = op->val.mref.idSheet;
+            for (size_t i = 0; i < refs.size() && ret == xlretSuccess; ++i) {
+                single.reftbl[0] = refs[i];
+                ret = CoerceArea(&area, builder, areas[i]);
+            }
         }
+        // All areas or none: a partial list would not line up with refs.
+        if (ret == xlretSuccess && !areas.empty()) values = builder.CreateVector(areas);
+    } catch (...) {
+        ret = xlretFailed;
+        values = 0;
+    }
+    if (xlret) *xlret = ret;
+    return BuildRange(op, builder, format, refs, values);
+}
+
+// --- Grid profile -----------------------------------------------------------
+// The ColumnType a value xltype (ownership bits masked) is stored under, or -1
+// for a cell carried as a null. Nil, missing and any other xltype become
+// nulls, exactly as the Grid path turns them into Nil scalars.
+static int ColumnTypeOfXlType(DWORD type) {
+    switch (type) {
+        case xltypeNum:  return (int)protocol::ColumnType::Num;
+        case xltypeInt:  return (int)protocol::ColumnType::Int;
+        case xltypeBool: return (int)protocol::ColumnType::Bool;
+        case xltypeStr:  return (int)protocol::ColumnType::Str;
+        case xltypeErr:  return (int)protocol::ColumnType::Err;
+        default:         return -1;
+    }
+}
+
+static int ColumnTypeOfCell(const XLOPER12& cell) {
+    return ColumnTypeOfXlType(BaseXlType(cell));
+}
+
+// The value xltypes are one-hot bits, so OR-ing every masked xltype of a
+// column together shows whether it mixes values: at most one of these bits.
+static const DWORD kXlValueBits = (DWORD)(xltypeNum | xltypeInt | xltypeBool | xltypeStr | xltypeErr);
+
+// Running per-type counts while ProfileGrid walks the cells.
+struct GridCensus {
+    size_t nums = 0;
+    size_t ints = 0;
+    size_t bools = 0;
+    size_t strs = 0;
+    size_t errs = 0;
+    size_t integralNums = 0;
+    size_t strUnits = 0;
+};
+
+static inline bool IsInt32Valued(double d) {
+    return d >= -2147483648.0 && d <= 2147483647.0 && d == (double)(int32_t)d;
+}
+
+static inline void CensusCell(const XLOPER12& cell, uint32_t& colMask, GridCensus& c) {
+    const DWORD type = BaseXlType(cell);
+    colMask |= (uint32_t)type;
+    switch (type) {
+        case xltypeNum:
+            ++c.nums;
+            if (IsInt32Valued(cell.val.num)) ++c.integralNums;
+            break;
+        case xltypeInt:  ++c.ints;  break;
+        case xltypeBool: ++c.bools; break;
+        case xltypeStr:
+            ++c.strs;
+            if (cell.val.str) c.strUnits += (size_t)cell.val.str[0];
+            break;
+        case xltypeErr:  ++c.errs;  break;
+        default: break;
+    }
+}
+
+#if defined(TYPES_SIMD_AVX2)
+static_assert(sizeof(XLOPER12) % sizeof(double) == 0, "XLOPER12 stride must be a whole number of doubles");
+static_assert(offsetof(XLOPER12, xltype) % sizeof(int) == 0, "xltype must be int-aligned for the gather");
 
-        // Safety check: if grid dimensions are non-zero, lparray must not be null
-        if (count > 0 && !op.val.array.lparray) {
-             return protocol::CreateAny(builder, protocol::AnyValue::Grid, protocol::CreateGrid(builder, 0, 0, 0).Union());
+static inline size_t PopCount8(unsigned v) {
+    v = v - ((v >> 1) & 0x55u);
+    v = (v & 0x33u) + ((v >> 2) & 0x33u);
+    return (v + (v >> 4)) & 0x0Fu;
+}
+
+TYPES_TARGET_AVX2 static inline unsigned LanesEqualAvx2(__m256i types, DWORD type) {
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(types, _mm256_set1_epi32((int)type))));
+}
+
+// One bit per lane of `x` holding a whole number in int32 range (IsInt32Valued).
+TYPES_TARGET_AVX2 static inline unsigned LanesInt32ValuedAvx2(__m256d x) {
+    const __m256d whole = _mm256_cmp_pd(x, _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC), _CMP_EQ_OQ);
+    const __m256d inRange = _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(-2147483648.0), _CMP_GE_OQ),
+                                          _mm256_cmp_pd(x, _mm256_set1_pd(2147483647.0), _CMP_LE_OQ));
+    return (unsigned)_mm256_movemask_pd(_mm256_and_pd(whole, inRange));
+}
+
+// Census of cells[0..n) eight at a time; returns the number of cells taken (a
+// multiple of 8), leaving the tail to CensusCell. The eight xltype words sit
+// one XLOPER12 apart, so one gather with a sizeof(XLOPER12) stride collects
+// them; the doubles are gathered only for runs holding numbers. Column masks
+// go to masks[i..i+8) for cell i, or with `fixedMasks` always to masks[0..8).
+TYPES_TARGET_AVX2 static size_t CensusCellsAvx2(const XLOPER12* cells, size_t n, uint32_t* masks, bool fixedMasks,
+                                                GridCensus& c) {
+    const int typeStride = (int)(sizeof(XLOPER12) / sizeof(int));
+    const int numStride = (int)(sizeof(XLOPER12) / sizeof(double));
+    const __m256i typeIndex = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(typeStride));
+    const __m128i numIndex = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(numStride));
+    const __m256i typeMask = _mm256_set1_epi32((int)~kXlOwnerBits);
+    // Masked gathers with a zero pass-through: same instruction, but no
+    // undefined source register for GCC to warn about.
+    const __m256d allOnes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const XLOPER12* run = cells + i;
+        const int* typeWords = reinterpret_cast<const int*>(reinterpret_cast<const char*>(run) + offsetof(XLOPER12, xltype));
+        const __m256i types = _mm256_and_si256(_mm256_i32gather_epi32(typeWords, typeIndex, 4), typeMask);
+
+        __m256i* colMask = reinterpret_cast<__m256i*>(masks + (fixedMasks ? 0 : i));
+        _mm256_storeu_si256(colMask, _mm256_or_si256(_mm256_loadu_si256(colMask), types));
+
+        const unsigned numLanes = LanesEqualAvx2(types, xltypeNum);
+        const unsigned strLanes = LanesEqualAvx2(types, xltypeStr);
+        c.nums += PopCount8(numLanes);
+        c.ints += PopCount8(LanesEqualAvx2(types, xltypeInt));
+        c.bools += PopCount8(LanesEqualAvx2(types, xltypeBool));
+        c.strs += PopCount8(strLanes);
+        c.errs += PopCount8(LanesEqualAvx2(types, xltypeErr));
+
+        if (numLanes) {
+            const double* nums = reinterpret_cast<const double*>(reinterpret_cast<const char*>(run) + offsetof(XLOPER12, val));
+            const __m256d lo = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), nums, numIndex, allOnes, 8);
+            const __m256d hi = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), nums + 4 * numStride, numIndex, allOnes, 8);
+            const unsigned whole = LanesInt32ValuedAvx2(lo) | (LanesInt32ValuedAvx2(hi) << 4);
+            c.integralNums += PopCount8(whole & numLanes);
+        }
+        for (int k = 0; strLanes >> k; ++k) {
+            if (((strLanes >> k) & 1) && run[k].val.str) c.strUnits += (size_t)run[k].val.str[0];
         }
+    }
+    return i;
+}
+#endif
 
-        for (size_t i = 0; i < count; ++i) {
-            // Mask ownership bits — see ConvertScalar.
-            if (BaseXlType(op.val.array.lparray[i]) != xltypeNum) {
-                allNums = false;
+bool ProfileGrid(const XLOPER12& op, GridProfile& out) {
+    out = GridProfile();
+    size_t count = 0;
+    if (!ValidateGridDims(op.val.array.rows, op.val.array.columns, &count)) return false;
+    if (count > 0 && !op.val.array.lparray) return false;
+
+    const int rows = op.val.array.rows;
+    const int cols = op.val.array.columns;
+    const XLOPER12* cells = op.val.array.lparray;
+    std::vector<uint32_t> colMask((size_t)cols, 0);
+    GridCensus c;
+
+    size_t done = 0;
+#if defined(TYPES_SIMD_AVX2)
+    if (count >= 8 && CpuHasAvx2()) {
+        if (cols >= 8) {
+            for (int r = 0; r < rows; ++r) {
+                const XLOPER12* row = cells + (size_t)r * cols;
+                for (size_t k = CensusCellsAvx2(row, (size_t)cols, colMask.data(), false, c); k < (size_t)cols; ++k) {
+                    CensusCell(row[k], colMask[k], c);
+                }
+            }
+            done = count;
+        } else if (8 % cols == 0) {
+            // 1, 2 or 4 columns: every run of eight starts at column 0, so
+            // lane k always belongs to column k % cols.
+            uint32_t laneMask[8] = {};
+            done = CensusCellsAvx2(cells, count, laneMask, true, c);
+            for (int k = 0; k < 8; ++k) colMask[(size_t)(k % cols)] |= laneMask[k];
+        }
+    }
+#endif
+    for (size_t i = done, col = cols > 0 ? done % (size_t)cols : 0; i < count; ++i) {
+        CensusCell(cells[i], colMask[col], c);
+        if (++col == (size_t)cols) col = 0;
+    }
+
+    out.rows = rows;
+    out.cols = cols;
+    out.cells = count;
+    out.nums = c.nums;
+    out.ints = c.ints;
+    out.bools = c.bools;
+    out.strs = c.strs;
+    out.errs = c.errs;
+    out.nils = count - (c.nums + c.ints + c.bools + c.strs + c.errs);
+    out.integralNums = c.integralNums;
+    out.strUnits = c.strUnits;
+
+    out.columnTypes.assign((size_t)cols, protocol::ColumnType::Num);
+    out.columnsHomogeneous = true;
+    for (int col = 0; col < cols; ++col) {
+        const DWORD values = (DWORD)colMask[(size_t)col] & kXlValueBits;
+        if (values & (values - 1)) {
+            out.columnsHomogeneous = false;
+            out.columnTypes.clear();
+            break;
+        }
+        if (values) out.columnTypes[(size_t)col] = (protocol::ColumnType)ColumnTypeOfXlType(values);
+    }
+    return true;
+}
+
+// --- ColumnGrid encoding ----------------------------------------------------
+// Serializes `op` column by column. Each column holds `rows` values in its
+// typed vector; a null cell gets a filler value (0, false, "") and its bit
+// set in the `nulls` bitmap (bit r%8 of byte r/8), which is omitted when the
+// column has no nulls.
+static flatbuffers::Offset<protocol::ColumnGrid> BuildColumnGrid(const XLOPER12& op,
+                                                                 const std::vector<protocol::ColumnType>& types,
+                                                                 flatbuffers::FlatBufferBuilder& builder,
+                                                                 StringInterner* interner) {
+    const int rows = op.val.array.rows;
+    const int cols = op.val.array.columns;
+    const XLOPER12* cells = op.val.array.lparray;
+
+    std::vector<flatbuffers::Offset<protocol::Column>> columns;
+    columns.reserve((size_t)cols);
+    std::vector<uint8_t> nulls(((size_t)rows + 7) / 8);
+    std::vector<flatbuffers::Offset<flatbuffers::String>> strs;
+    flatbuffers::Offset<flatbuffers::String> emptyStr; // shared filler for null string cells
+
+    for (int c = 0; c < cols; ++c) {
+        const protocol::ColumnType type = types[(size_t)c];
+        auto cellAt = [&](int r) -> const XLOPER12& { return cells[(size_t)r * cols + c]; };
+
+        std::fill(nulls.begin(), nulls.end(), (uint8_t)0);
+        bool anyNull = false;
+        for (int r = 0; r < rows; ++r) {
+            if (ColumnTypeOfCell(cellAt(r)) < 0) {
+                nulls[(size_t)r / 8] |= (uint8_t)(1u << (r % 8));
+                anyNull = true;
+            }
+        }
+        auto isNull = [&](int r) { return (nulls[(size_t)r / 8] >> (r % 8)) & 1; };
+
+        flatbuffers::Offset<flatbuffers::Vector<uint8_t>> nullsVec;
+        if (anyNull) nullsVec = builder.CreateVector(nulls);
+
+        switch (type) {
+            case protocol::ColumnType::Num: {
+                double* buf = nullptr;
+                auto vec = builder.CreateUninitializedVector<double>((size_t)rows, &buf);
+                for (int r = 0; r < rows; ++r) buf[r] = isNull(r) ? 0.0 : cellAt(r).val.num;
+                columns.push_back(protocol::CreateColumn(builder, type, nullsVec, vec));
+                break;
+            }
+            case protocol::ColumnType::Int: {
+                int32_t* buf = nullptr;
+                auto vec = builder.CreateUninitializedVector<int32_t>((size_t)rows, &buf);
+                for (int r = 0; r < rows; ++r) buf[r] = isNull(r) ? 0 : (int32_t)cellAt(r).val.w;
+                columns.push_back(protocol::CreateColumn(builder, type, nullsVec, 0, vec));
+                break;
+            }
+            case protocol::ColumnType::Bool: {
+                uint8_t* buf = nullptr;
+                auto vec = builder.CreateUninitializedVector<uint8_t>((size_t)rows, &buf);
+                for (int r = 0; r < rows; ++r) buf[r] = (!isNull(r) && cellAt(r).val.xbool) ? 1 : 0;
+                columns.push_back(protocol::CreateColumn(builder, type, nullsVec, 0, 0, vec));
+                break;
+            }
+            case protocol::ColumnType::Str: {
+                strs.clear();
+                strs.reserve((size_t)rows);
+                for (int r = 0; r < rows; ++r) {
+                    if (isNull(r)) {
+                        if (emptyStr.IsNull()) emptyStr = builder.CreateString("", 0);
+                        strs.push_back(emptyStr);
+                    } else if (interner) {
+                        strs.push_back(interner->Intern(builder, cellAt(r).val.str));
+                    } else {
+                        strs.push_back(CreateStringFromExcel(builder, cellAt(r).val.str));
+                    }
+                }
+                auto vec = builder.CreateVector(strs);
+                columns.push_back(protocol::CreateColumn(builder, type, nullsVec, 0, 0, 0, vec));
+                break;
+            }
+            case protocol::ColumnType::Err: {
+                int16_t* buf = nullptr;
+                auto vec = builder.CreateUninitializedVector<int16_t>((size_t)rows, &buf);
+                for (int r = 0; r < rows; ++r) {
+                    buf[r] = isNull(r) ? 0 : (int16_t)ExcelErrorToProtocol(cellAt(r).val.err);
+                }
+                columns.push_back(protocol::CreateColumn(builder, type, nullsVec, 0, 0, 0, 0, vec));
                 break;
             }
         }
+    }
+
+    auto vec = builder.CreateVector(columns);
+    return protocol::CreateColumnGrid(builder, rows, cols, vec);
+}
+
+// --- NumGridEx encoding -----------------------------------------------------
+// A mostly-numeric array keeps the dense double vector when at most one cell
+// in kNumGridExMaxExceptionShare is something else; past that the boxed Grid
+// is about as small and the dense vector is mostly filler.
+static const size_t kNumGridExMaxExceptionShare = 4;
+
+// Serializes `op` (`count` cells, `exceptions` of them not xltypeNum) as the
+// dense row-major doubles plus one (index, Scalar) pair per exception. The
+// exception Scalars are built first: the dense vector is filled in place
+// after CreateUninitializedVector, so nothing may be serialized after it.
+static flatbuffers::Offset<protocol::NumGridEx> BuildNumGridEx(const XLOPER12& op, size_t count, size_t exceptions,
+                                                               flatbuffers::FlatBufferBuilder& builder,
+                                                               StringInterner* interner) {
+    const XLOPER12* cells = op.val.array.lparray;
+
+    std::vector<uint32_t> excIndex;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> excValues;
+    excIndex.reserve(exceptions);
+    excValues.reserve(exceptions);
+    for (size_t i = 0; i < count; ++i) {
+        if (BaseXlType(cells[i]) != xltypeNum) {
+            excIndex.push_back((uint32_t)i);
+            excValues.push_back(ConvertScalar(cells[i], builder, interner));
+        }
+    }
+    auto valuesVec = builder.CreateVector(excValues);
+    auto indexVec = builder.CreateVector(excIndex);
+
+    double* buf = nullptr;
+    auto dataVec = builder.CreateUninitializedVector<double>(count, &buf);
+    for (size_t i = 0; i < count; ++i) {
+        buf[i] = BaseXlType(cells[i]) == xltypeNum ? cells[i].val.num : 0.0;
+    }
+    return protocol::CreateNumGridEx(builder, op.val.array.rows, op.val.array.columns, dataVec, indexVec, valuesVec);
+}
+
+// --- SparseGrid encoding ----------------------------------------------------
+// A mostly empty array (whole-column references and the like) is sent as its
+// populated cells only when at most one cell in kSparseGridMaxDensityShare
+// holds a value. Each populated cell then costs an index and an offset on
+// top of its Scalar, while every dense encoding spends at least 8 bytes on
+// every cell.
+static const size_t kSparseGridMaxDensityShare = 8;
+
+// Serializes the non-nil cells of `op` (`count` cells, `populated` of them
+// non-nil) as sorted (row-major index, Scalar) pairs.
+static flatbuffers::Offset<protocol::SparseGrid> BuildSparseGrid(const XLOPER12& op, size_t count, size_t populated,
+                                                                 flatbuffers::FlatBufferBuilder& builder,
+                                                                 StringInterner* interner) {
+    const XLOPER12* cells = op.val.array.lparray;
+
+    std::vector<uint32_t> index;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> values;
+    index.reserve(populated);
+    values.reserve(populated);
+    for (size_t i = 0; i < count; ++i) {
+        if (!IsNilCell(cells[i])) {
+            index.push_back((uint32_t)i);
+            values.push_back(ConvertScalar(cells[i], builder, interner));
+        }
+    }
+    auto valuesVec = builder.CreateVector(values);
+    auto indexVec = builder.CreateVector(index);
+    return protocol::CreateSparseGrid(builder, op.val.array.rows, op.val.array.columns, indexVec, valuesVec);
+}
+
+// Picks the array encoding for a profiled xltypeMulti:
+//   all numbers          -> NumGrid
+//   else mostly empty    -> SparseGrid
+//   else homogeneous cols -> ColumnGrid (two or more rows: with one value per
+//                           column it saves nothing over a Scalar per cell)
+//   else few non-numbers -> NumGridEx
+//   else                 -> Grid
+static protocol::AnyValue SelectArrayEncoding(const GridProfile& p) {
+    if (p.AllNumbers()) return protocol::AnyValue::NumGrid;
+    if (p.Populated() <= p.cells / kSparseGridMaxDensityShare) return protocol::AnyValue::SparseGrid;
+    if (p.rows >= 2 && p.columnsHomogeneous) return protocol::AnyValue::ColumnGrid;
+    if (p.cells - p.nums <= p.cells / kNumGridExMaxExceptionShare) return protocol::AnyValue::NumGridEx;
+    return protocol::AnyValue::Grid;
+}
+
+// --- Size estimates ---------------------------------------------------------
+// Upper estimates of what a conversion appends to a builder, so that
+// ReserveBuilder can make it one allocation. Per-item costs include vtable
+// references, alignment padding and the builder's scratch use; vtables
+// themselves are shared and covered by the fixed overhead.
+static const size_t kAnyOverheadBytes = 64;   // Any + payload tables, vtables, root, alignment
+static const size_t kBoxedCellBytes = 48;     // offset + Scalar table + value table
+static const size_t kStringOverheadBytes = 8; // length prefix, NUL, padding
+static const size_t kRangeNameBytes = 1024;   // "[Book]Sheet" and the format string
+
+static size_t StringBytes(size_t units) {
+    return Utf8MaxBytesForUtf16(units) + kStringOverheadBytes;
+}
+
+static size_t EstimateArrayBytes(const GridProfile& p, protocol::AnyValue encoding) {
+    const size_t strBytes = p.StrBytesUpperBound() + p.strs * kStringOverheadBytes;
+    const size_t boxed = p.cells - p.nums; // cells that need a Scalar in NumGridEx
+    switch (encoding) {
+        case protocol::AnyValue::NumGrid:
+            return kAnyOverheadBytes + p.cells * sizeof(double);
+        case protocol::AnyValue::SparseGrid:
+            return kAnyOverheadBytes + p.Populated() * (sizeof(uint32_t) + kBoxedCellBytes) + strBytes;
+        case protocol::AnyValue::NumGridEx:
+            return kAnyOverheadBytes + p.cells * sizeof(double) + boxed * (sizeof(uint32_t) + kBoxedCellBytes) +
+                   strBytes;
+        case protocol::AnyValue::ColumnGrid: {
+            // Column table, vector headers and a null bitmap per column, plus
+            // the typed values; Str columns hold an offset per row.
+            size_t total = kAnyOverheadBytes + strBytes;
+            const size_t rows = (size_t)p.rows;
+            for (protocol::ColumnType type : p.columnTypes) {
+                total += 48 + (rows + 7) / 8;
+                switch (type) {
+                    case protocol::ColumnType::Num:  total += rows * sizeof(double); break;
+                    case protocol::ColumnType::Int:  total += rows * sizeof(int32_t); break;
+                    case protocol::ColumnType::Bool: total += rows; break;
+                    case protocol::ColumnType::Str:  total += rows * sizeof(uint32_t) + kStringOverheadBytes; break;
+                    case protocol::ColumnType::Err:  total += rows * sizeof(int16_t); break;
+                }
+            }
+            return total;
+        }
+        default:
+            return kAnyOverheadBytes + p.cells * (sizeof(uint32_t) + kBoxedCellBytes) + strBytes;
+    }
+}
+
+size_t EstimateSerializedSize(LPXLOPER12 op) {
+    if (!op) return 0;
+    const DWORD type = BaseXlType(*op);
+    if (type == xltypeStr) {
+        return kAnyOverheadBytes + StringBytes(op->val.str ? (size_t)op->val.str[0] : 0);
+    } else if (type == xltypeRef) {
+        const size_t rects = op->val.mref.lpmref ? (size_t)op->val.mref.lpmref->count : 0;
+        return kAnyOverheadBytes + kRangeNameBytes + rects * sizeof(protocol::Rect);
+    } else if (type == xltypeSRef) {
+        return kAnyOverheadBytes + kRangeNameBytes + sizeof(protocol::Rect);
+    } else if (type == xltypeMulti) {
+        GridProfile profile;
+        if (!ProfileGrid(*op, profile)) return kAnyOverheadBytes;
+        return EstimateArrayBytes(profile, SelectArrayEncoding(profile));
+    }
+    return kAnyOverheadBytes;
+}
 
-        if (allNums) {
-            // Create NumGrid
+void ReserveBuilder(flatbuffers::FlatBufferBuilder& builder, size_t bytes) {
+    // Public calls only: an uninitialized vector filling the reservation
+    // grows the buffer once, and Clear() drops it again while keeping the
+    // buffer. Rounding to the buffer alignment leaves room for exactly the
+    // vector's length prefix, so the vector never triggers a second growth.
+    // A builder that already holds data is left alone: nothing public takes
+    // bytes back off it.
+    if (builder.GetSize() != 0) return;
+    bytes = (bytes + sizeof(flatbuffers::largest_scalar_t) - 1) & ~(sizeof(flatbuffers::largest_scalar_t) - 1);
+    if (bytes <= sizeof(flatbuffers::uoffset_t)) return;
+    uint8_t* body = nullptr;
+    builder.CreateUninitializedVector(bytes - sizeof(flatbuffers::uoffset_t), 1, &body);
+    builder.Clear();
+}
+
+// Serializes a profiled xltypeMulti in the encoding SelectArrayEncoding picks.
+static flatbuffers::Offset<protocol::Any> ConvertProfiledMulti(const XLOPER12& op, const GridProfile& profile,
+                                                               flatbuffers::FlatBufferBuilder& builder,
+                                                               StringInterner* interner) {
+    const size_t count = profile.cells;
+    switch (SelectArrayEncoding(profile)) {
+        case protocol::AnyValue::NumGrid: {
             // Optimization: Use CreateUninitializedVector to write directly to FlatBuffer memory,
             // avoiding intermediate std::vector allocation and redundant copy.
             double* buf = nullptr;
@@ -326,16 +1101,78 @@ flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& op, flatbuf
             }
             auto ng = protocol::CreateNumGrid(builder, op.val.array.rows, op.val.array.columns, vec);
             return protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union());
-        } else {
-            auto g = ConvertGrid(const_cast<LPXLOPER12>(&op), builder);
+        }
+        case protocol::AnyValue::SparseGrid: {
+            auto sg = BuildSparseGrid(op, count, profile.Populated(), builder, interner);
+            return protocol::CreateAny(builder, protocol::AnyValue::SparseGrid, sg.Union());
+        }
+        case protocol::AnyValue::ColumnGrid: {
+            auto cg = BuildColumnGrid(op, profile.columnTypes, builder, interner);
+            return protocol::CreateAny(builder, protocol::AnyValue::ColumnGrid, cg.Union());
+        }
+        case protocol::AnyValue::NumGridEx: {
+            auto ng = BuildNumGridEx(op, count, count - profile.nums, builder, interner);
+            return protocol::CreateAny(builder, protocol::AnyValue::NumGridEx, ng.Union());
+        }
+        default: {
+            auto g = ConvertGrid(const_cast<LPXLOPER12>(&op), builder, interner);
             return protocol::CreateAny(builder, protocol::AnyValue::Grid, g.Union());
         }
+    }
+}
+
+// Helper for converting Multi to Any
+flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& op, flatbuffers::FlatBufferBuilder& builder) {
+    return ConvertMultiToAny(op, builder, nullptr);
+}
+
+flatbuffers::Offset<protocol::Any> ConvertMultiToAny(const XLOPER12& op, flatbuffers::FlatBufferBuilder& builder,
+                                                     StringInterner* interner) {
+    try {
+        GridProfile profile;
+        if (!ProfileGrid(op, profile)) {
+            // Invalid dimensions, or a non-empty array without lparray:
+            // fallback to empty Grid
+            return protocol::CreateAny(builder, protocol::AnyValue::Grid, protocol::CreateGrid(builder, 0, 0, 0).Union());
+        }
+        return ConvertProfiledMulti(op, profile, builder, interner);
+    } catch (...) {
+        return protocol::CreateAny(builder, protocol::AnyValue::Err,
+                                   protocol::CreateErr(builder, protocol::XlError::Unknown).Union());
+    }
+}
+
+flatbuffers::Offset<protocol::Any> ConvertAnyPresized(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder) {
+    try {
+        if (op && BaseXlType(*op) == xltypeMulti) {
+            // Profile once: the same scan sizes the builder and picks the encoding.
+            GridProfile profile;
+            if (ProfileGrid(*op, profile)) {
+                ReserveBuilder(builder, EstimateArrayBytes(profile, SelectArrayEncoding(profile)));
+                return ConvertProfiledMulti(*op, profile, builder, nullptr);
+            }
+        } else {
+            ReserveBuilder(builder, EstimateSerializedSize(op));
+        }
+        return ConvertAny(op, builder);
     } catch (...) {
         return protocol::CreateAny(builder, protocol::AnyValue::Err,
                                    protocol::CreateErr(builder, protocol::XlError::Unknown).Union());
     }
 }
 
+flatbuffers::Offset<protocol::Grid> ConvertGridPresized(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder) {
+    try {
+        GridProfile profile;
+        if (op && BaseXlType(*op) == xltypeMulti && ProfileGrid(*op, profile)) {
+            ReserveBuilder(builder, EstimateArrayBytes(profile, protocol::AnyValue::Grid));
+        }
+        return ConvertGrid(op, builder);
+    } catch (...) {
+        return protocol::CreateGrid(builder, 0, 0, 0);
+    }
+}
+
 flatbuffers::Offset<protocol::Any> ConvertAny(LPXLOPER12 op, flatbuffers::FlatBufferBuilder& builder) {
     try {
         // Mask ownership bits so XLOPER12s produced by our own
@@ -353,7 +1190,7 @@ flatbuffers::Offset<protocol::Any> ConvertAny(LPXLOPER12 op, flatbuffers::FlatBu
                                        protocol::CreateBool(builder, op->val.xbool).Union());
         } else if (type == xltypeStr) {
             return protocol::CreateAny(builder, protocol::AnyValue::Str,
-                                       protocol::CreateStr(builder, builder.CreateString(ConvertExcelString(op->val.str)))
+                                       protocol::CreateStr(builder, CreateStringFromExcel(builder, op->val.str))
                                            .Union());
         } else if (type == xltypeErr) {
             return protocol::CreateAny(builder, protocol::AnyValue::Err,
@@ -376,7 +1213,144 @@ flatbuffers::Offset<protocol::Any> ConvertAny(LPXLOPER12 op, flatbuffers::FlatBu
 
 // FlatBuffers -> Excel Converters
 
+// --- Dense numeric fill -----------------------------------------------------
+// NumGrid and NumGridEx carry their numbers as one contiguous little-endian
+// double vector. FillNumCells streams it into the strided xltypeMulti array.
+// The SIMD paths write each XLOPER12 whole (value, the rest of the union and
+// the xltype word) from a template cell, so the target needs no memset; they
+// are compiled for the 64-bit layout only (32-byte cell, xltype at 24).
+
+static const bool kNumCellSimdLayout = sizeof(XLOPER12) == 32 && offsetof(XLOPER12, xltype) == 24;
+
+static XLOPER12 NumCellTemplate() {
+    XLOPER12 cell;
+    std::memset(&cell, 0, sizeof(cell));
+    cell.xltype = xltypeNum;
+    return cell;
+}
+
+static void FillNumCellsScalar(const double* src, size_t n, XLOPER12* dst) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i].xltype = xltypeNum;
+        std::memcpy(&dst[i].val.num, src + i, sizeof(double)); // src may be unaligned
+    }
+}
+
+#if defined(TYPES_SIMD_SSE2)
+// Arrays at least this large are written with non-temporal stores: they do
+// not fit in cache anyway, and streaming whole lines skips reading each line
+// in before overwriting it.
+static const size_t kNumCellStreamBytes = (size_t)1 << 20;
+
+static bool UseStreamingStores(size_t n, const XLOPER12* dst, size_t align) {
+    return n * sizeof(XLOPER12) >= kNumCellStreamBytes && reinterpret_cast<uintptr_t>(dst) % align == 0;
+}
+
+// Two 16-byte stores per cell: the value zero-extended, then the constant
+// upper half holding the xltype word.
+static void FillNumCellsSse2(const double* src, size_t n, XLOPER12* dst) {
+    const XLOPER12 tmpl = NumCellTemplate();
+    const __m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(reinterpret_cast<const char*>(&tmpl) + 16));
+    __m128i* out = reinterpret_cast<__m128i*>(dst);
+    for (size_t i = 0; i < n; ++i, out += 2) {
+        _mm_storeu_si128(out, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm_storeu_si128(out + 1, upper);
+    }
+}
+#endif
+
+#if defined(TYPES_SIMD_AVX2)
+// One 32-byte store per cell: the value broadcast and blended into lane 0 of
+// the template. Only for 32-byte-aligned arrays (the arena's); elsewhere
+// every other store would straddle a cache line.
+TYPES_TARGET_AVX2 static void FillNumCellsAvx2(const double* src, size_t n, XLOPER12* dst) {
+    const XLOPER12 tmpl = NumCellTemplate();
+    const __m256d cell = _mm256_loadu_pd(reinterpret_cast<const double*>(&tmpl));
+    double* out = reinterpret_cast<double*>(dst);
+    if (UseStreamingStores(n, dst, 32)) {
+        for (size_t i = 0; i < n; ++i, out += 4) {
+            _mm256_stream_pd(out, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i), 0x1));
+        }
+        _mm_sfence();
+        return;
+    }
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4, out += 16) {
+        _mm256_store_pd(out, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i), 0x1));
+        _mm256_store_pd(out + 4, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i + 1), 0x1));
+        _mm256_store_pd(out + 8, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i + 2), 0x1));
+        _mm256_store_pd(out + 12, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i + 3), 0x1));
+    }
+    for (; i < n; ++i, out += 4) {
+        _mm256_store_pd(out, _mm256_blend_pd(cell, _mm256_broadcast_sd(src + i), 0x1));
+    }
+}
+#endif
+
+// Fills dst[0..count) with xltypeNum cells from `count` little-endian doubles
+// at `le` (any alignment). On a big-endian target the payload is not native
+// doubles, so each value is byte-swapped on the way instead.
+static void FillNumCells(const uint8_t* le, size_t count, XLOPER12* dst) {
+#if FLATBUFFERS_LITTLEENDIAN
+    const double* src = reinterpret_cast<const double*>(le);
+#if defined(TYPES_SIMD_AVX2)
+    if (kNumCellSimdLayout && reinterpret_cast<uintptr_t>(dst) % 32 == 0 && CpuHasAvx2()) {
+        FillNumCellsAvx2(src, count, dst);
+        return;
+    }
+#endif
+#if defined(TYPES_SIMD_SSE2)
+    if (kNumCellSimdLayout) {
+        FillNumCellsSse2(src, count, dst);
+        return;
+    }
+#endif
+    FillNumCellsScalar(src, count, dst);
+#else
+    for (size_t i = 0; i < count; ++i) {
+        dst[i].xltype = xltypeNum;
+        dst[i].val.num = flatbuffers::ReadScalar<double>(le + i * sizeof(double));
+    }
+#endif
+}
+
+// The FP12 image of a NumGrid using the `fp12` layout, or null when the field
+// is absent or does not describe exactly rows x cols doubles (header matching
+// the table's rows/cols). Alignment is the caller's concern.
+static const uint8_t* NumGridFP12Image(const protocol::NumGrid* grid) {
+    const auto* image = grid->fp12();
+    if (!image) return nullptr;
+    size_t count = 0;
+    if (!ValidateGridDims(grid->rows(), grid->cols(), &count)) return nullptr;
+    if (count > (SIZE_MAX - offsetof(FP12, array)) / sizeof(double) ||
+        image->size() != offsetof(FP12, array) + count * sizeof(double)) {
+        return nullptr;
+    }
+    const uint8_t* bytes = image->data();
+    if (flatbuffers::ReadScalar<int32_t>(bytes) != grid->rows() ||
+        flatbuffers::ReadScalar<int32_t>(bytes + sizeof(int32_t)) != grid->cols()) {
+        return nullptr;
+    }
+    return bytes;
+}
+
+// The little-endian doubles of a NumGrid holding at least `count` cells:
+// the FP12 image body when that layout is used, else the `data` vector.
+// Null when neither qualifies.
+static const uint8_t* NumGridValues(const protocol::NumGrid* grid, size_t count) {
+    if (grid->fp12()) {
+        const uint8_t* image = NumGridFP12Image(grid);
+        return image ? image + offsetof(FP12, array) : nullptr;
+    }
+    if (!grid->data() || grid->data()->size() < count) return nullptr;
+    return grid->data()->Data();
+}
+
 LPXLOPER12 AnyToXLOPER12(const protocol::Any* any) {
+    return AnyToXLOPER12(any, XlGridAlloc::PerCell);
+}
+
+LPXLOPER12 AnyToXLOPER12(const protocol::Any* any, XlGridAlloc gridAlloc) {
     try {
         if (!any) {
             return MakeNilXLOPER12();
@@ -390,7 +1364,7 @@ LPXLOPER12 AnyToXLOPER12(const protocol::Any* any) {
         // When it does: add a case here, in ConvertAny, and in deepcopy.go's
         // AnyValue switch, then bump the expected MAX. Adding a member without
         // touching the ladders must never compile clean.
-        static_assert(protocol::AnyValue::MAX == protocol::AnyValue::Date,
+        static_assert(protocol::AnyValue::MAX == protocol::AnyValue::SparseGrid,
                       "protocol::AnyValue changed: update AnyToXLOPER12, ConvertAny, "
                       "and go/protocol/deepcopy.go (AnyValue switch), then bump this assert.");
 
@@ -415,7 +1389,7 @@ LPXLOPER12 AnyToXLOPER12(const protocol::Any* any) {
                  return MakeErrXLOPER12(ProtocolErrorToExcel(any->val_as_Err()->val()));
             }
             case protocol::AnyValue::Grid: {
-                 return GridToXLOPER12(any->val_as_Grid());
+                 return GridToXLOPER12(any->val_as_Grid(), gridAlloc);
             }
             case protocol::AnyValue::NumGrid: {
                  const protocol::NumGrid* ng = any->val_as_NumGrid();
@@ -423,8 +1397,9 @@ LPXLOPER12 AnyToXLOPER12(const protocol::Any* any) {
                  int cols = ng->cols();
 
                  size_t count = 0;
+                 const uint8_t* values = nullptr;
                  if (!ValidateGridAlloc(rows, cols, sizeof(XLOPER12), 0, &count) ||
-                     !ng->data() || ng->data()->size() < count) {
+                     !(values = NumGridValues(ng, count))) {
                      return MakeErrXLOPER12(xlerrValue);
                  }
 
@@ -435,29 +1410,40 @@ LPXLOPER12 AnyToXLOPER12(const protocol::Any* any) {
                  op->val.array.lparray = nullptr;
 
                  // BUG-017: Guard must be declared before allocation to protect 'op'
-                 // NOTE (R28): stays array-only `delete[]` — does NOT call
+                 // NOTE (R28): stays array-only (FreeXLOPER12Array) — does NOT call
                  // FreeDllOwnedContents. This numeric grid is NOT memset after
                  // new[] (it is filled in the loop below), so on a mid-fill throw
                  // the unreached elements have indeterminate xltype; an element
                  // free loop would read garbage. The elements are all xltypeNum
                  // (no DLL-owned strings) anyway, so array-only is both correct
-                 // and sufficient here.
+                 // and sufficient here. An arena block is returned through
+                 // FreeDllOwnedContents, which frees registered blocks without
+                 // walking them.
+                 const bool inArena = XlArenaEnabled();
                  ScopeGuard guard([&]() {
-                     if (op->val.array.lparray) delete[] op->val.array.lparray;
+                     if (inArena) FreeDllOwnedContents(op);
+                     else FreeXLOPER12Array(op->val.array.lparray, count);
                      ReleaseXLOPER12(op);
                  });
 
-                 op->val.array.lparray = new XLOPER12[count];
+                 // FillNumCells writes every element, so the arena block is
+                 // taken as raw payload (no element zeroing).
+                 op->val.array.lparray = inArena ? NewXLOPER12Slab(0, count * sizeof(XLOPER12)) : NewXLOPER12Array(count);
 
-                 auto data = ng->data();
-                 for(size_t i=0; i<count; ++i) {
-                     op->val.array.lparray[i].xltype = xltypeNum;
-                     op->val.array.lparray[i].val.num = data->Get((flatbuffers::uoffset_t)i);
-                 }
+                 FillNumCells(values, count, op->val.array.lparray);
 
                  guard.Dismiss();
                  return op;
             }
+            case protocol::AnyValue::ColumnGrid: {
+                return ColumnGridToXLOPER12(any->val_as_ColumnGrid());
+            }
+            case protocol::AnyValue::NumGridEx: {
+                return NumGridExToXLOPER12(any->val_as_NumGridEx());
+            }
+            case protocol::AnyValue::SparseGrid: {
+                return SparseGridToXLOPER12(any->val_as_SparseGrid());
+            }
             case protocol::AnyValue::Range: {
                 return RangeToXLOPER12(any->val_as_Range());
             }
@@ -502,26 +1488,29 @@ LPXLOPER12 RangeToXLOPER12(const protocol::Range* range) {
         size_t refs_count = range->refs()->size();
 
         // Guard against leaks if new throws
-        // BUG-014: Ensure lpmref is freed if set
+        // BUG-014: Ensure lpmref is freed if set (heap or arena, see NewXLMREF12)
         ScopeGuard guard([&]() {
-            if (op->val.mref.lpmref) {
-                 delete[] (char*)op->val.mref.lpmref;
-            }
+            FreeDllOwnedContents(op);
             ReleaseXLOPER12(op);
         });
 
+        std::vector<XLREF12> refs(refs_count);
+        for(size_t i=0; i<refs_count; ++i) {
+            const auto* r = range->refs()->Get(i);
+            refs[i].rwFirst = r->row_first();
+            refs[i].rwLast = r->row_last();
+            refs[i].colFirst = r->col_first();
+            refs[i].colLast = r->col_last();
+        }
+        // Coalesced before sizing the XLMREF12, so fewer areas reach Excel.
+        if (refs_count > 1 && RectCoalescingEnabled()) refs_count = CoalesceRefs(refs.data(), refs_count);
+
         // XLMREF12 struct has 1 ref. We need space for (refs_count) refs in total.
-        op->val.mref.lpmref = (LPXLMREF12) new char[sizeof(XLMREF12) + sizeof(XLREF12) * refs_count];
+        op->val.mref.lpmref = NewXLMREF12(refs_count);
         op->val.mref.idSheet = 0;
 
         op->val.mref.lpmref->count = (WORD)refs_count;
-        for(size_t i=0; i<refs_count; ++i) {
-            const auto* r = range->refs()->Get(i);
-            op->val.mref.lpmref->reftbl[i].rwFirst = r->row_first();
-            op->val.mref.lpmref->reftbl[i].rwLast = r->row_last();
-            op->val.mref.lpmref->reftbl[i].colFirst = r->col_first();
-            op->val.mref.lpmref->reftbl[i].colLast = r->col_last();
-        }
+        std::copy(refs.begin(), refs.begin() + refs_count, op->val.mref.lpmref->reftbl);
 
         guard.Dismiss();
         return op;
@@ -530,7 +1519,118 @@ LPXLOPER12 RangeToXLOPER12(const protocol::Range* range) {
     }
 }
 
+// Writes one protocol::Scalar into an xltypeMulti element; shared by every
+// FlatBuffers -> array path. Unknown tags leave the element xltypeNil.
+static void ScalarToCell(const protocol::Scalar* scalar, XLOPER12& cell) {
+    // Completeness guard (R29). Per-cell union-tag switch; an unknown tag
+    // leaves the cell xltypeNil (the default below) — a silent drop. This
+    // assert fires when a ScalarValue member is appended (MAX moves); when
+    // it does, add a case here, in ConvertScalar, and in deepcopy.go's
+    // ScalarValue switch, then bump the expected MAX.
+    static_assert(protocol::ScalarValue::MAX == protocol::ScalarValue::Date,
+                  "protocol::ScalarValue changed: update ScalarToCell's switch, "
+                  "ConvertScalar, and go/protocol/deepcopy.go (ScalarValue switch), then bump this assert.");
+
+    cell.xltype = xltypeNil; // Default
+
+    switch(scalar->val_type()) {
+        case protocol::ScalarValue::Num:
+            cell.xltype = xltypeNum;
+            cell.val.num = scalar->val_as_Num()->val();
+            break;
+        case protocol::ScalarValue::Date:
+            cell.xltype = xltypeNum;
+            cell.val.num = scalar->val_as_Date()->serial();
+            break;
+        case protocol::ScalarValue::Int:
+            cell.xltype = xltypeInt;
+            cell.val.w = scalar->val_as_Int()->val();
+            break;
+        case protocol::ScalarValue::Bool:
+            cell.xltype = xltypeBool;
+            cell.val.xbool = scalar->val_as_Bool()->val();
+            break;
+        case protocol::ScalarValue::Str: {
+            // xlbitDLLFree on the element marks the string as
+            // DLL-owned: xlAutoFree12 (and the callers' guards) only
+            // free element strings carrying this bit. Excel
+            // ignores the bit on inner elements, so it is purely
+            // our ownership marker; our own readers (ConvertScalar,
+            // ConvertMultiToAny, ConvertAny) mask it before type
+            // dispatch. val.str is nulled first so a throwing
+            // allocation never leaves the bit over a stale value.
+            cell.val.str = nullptr;
+            cell.xltype = xltypeStr | xlbitDLLFree;
+            const auto* fbStr = scalar->val_as_Str()->val();
+            const char* utf8 = fbStr ? fbStr->c_str() : nullptr;
+            cell.val.str = Utf8ToExcelStringBuffer(utf8);
+            break;
+        }
+        case protocol::ScalarValue::Err:
+            cell.xltype = xltypeErr;
+            cell.val.err = ProtocolErrorToExcel(scalar->val_as_Err()->val());
+            break;
+        default:
+            break;
+    }
+}
+
 LPXLOPER12 GridToXLOPER12(const protocol::Grid* grid) {
+    return GridToXLOPER12(grid, XlGridAlloc::PerCell);
+}
+
+// Slab room for one string body. A UTF-8 byte never yields more than one
+// UTF-16 unit, so the clamped byte length bounds the body.
+static size_t SlabStrUnits(const flatbuffers::String* fbStr) {
+    return WritePascalWBufferLen(fbStr ? fbStr->size() : 0);
+}
+
+static size_t SlabScalarUnits(const protocol::Scalar* s) {
+    if (s->val_type() != protocol::ScalarValue::Str) return 0;
+    return SlabStrUnits(s->val_as_Str()->val());
+}
+
+// Same decode as Utf8ToExcelString (NUL-terminated, clamped), into the slab
+// at `next` instead of a buffer of its own. The body belongs to the slab, so
+// the cell carries no xlbitDLLFree.
+static void SlabStrCell(const flatbuffers::String* fbStr, XLOPER12& cell, XCHAR*& next) {
+    const char* utf8 = fbStr ? fbStr->c_str() : "";
+    const size_t bytes = std::strlen(utf8);
+    const size_t len = StampPascalWString(next, Utf8ToUtf16(utf8, bytes, next + 1, ClampExcelStringLen(bytes)));
+    cell.xltype = xltypeStr;
+    cell.val.str = next;
+    next += len + 2;
+}
+
+// ScalarToCell for a slab-allocated multi: strings go through SlabStrCell.
+static void SlabScalarCell(const protocol::Scalar* s, XLOPER12& cell, XCHAR*& next) {
+    if (s->val_type() == protocol::ScalarValue::Str) {
+        SlabStrCell(s->val_as_Str()->val(), cell, next);
+    } else {
+        ScalarToCell(s, cell);
+    }
+}
+
+// Fills the elements of a slab-allocated multi. A pre-pass sizes every string
+// body, then one NewXLOPER12Slab block takes the elements followed by the
+// bodies, which are decoded straight into place.
+static void FillGridSlab(const protocol::Grid* grid, size_t count, LPXLOPER12 op) {
+    const auto* data = grid->data();
+    size_t units = 0;
+    for (size_t i = 0; i < count; ++i) {
+        units += SlabScalarUnits(data->Get((flatbuffers::uoffset_t)i));
+    }
+
+    XLOPER12* cells = NewXLOPER12Slab(count, units * sizeof(XCHAR));
+    op->val.array.lparray = cells;
+    XCHAR* next = reinterpret_cast<XCHAR*>(cells + count);
+
+    for (size_t i = 0; i < count; ++i) {
+        SlabScalarCell(data->Get((flatbuffers::uoffset_t)i), cells[i], next);
+    }
+}
+
+LPXLOPER12 GridToXLOPER12(const protocol::Grid* grid, XlGridAlloc alloc) {
     if (!grid) {
         return MakeErrXLOPER12(xlerrValue);
     }
@@ -564,60 +1664,276 @@ LPXLOPER12 GridToXLOPER12(const protocol::Grid* grid) {
     });
 
     try {
-        op->val.array.lparray = new XLOPER12[count];
-        std::memset(op->val.array.lparray, 0, count * sizeof(XLOPER12));
-
-        // Completeness guard (R29). Per-cell union-tag switch; an unknown tag
-        // leaves the cell xltypeNil (the default above) — a silent drop. This
-        // assert fires when a ScalarValue member is appended (MAX moves); when
-        // it does, add a case here, in ConvertScalar, and in deepcopy.go's
-        // ScalarValue switch, then bump the expected MAX.
-        static_assert(protocol::ScalarValue::MAX == protocol::ScalarValue::Date,
-                      "protocol::ScalarValue changed: update GridToXLOPER12's per-cell switch, "
-                      "ConvertScalar, and go/protocol/deepcopy.go (ScalarValue switch), then bump this assert.");
+        // Under the XLOPER12 arena the slab layout is always used: the whole
+        // result is then one arena block.
+        if (alloc == XlGridAlloc::Slab || XlArenaEnabled()) {
+            FillGridSlab(grid, count, op);
+        } else {
+            op->val.array.lparray = NewXLOPER12Array(count);
+            std::memset(op->val.array.lparray, 0, count * sizeof(XLOPER12));
 
-        for (size_t i = 0; i < count; ++i) {
-            auto scalar = grid->data()->Get((flatbuffers::uoffset_t)i);
-            auto& cell = op->val.array.lparray[i];
-            cell.xltype = xltypeNil; // Default
-
-            switch(scalar->val_type()) {
-                case protocol::ScalarValue::Num:
-                    cell.xltype = xltypeNum;
-                    cell.val.num = scalar->val_as_Num()->val();
-                    break;
-                case protocol::ScalarValue::Date:
-                    cell.xltype = xltypeNum;
-                    cell.val.num = scalar->val_as_Date()->serial();
-                    break;
-                case protocol::ScalarValue::Int:
-                    cell.xltype = xltypeInt;
-                    cell.val.w = scalar->val_as_Int()->val();
-                    break;
-                case protocol::ScalarValue::Bool:
-                    cell.xltype = xltypeBool;
-                    cell.val.xbool = scalar->val_as_Bool()->val();
-                    break;
-                case protocol::ScalarValue::Str: {
-                    // xlbitDLLFree on the element marks the string as
-                    // DLL-owned: xlAutoFree12 (and the guard above) only
-                    // delete[] element strings carrying this bit. Excel
-                    // ignores the bit on inner elements, so it is purely
-                    // our ownership marker; our own readers (ConvertScalar,
-                    // ConvertMultiToAny, ConvertAny) mask it before type
-                    // dispatch.
-                    cell.xltype = xltypeStr | xlbitDLLFree;
-                    const auto* fbStr = scalar->val_as_Str()->val();
-                    const char* utf8 = fbStr ? fbStr->c_str() : nullptr;
-                    Utf8ToExcelString(utf8, cell.val.str);
-                    break;
+            for (size_t i = 0; i < count; ++i) {
+                ScalarToCell(grid->data()->Get((flatbuffers::uoffset_t)i), op->val.array.lparray[i]);
+            }
+        }
+    } catch (...) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    guard.Dismiss();
+    return op;
+}
+
+// Checks an (index, Scalar) cell table over `count` cells, as carried by
+// NumGridEx and SparseGrid: every index paired with a value, in range and
+// strictly increasing. A repeated index would overwrite (and leak) a string
+// patched in earlier. Absent vectors are an empty table. On success *outN
+// holds the number of entries.
+static bool ValidateCellIndex(const flatbuffers::Vector<uint32_t>* index,
+                              const flatbuffers::Vector<flatbuffers::Offset<protocol::Scalar>>* values,
+                              size_t count, flatbuffers::uoffset_t* outN) {
+    const flatbuffers::uoffset_t n = index ? index->size() : 0;
+    *outN = 0;
+    if ((values ? values->size() : 0) != n) return false;
+    for (flatbuffers::uoffset_t k = 0; k < n; ++k) {
+        uint32_t idx = index->Get(k);
+        if (idx >= count || (k > 0 && idx <= index->Get(k - 1))) return false;
+    }
+    *outN = n;
+    return true;
+}
+
+LPXLOPER12 NumGridExToXLOPER12(const protocol::NumGridEx* grid) {
+    if (!grid) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    int rows = grid->rows();
+    int cols = grid->cols();
+
+    size_t count = 0;
+    if (!ValidateGridAlloc(rows, cols, sizeof(XLOPER12), 0, &count) ||
+        !grid->data() || grid->data()->size() != count) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    const auto* excIndex = grid->exc_index();
+    const auto* excValues = grid->exc_values();
+    flatbuffers::uoffset_t excCount = 0;
+    if (!ValidateCellIndex(excIndex, excValues, count, &excCount)) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    LPXLOPER12 op = NewXLOPER12();
+    op->xltype = xltypeMulti | xlbitDLLFree;
+    op->val.array.rows = rows;
+    op->val.array.columns = cols;
+
+    // Same guard as GridToXLOPER12. FreeDllOwnedContents' precondition holds
+    // without a memset: the bulk fill below cannot throw, so by the time the
+    // first throw point (a patched string) is reached every element is a
+    // fully-built xltypeNum.
+    ScopeGuard guard([&]() {
+        FreeDllOwnedContents(op);
+        ReleaseXLOPER12(op);
+    });
+
+    try {
+        if (XlArenaEnabled()) {
+            // One slab block, as in GridToXLOPER12, taken as raw payload:
+            // FillNumCells writes every element, and the exception strings
+            // are decoded after the elements.
+            size_t units = 0;
+            for (flatbuffers::uoffset_t k = 0; k < excCount; ++k) units += SlabScalarUnits(excValues->Get(k));
+            XLOPER12* cells = NewXLOPER12Slab(0, count * sizeof(XLOPER12) + units * sizeof(XCHAR));
+            op->val.array.lparray = cells;
+            XCHAR* next = reinterpret_cast<XCHAR*>(cells + count);
+            FillNumCells(grid->data()->Data(), count, cells);
+            for (flatbuffers::uoffset_t k = 0; k < excCount; ++k) {
+                SlabScalarCell(excValues->Get(k), cells[excIndex->Get(k)], next);
+            }
+        } else {
+            op->val.array.lparray = NewXLOPER12Array(count);
+
+            // Bulk-fill the numbers, then patch the exceptions over them.
+            XLOPER12* cells = op->val.array.lparray;
+            FillNumCells(grid->data()->Data(), count, cells);
+            for (flatbuffers::uoffset_t k = 0; k < excCount; ++k) {
+                ScalarToCell(excValues->Get(k), cells[excIndex->Get(k)]);
+            }
+        }
+    } catch (...) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    guard.Dismiss();
+    return op;
+}
+
+LPXLOPER12 SparseGridToXLOPER12(const protocol::SparseGrid* grid) {
+    if (!grid) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    int rows = grid->rows();
+    int cols = grid->cols();
+
+    size_t count = 0;
+    flatbuffers::uoffset_t n = 0;
+    if (!ValidateGridAlloc(rows, cols, sizeof(XLOPER12), 0, &count) ||
+        !ValidateCellIndex(grid->index(), grid->values(), count, &n)) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    LPXLOPER12 op = NewXLOPER12();
+    op->xltype = xltypeMulti | xlbitDLLFree;
+    op->val.array.rows = rows;
+    op->val.array.columns = cols;
+
+    // Same guard as NumGridExToXLOPER12: the fill cannot throw, so every
+    // element is a fully-built xltypeNil before the first string is patched.
+    ScopeGuard guard([&]() {
+        FreeDllOwnedContents(op);
+        ReleaseXLOPER12(op);
+    });
+
+    try {
+        // Under the XLOPER12 arena the elements and the value strings share
+        // one slab block, as in GridToXLOPER12; every element is filled
+        // below, so it is taken as raw payload.
+        const bool inArena = XlArenaEnabled();
+        size_t units = 0;
+        if (inArena) {
+            for (flatbuffers::uoffset_t k = 0; k < n; ++k) units += SlabScalarUnits(grid->values()->Get(k));
+        }
+        op->val.array.lparray = inArena ? NewXLOPER12Slab(0, count * sizeof(XLOPER12) + units * sizeof(XCHAR))
+                                        : NewXLOPER12Array(count);
+
+        XLOPER12 nil;
+        std::memset(&nil, 0, sizeof(nil));
+        nil.xltype = xltypeNil;
+        std::fill_n(op->val.array.lparray, count, nil);
+
+        XCHAR* next = reinterpret_cast<XCHAR*>(op->val.array.lparray + count);
+        for (flatbuffers::uoffset_t k = 0; k < n; ++k) {
+            XLOPER12& cell = op->val.array.lparray[grid->index()->Get(k)];
+            if (inArena) SlabScalarCell(grid->values()->Get(k), cell, next);
+            else ScalarToCell(grid->values()->Get(k), cell);
+        }
+    } catch (...) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    guard.Dismiss();
+    return op;
+}
+
+// True when `col` carries the typed vector its type names with exactly `rows`
+// values, and a null bitmap (if any) covering every row.
+static bool ColumnFitsRows(const protocol::Column* col, int rows) {
+    if (!col) return false;
+    const size_t n = (size_t)rows;
+    if (col->nulls() && col->nulls()->size() < (n + 7) / 8) return false;
+    switch (col->type()) {
+        case protocol::ColumnType::Num:  return col->nums() && col->nums()->size() == n;
+        case protocol::ColumnType::Int:  return col->ints() && col->ints()->size() == n;
+        case protocol::ColumnType::Bool: return col->bools() && col->bools()->size() == n;
+        case protocol::ColumnType::Str:  return col->strs() && col->strs()->size() == n;
+        case protocol::ColumnType::Err:  return col->errs() && col->errs()->size() == n;
+        default:                         return false;
+    }
+}
+
+LPXLOPER12 ColumnGridToXLOPER12(const protocol::ColumnGrid* grid) {
+    if (!grid) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+
+    int rows = grid->rows();
+    int cols = grid->cols();
+
+    size_t count = 0;
+    if (!ValidateGridAlloc(rows, cols, sizeof(XLOPER12), 0, &count) ||
+        !grid->columns() || grid->columns()->size() != (flatbuffers::uoffset_t)cols) {
+        return MakeErrXLOPER12(xlerrValue);
+    }
+    // Check every column before allocating, so the fill below cannot stop
+    // part way through a malformed payload.
+    for (int c = 0; c < cols; ++c) {
+        if (!ColumnFitsRows(grid->columns()->Get((flatbuffers::uoffset_t)c), rows)) {
+            return MakeErrXLOPER12(xlerrValue);
+        }
+    }
+
+    LPXLOPER12 op = NewXLOPER12();
+    op->xltype = xltypeMulti | xlbitDLLFree;
+    op->val.array.rows = rows;
+    op->val.array.columns = cols;
+
+    // Same ownership contract and guard as GridToXLOPER12: only string cells
+    // carrying xlbitDLLFree are ours, and lparray is memset before any fill.
+    ScopeGuard guard([&]() {
+        FreeDllOwnedContents(op);
+        ReleaseXLOPER12(op);
+    });
+
+    try {
+        // Under the XLOPER12 arena the elements and the Str column bodies
+        // share one slab block (zeroed elements), as in GridToXLOPER12.
+        const bool inArena = XlArenaEnabled();
+        if (inArena) {
+            size_t units = 0;
+            for (int c = 0; c < cols; ++c) {
+                const protocol::Column* col = grid->columns()->Get((flatbuffers::uoffset_t)c);
+                if (col->type() != protocol::ColumnType::Str) continue;
+                for (int r = 0; r < rows; ++r) units += SlabStrUnits(col->strs()->Get((flatbuffers::uoffset_t)r));
+            }
+            op->val.array.lparray = NewXLOPER12Slab(count, units * sizeof(XCHAR));
+        } else {
+            op->val.array.lparray = NewXLOPER12Array(count);
+            std::memset(op->val.array.lparray, 0, count * sizeof(XLOPER12));
+        }
+        XCHAR* next = reinterpret_cast<XCHAR*>(op->val.array.lparray + count);
+
+        for (int c = 0; c < cols; ++c) {
+            const protocol::Column* col = grid->columns()->Get((flatbuffers::uoffset_t)c);
+            const auto* nulls = col->nulls();
+            for (int r = 0; r < rows; ++r) {
+                auto& cell = op->val.array.lparray[(size_t)r * cols + c];
+                const flatbuffers::uoffset_t i = (flatbuffers::uoffset_t)r;
+                if (nulls && ((nulls->Get(i / 8) >> (i % 8)) & 1)) {
+                    cell.xltype = xltypeNil;
+                    continue;
+                }
+                switch (col->type()) {
+                    case protocol::ColumnType::Num:
+                        cell.xltype = xltypeNum;
+                        cell.val.num = col->nums()->Get(i);
+                        break;
+                    case protocol::ColumnType::Int:
+                        cell.xltype = xltypeInt;
+                        cell.val.w = col->ints()->Get(i);
+                        break;
+                    case protocol::ColumnType::Bool:
+                        cell.xltype = xltypeBool;
+                        cell.val.xbool = col->bools()->Get(i) ? 1 : 0;
+                        break;
+                    case protocol::ColumnType::Str: {
+                        const auto* fbStr = col->strs()->Get(i);
+                        if (inArena) {
+                            SlabStrCell(fbStr, cell, next);
+                            break;
+                        }
+                        // DLL-owned element string; see GridToXLOPER12.
+                        cell.xltype = xltypeStr | xlbitDLLFree;
+                        cell.val.str = Utf8ToExcelStringBuffer(fbStr ? fbStr->c_str() : nullptr);
+                        break;
+                    }
+                    case protocol::ColumnType::Err:
+                        cell.xltype = xltypeErr;
+                        cell.val.err = ProtocolErrorToExcel((protocol::XlError)col->errs()->Get(i));
+                        break;
                 }
-                case protocol::ScalarValue::Err:
-                    cell.xltype = xltypeErr;
-                    cell.val.err = ProtocolErrorToExcel(scalar->val_as_Err()->val());
-                    break;
-                default:
-                    break;
             }
         }
     } catch (...) {
@@ -645,6 +1961,25 @@ static std::wstring DateFormatOf(const protocol::Date* d) {
     return AutoDateFormat(d->serial());
 }
 
+// One DateCell per Date value of an (index, Scalar) cell table (NumGridEx
+// exceptions, SparseGrid cells) over a grid `cols` wide.
+static void CollectIndexedDateCells(const flatbuffers::Vector<uint32_t>* index,
+                                    const flatbuffers::Vector<flatbuffers::Offset<protocol::Scalar>>* values,
+                                    int cols, std::vector<DateCell>& out) {
+    if (cols <= 0 || !index || !values || index->size() != values->size()) return;
+    for (flatbuffers::uoffset_t k = 0; k < index->size(); ++k) {
+        const protocol::Scalar* s = values->Get(k);
+        if (s && s->val_type() == protocol::ScalarValue::Date) {
+            uint32_t idx = index->Get(k);
+            DateCell c;
+            c.rowOff = (int)(idx / (uint32_t)cols);
+            c.colOff = (int)(idx % (uint32_t)cols);
+            c.format = DateFormatOf(s->val_as_Date());
+            out.push_back(c);
+        }
+    }
+}
+
 void CollectDateCells(const protocol::Any* any, std::vector<DateCell>& out) {
     if (!any) return;
     try {
@@ -659,6 +1994,15 @@ void CollectDateCells(const protocol::Any* any, std::vector<DateCell>& out) {
         if (any->val_type() == protocol::AnyValue::Grid) {
             CollectDateCells(any->val_as_Grid(), out);
         }
+        if (any->val_type() == protocol::AnyValue::NumGridEx) {
+            // Only the exceptions can be Dates; the dense part is numbers.
+            const protocol::NumGridEx* ng = any->val_as_NumGridEx();
+            CollectIndexedDateCells(ng->exc_index(), ng->exc_values(), ng->cols(), out);
+        }
+        if (any->val_type() == protocol::AnyValue::SparseGrid) {
+            const protocol::SparseGrid* sg = any->val_as_SparseGrid();
+            CollectIndexedDateCells(sg->index(), sg->values(), sg->cols(), out);
+        }
     } catch (...) {
         out.clear(); // never throw into the wrapper; collection failure => no auto-format
     }
@@ -685,6 +2029,20 @@ void CollectDateCells(const protocol::Grid* g, std::vector<DateCell>& out) {
     }
 }
 
+const FP12* NumGridAsFP12(const protocol::NumGrid* grid) {
+#if FLATBUFFERS_LITTLEENDIAN
+    if (!grid) return nullptr;
+    const uint8_t* image = NumGridFP12Image(grid);
+    // The message buffer itself may sit at any address; only an image that
+    // is double-aligned in memory can be handed out as an FP12.
+    if (!image || reinterpret_cast<uintptr_t>(image) % alignof(double) != 0) return nullptr;
+    return reinterpret_cast<const FP12*>(image);
+#else
+    (void)grid;
+    return nullptr; // the image's doubles are little-endian, not native
+#endif
+}
+
 FP12* NumGridToFP12(const protocol::NumGrid* grid) {
     try {
         if (!grid) return NewFP12(0, 0);
@@ -692,21 +2050,26 @@ FP12* NumGridToFP12(const protocol::NumGrid* grid) {
         int cols = grid->cols();
 
         size_t count = 0;
+        const uint8_t* values = nullptr;
         if (!ValidateGridAlloc(rows, cols, sizeof(double), 2*sizeof(int), &count) ||
-            !grid->data() || grid->data()->size() != count) {
+            (!grid->fp12() && (!grid->data() || grid->data()->size() != count)) ||
+            !(values = NumGridValues(grid, count))) {
             // Return 0x0
             return NewFP12(0, 0);
         }
 
         FP12* fp = NewFP12(rows, cols);
 
-        const auto* data = grid->data();
-        if (data) {
-             // Optimization: Use memcpy for bulk copy of doubles
-             // FlatBuffers stores vector data contiguously in little-endian.
-             // On x86/ARM little-endian systems, this is a direct copy.
-             std::memcpy(fp->array, data->data(), count * sizeof(double));
+        // Optimization: Use memcpy for bulk copy of doubles
+        // FlatBuffers stores vector data contiguously in little-endian.
+        // On x86/ARM little-endian systems, this is a direct copy.
+#if FLATBUFFERS_LITTLEENDIAN
+        std::memcpy(fp->array, values, count * sizeof(double));
+#else
+        for (size_t i = 0; i < count; ++i) {
+            fp->array[i] = flatbuffers::ReadScalar<double>(values + i * sizeof(double));
         }
+#endif
 
         return fp;
     } catch (...) {
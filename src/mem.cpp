@@ -2,14 +2,226 @@
 #include "types/pascalstr.h"
 #include "types/ObjectPool.h"
 #include "types/ScopeGuard.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <new>
+#include <thread>
 #include <vector>
+#include <cstdint>
 #include <cstring> // For memset, memcpy
 
-static ObjectPool<XLOPER12> xloperPool;
+// --- Live-memory accounting (GetMemStats) -----------------------------------
+// With TYPES_MEM_STATS every DLL-owned allocation and free below reports its
+// kind and size here. Without it the hooks are empty and compile away.
+//
+// Each thread counts into its own counters, written only by that thread (the
+// FP12 arena's relaxed load+store pattern), and moves its net live change into
+// the shared per-kind totals once it passes a batch, raising the shared peak
+// with the highest value it reached in between. GetMemStats adds the
+// unflushed remainders of every registered thread; a thread folds its
+// counters into the totals when it exits.
+
+namespace {
+
+#if TYPES_MEM_STATS
+const int64_t kMemBatchObjects = 64;
+const int64_t kMemBatchBytes = 256 * 1024;
+
+struct alignas(64) MemTotals {
+    std::atomic<int64_t> liveObjects{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakObjects{0};
+    std::atomic<int64_t> peakBytes{0};
+    std::atomic<uint64_t> allocations{0}; // of exited threads
+    std::atomic<uint64_t> frees{0};
+};
+MemTotals memTotals[kMemKinds];
+std::atomic<uint64_t> memPeakEpoch{0}; // bumped by ResetMemStatsPeaks
+
+struct ThreadMemCounters;
+std::mutex memThreadsMutex;
+std::vector<ThreadMemCounters*> memThreads;
+
+void Add(std::atomic<int64_t>& counter, int64_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+void Add(std::atomic<uint64_t>& counter, uint64_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+
+void RaisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t cur = peak.load(std::memory_order_relaxed);
+    while (value > cur && !peak.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+    }
+}
+
+thread_local bool memCountersGone = false; // set once the thread's counters are destroyed
+
+struct ThreadMemCounters {
+    struct Kind {
+        std::atomic<int64_t> objects{0}; // live change not yet in memTotals
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> peakObjects{0}; // highest `objects` since the last flush
+        std::atomic<int64_t> peakBytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+    };
+    Kind kinds[kMemKinds];
+    std::atomic<uint64_t> peakEpoch{memPeakEpoch.load(std::memory_order_relaxed)};
+
+    ThreadMemCounters() {
+        std::lock_guard<std::mutex> lock(memThreadsMutex);
+        memThreads.push_back(this);
+    }
+    ~ThreadMemCounters() {
+        std::lock_guard<std::mutex> lock(memThreadsMutex);
+        memThreads.erase(std::find(memThreads.begin(), memThreads.end(), this));
+        SyncPeakEpoch();
+        for (size_t k = 0; k < kMemKinds; ++k) {
+            Flush(k);
+            memTotals[k].allocations.fetch_add(kinds[k].allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            memTotals[k].frees.fetch_add(kinds[k].frees.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        memCountersGone = true;
+    }
+
+    // After ResetMemStatsPeaks, peaks restart from the current values.
+    void SyncPeakEpoch() {
+        const uint64_t epoch = memPeakEpoch.load(std::memory_order_relaxed);
+        if (peakEpoch.load(std::memory_order_relaxed) == epoch) return;
+        for (Kind& c : kinds) {
+            c.peakObjects.store(c.objects.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            c.peakBytes.store(c.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        peakEpoch.store(epoch, std::memory_order_relaxed);
+    }
+
+    void Flush(size_t k) {
+        Kind& c = kinds[k];
+        MemTotals& t = memTotals[k];
+        const int64_t objects = t.liveObjects.fetch_add(c.objects.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        const int64_t bytes = t.liveBytes.fetch_add(c.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        RaisePeak(t.peakObjects, objects + c.peakObjects.load(std::memory_order_relaxed));
+        RaisePeak(t.peakBytes, bytes + c.peakBytes.load(std::memory_order_relaxed));
+        for (std::atomic<int64_t>* n : {&c.objects, &c.bytes, &c.peakObjects, &c.peakBytes}) {
+            n->store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void Count(MemKind kind, int64_t bytes, int64_t objects) {
+        SyncPeakEpoch();
+        Kind& c = kinds[(size_t)kind];
+        if (objects > 0) Add(c.allocations, (uint64_t)objects);
+        else Add(c.frees, (uint64_t)-objects);
+        Add(c.objects, objects);
+        Add(c.bytes, bytes);
+        const int64_t o = c.objects.load(std::memory_order_relaxed), b = c.bytes.load(std::memory_order_relaxed);
+        if (o > c.peakObjects.load(std::memory_order_relaxed)) c.peakObjects.store(o, std::memory_order_relaxed);
+        if (b > c.peakBytes.load(std::memory_order_relaxed)) c.peakBytes.store(b, std::memory_order_relaxed);
+        if (o >= kMemBatchObjects || o <= -kMemBatchObjects || b >= kMemBatchBytes || b <= -kMemBatchBytes) {
+            Flush((size_t)kind);
+        }
+    }
+};
+thread_local ThreadMemCounters memCounters;
+
+void Count(MemKind kind, int64_t bytes, int64_t objects) {
+    if (!memCountersGone) {
+        memCounters.Count(kind, bytes, objects);
+        return;
+    }
+    MemTotals& t = memTotals[(size_t)kind];
+    if (objects > 0) t.allocations.fetch_add((uint64_t)objects, std::memory_order_relaxed);
+    else t.frees.fetch_add((uint64_t)-objects, std::memory_order_relaxed);
+    RaisePeak(t.peakObjects, t.liveObjects.fetch_add(objects, std::memory_order_relaxed) + objects);
+    RaisePeak(t.peakBytes, t.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void CountAlloc(MemKind kind, size_t bytes, size_t objects = 1) {
+    Count(kind, (int64_t)bytes, (int64_t)objects);
+}
+
+void CountFree(MemKind kind, size_t bytes, size_t objects = 1) {
+    Count(kind, -(int64_t)bytes, -(int64_t)objects);
+}
+#else
+inline void CountAlloc(MemKind, size_t, size_t = 1) {}
+inline void CountFree(MemKind, size_t, size_t = 1) {}
+#endif
+
+// XLMREF12 already holds one XLREF12.
+size_t MrefBytes(size_t refs) {
+    return sizeof(XLMREF12) + sizeof(XLREF12) * (refs ? refs - 1 : 0);
+}
+
+} // namespace
+
+const char* MemKindName(MemKind kind) {
+    switch (kind) {
+        case MemKind::XLOPER12: return "xloper12";
+        case MemKind::Str: return "str";
+        case MemKind::Multi: return "multi";
+        case MemKind::Ref: return "ref";
+        case MemKind::FP12: return "fp12";
+    }
+    return "?";
+}
+
+MemStats GetMemStats() {
+    MemStats stats;
+    stats.taken = std::chrono::steady_clock::now();
+#if TYPES_MEM_STATS
+    stats.enabled = true;
+    std::lock_guard<std::mutex> lock(memThreadsMutex);
+    const uint64_t epoch = memPeakEpoch.load(std::memory_order_relaxed);
+    for (size_t k = 0; k < kMemKinds; ++k) {
+        const MemTotals& t = memTotals[k];
+        MemKindStats& out = stats.kinds[k];
+        out.liveObjects = t.liveObjects.load(std::memory_order_relaxed);
+        out.liveBytes = t.liveBytes.load(std::memory_order_relaxed);
+        out.allocations = t.allocations.load(std::memory_order_relaxed);
+        out.frees = t.frees.load(std::memory_order_relaxed);
+        // Each thread's highest point since its last flush, on top of the
+        // shared live count: an estimate, high by at most a batch per thread.
+        int64_t peakObjects = out.liveObjects, peakBytes = out.liveBytes;
+        for (const ThreadMemCounters* m : memThreads) {
+            const ThreadMemCounters::Kind& c = m->kinds[k];
+            const bool synced = m->peakEpoch.load(std::memory_order_relaxed) == epoch;
+            out.liveObjects += c.objects.load(std::memory_order_relaxed);
+            out.liveBytes += c.bytes.load(std::memory_order_relaxed);
+            peakObjects += (synced ? c.peakObjects : c.objects).load(std::memory_order_relaxed);
+            peakBytes += (synced ? c.peakBytes : c.bytes).load(std::memory_order_relaxed);
+            out.allocations += c.allocations.load(std::memory_order_relaxed);
+            out.frees += c.frees.load(std::memory_order_relaxed);
+        }
+        out.peakObjects = std::max({t.peakObjects.load(std::memory_order_relaxed), peakObjects, out.liveObjects});
+        out.peakBytes = std::max({t.peakBytes.load(std::memory_order_relaxed), peakBytes, out.liveBytes});
+    }
+#endif
+    return stats;
+}
+
+void ResetMemStatsPeaks() {
+#if TYPES_MEM_STATS
+    const MemStats now = GetMemStats();
+    std::lock_guard<std::mutex> lock(memThreadsMutex);
+    memPeakEpoch.fetch_add(1, std::memory_order_relaxed);
+    for (size_t k = 0; k < kMemKinds; ++k) {
+        memTotals[k].peakObjects.store(now.kinds[k].liveObjects, std::memory_order_relaxed);
+        memTotals[k].peakBytes.store(now.kinds[k].liveBytes, std::memory_order_relaxed);
+    }
+#endif
+}
+
+double AllocationsPerSecond(const MemStats& earlier, const MemStats& later, MemKind kind) {
+    const double seconds = std::chrono::duration<double>(later.taken - earlier.taken).count();
+    if (seconds <= 0) return 0;
+    return (double)(later[kind].allocations - earlier[kind].allocations) / seconds;
+}
+
+static XLOPER12Pool xloperPool;
 
 LPXLOPER12 NewXLOPER12() {
     LPXLOPER12 p = xloperPool.Acquire();
+    CountAlloc(MemKind::XLOPER12, sizeof(XLOPER12));
     // Initialize to zero.
     std::memset(p, 0, sizeof(XLOPER12));
     return p;
@@ -17,10 +229,39 @@ LPXLOPER12 NewXLOPER12() {
 
 void ReleaseXLOPER12(LPXLOPER12 p) {
     if (p) {
+        CountFree(MemKind::XLOPER12, sizeof(XLOPER12));
         xloperPool.Release(p);
     }
 }
 
+void NewXLOPER12Batch(LPXLOPER12* out, size_t n) {
+    xloperPool.AcquireBulk(out, n);
+    CountAlloc(MemKind::XLOPER12, n * sizeof(XLOPER12), n);
+    for (size_t i = 0; i < n; ++i) std::memset(out[i], 0, sizeof(XLOPER12));
+}
+
+void ReleaseXLOPER12Batch(LPXLOPER12 const* items, size_t n) {
+    const size_t released = n - (size_t)std::count(items, items + n, nullptr);
+    CountFree(MemKind::XLOPER12, released * sizeof(XLOPER12), released);
+    xloperPool.ReleaseBulk(items, n);
+}
+
+void SetXLOPER12PoolLimit(size_t maxPerShard) {
+    xloperPool.SetMaxPerShard(maxPerShard);
+}
+
+size_t TrimXLOPER12Pool(size_t targetBytes) {
+    return xloperPool.Trim(targetBytes);
+}
+
+size_t TrimIdleXLOPER12Pool(std::chrono::milliseconds idle) {
+    return xloperPool.TrimIdle(idle);
+}
+
+XLOPER12Pool::Stats GetXLOPER12PoolStats() {
+    return xloperPool.GetStats();
+}
+
 LPXLOPER12 NewExcelString(const std::wstring& str) {
     LPXLOPER12 p = NewXLOPER12();
     p->xltype = xltypeStr | xlbitDLLFree;
@@ -32,7 +273,7 @@ LPXLOPER12 NewExcelString(const std::wstring& str) {
     size_t len = str.length();
     // Caller owns `buffer` (freed by xlAutoFree12 via FreeDllOwnedContents);
     // WritePascalWString only formats into it. Allocate clamped len + prefix + NUL.
-    wchar_t* buffer = new wchar_t[WritePascalWBufferLen(len)];
+    wchar_t* buffer = NewExcelStringBuffer(WritePascalWBufferLen(len));
     WritePascalWString(buffer, str.data(), len);
 
     p->val.str = buffer;
@@ -40,59 +281,909 @@ LPXLOPER12 NewExcelString(const std::wstring& str) {
     return p;
 }
 
-// Thread-local storage for FP12 return values
-struct FP12Buffer {
-    std::vector<char> data; // Stores FP12 header + doubles
+// --- FP12 arena -------------------------------------------------------------
+// Each thread owns kFP12Slots buffers used round-robin, so a pointer from
+// NewFP12 stays valid for the next kFP12Slots - 1 calls on the same thread
+// (Excel copies a returned FP12 before the wrapper returns, so only a couple
+// are ever live at once). A slot keeps its buffer for the next call unless the
+// buffer is too small or oversized: larger than the per-slot share of the
+// retention limit and more than twice the request. A thread that once
+// returned a huge grid therefore gives the memory back within kFP12Slots
+// calls instead of pinning it for its lifetime.
+//
+// In debug mode a slot never reuses its buffer: the retired buffer is
+// poisoned (signaling NaNs, rows/columns -1) and kept in a bounded quarantine
+// so CheckFP12 can report a stale pointer, and reads through it see garbage
+// instead of a later result.
+//
+// Each arena has a mutex that its own thread takes for every call and that is
+// only ever contended by RequestFP12ArenaTrim, which trims idle threads'
+// arenas through the registry (a thread busy in NewFP12 is left to trim
+// itself on its next call). Counters are atomics written under that mutex, so
+// other threads can read them through the registry without it.
+
+namespace {
+
+const int kFP12Slots = 8;
+const size_t kFP12Granularity = 64;
+const size_t kFP12QuarantineBuffers = 64;
+const uint64_t kFP12Poison = 0x7FF4DEADDEADDEADull; // signaling NaN
+
+std::atomic<size_t> fp12MaxRetainedBytes{kDefaultFP12RetainedBytes};
+std::atomic<bool> fp12Debug{false};
+std::atomic<uint64_t> fp12TrimEpoch{0};
+
+struct FP12Slot {
+    char* buf = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    uint64_t generation = 0;
 };
 
-// Keep a few buffers per thread to allow safe returns without immediate overwrites.
-//
-// LIMITATION: this is a fixed-size per-thread ring of kRingBufferSize (8)
-// buffers. A pointer returned by NewFP12 stays valid only until the same thread
-// calls NewFP12 kRingBufferSize more times — the 9th subsequent call wraps back
-// to the same FP12Buffer and may resize-reallocate it, invalidating the older
-// pointer. This is safe for the intended usage (Excel copies each returned FP12
-// before the wrapper returns, so only a couple are live at once), but a caller
-// that holds >8 NewFP12 results simultaneously (e.g. deeply nested grid
-// building on one thread) will silently read overwritten/freed data. If that
-// pattern ever appears, switch the call site to a caller-owned allocation
-// rather than enlarging this ring.
-static const int kRingBufferSize = 8;
-thread_local int fpRingIndex = 0;
-thread_local FP12Buffer fpRingBuffers[kRingBufferSize];
+struct FP12Retired {
+    char* buf;
+    size_t capacity;
+    uint64_t generation;
+};
+
+struct FP12Arena;
+std::mutex fp12RegistryMutex;
+std::vector<FP12Arena*> fp12Arenas;
+
+struct FP12Arena {
+    std::mutex mutex;
+    FP12Slot slots[kFP12Slots];
+    int next = 0;
+    uint64_t trimEpoch = fp12TrimEpoch.load(std::memory_order_relaxed);
+    std::vector<FP12Retired> quarantine; // oldest first
+    std::thread::id owner = std::this_thread::get_id();
+
+    std::atomic<size_t> retainedBytes{0};
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> reuses{0};
+    std::atomic<size_t> trims{0};
+    std::atomic<uint64_t> generation{0};
+
+    FP12Arena() {
+        std::lock_guard<std::mutex> lock(fp12RegistryMutex);
+        fp12Arenas.push_back(this);
+    }
+    ~FP12Arena() {
+        {
+            std::lock_guard<std::mutex> lock(fp12RegistryMutex);
+            fp12Arenas.erase(std::find(fp12Arenas.begin(), fp12Arenas.end(), this));
+        }
+        Trim();
+    }
+
+    static void Add(std::atomic<size_t>& counter, size_t n) { counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    static void Sub(std::atomic<size_t>& counter, size_t n) { counter.store(counter.load(std::memory_order_relaxed) - n, std::memory_order_relaxed); }
+
+    void FreeBuffer(char* buf, size_t capacity) {
+        ::operator delete(buf);
+        Sub(retainedBytes, capacity);
+    }
+
+    // Drops the slot's current FP12 from the live set. Debug mode moves the
+    // buffer to the quarantine; otherwise the buffer stays for reuse.
+    void Retire(FP12Slot& slot) {
+        if (slot.used) CountFree(MemKind::FP12, slot.used);
+        Sub(liveBytes, slot.used);
+        slot.used = 0;
+        if (!slot.buf || !fp12Debug.load(std::memory_order_relaxed)) return;
+
+        FP12* stale = reinterpret_cast<FP12*>(slot.buf);
+        stale->rows = -1;
+        stale->columns = -1;
+        const size_t doubles = (slot.capacity - offsetof(FP12, array)) / sizeof(double);
+        for (size_t i = 0; i < doubles; ++i) std::memcpy(&stale->array[i], &kFP12Poison, sizeof(double));
+
+        quarantine.push_back({slot.buf, slot.capacity, slot.generation});
+        slot.buf = nullptr;
+        slot.capacity = 0;
+        if (quarantine.size() > kFP12QuarantineBuffers) {
+            FreeBuffer(quarantine.front().buf, quarantine.front().capacity);
+            quarantine.erase(quarantine.begin());
+        }
+    }
+
+    void Trim() {
+        for (FP12Slot& slot : slots) {
+            if (slot.used) CountFree(MemKind::FP12, slot.used);
+            Sub(liveBytes, slot.used);
+            if (slot.buf) FreeBuffer(slot.buf, slot.capacity);
+            slot = FP12Slot();
+        }
+        for (const FP12Retired& r : quarantine) FreeBuffer(r.buf, r.capacity);
+        quarantine.clear();
+        trims.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FP12ArenaStats Stats() const {
+        FP12ArenaStats stats;
+        stats.thread = owner;
+        stats.retainedBytes = retainedBytes.load(std::memory_order_relaxed);
+        stats.liveBytes = liveBytes.load(std::memory_order_relaxed);
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        stats.reuses = reuses.load(std::memory_order_relaxed);
+        stats.trims = trims.load(std::memory_order_relaxed);
+        stats.generation = generation.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+thread_local FP12Arena fp12Arena;
+
+} // namespace
 
 FP12* NewFP12(int rows, int cols) {
-    FP12Buffer& buf = fpRingBuffers[fpRingIndex];
-    fpRingIndex = (fpRingIndex + 1) % kRingBufferSize;
+    FP12Arena& arena = fp12Arena;
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    const uint64_t epoch = fp12TrimEpoch.load(std::memory_order_relaxed);
+    if (arena.trimEpoch != epoch) {
+        arena.Trim();
+        arena.trimEpoch = epoch;
+    }
 
-    // Calculate required size: 2 ints + rows*cols doubles
-    size_t size = sizeof(INT32) * 2 + (size_t)rows * cols * sizeof(double);
-    if (buf.data.size() < size) {
-        buf.data.resize(size);
+    // Header (2 ints) + rows*cols doubles, rounded up to the granularity.
+    const size_t count = (size_t)rows * (size_t)cols;
+    if (rows < 0 || cols < 0 || (cols > 0 && (size_t)rows > SIZE_MAX / (size_t)cols) ||
+        count > (SIZE_MAX - offsetof(FP12, array) - kFP12Granularity) / sizeof(double)) {
+        throw std::bad_alloc();
     }
+    const size_t need = std::max(offsetof(FP12, array) + count * sizeof(double), sizeof(FP12));
+    const size_t size = (need + kFP12Granularity - 1) & ~(kFP12Granularity - 1);
+
+    FP12Slot& slot = arena.slots[arena.next];
+    arena.next = (arena.next + 1) % kFP12Slots;
+    arena.Retire(slot);
 
-    FP12* fp = reinterpret_cast<FP12*>(buf.data.data());
+    const size_t keep = fp12MaxRetainedBytes.load(std::memory_order_relaxed) / kFP12Slots;
+    if (slot.buf && (slot.capacity < size || (slot.capacity > keep && slot.capacity > 2 * size))) {
+        arena.FreeBuffer(slot.buf, slot.capacity);
+        slot.buf = nullptr;
+        slot.capacity = 0;
+    }
+    if (slot.buf) {
+        arena.reuses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        slot.buf = static_cast<char*>(::operator new(size));
+        slot.capacity = size;
+        FP12Arena::Add(arena.retainedBytes, size);
+        arena.allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.used = need;
+    CountAlloc(MemKind::FP12, need);
+    slot.generation = arena.generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    FP12Arena::Add(arena.liveBytes, need);
+
+    FP12* fp = reinterpret_cast<FP12*>(slot.buf);
     fp->rows = rows;
     fp->columns = cols;
     return fp;
 }
 
+FP12State CheckFP12(const FP12* fp, uint64_t* generation) {
+    FP12Arena& arena = fp12Arena;
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    for (const FP12Slot& slot : arena.slots) {
+        if (slot.buf && slot.used && reinterpret_cast<const char*>(fp) == slot.buf) {
+            if (generation) *generation = slot.generation;
+            return FP12State::Live;
+        }
+    }
+    for (const FP12Retired& r : arena.quarantine) {
+        if (reinterpret_cast<const char*>(fp) == r.buf) {
+            if (generation) *generation = r.generation;
+            return FP12State::Stale;
+        }
+    }
+    return FP12State::Unknown;
+}
+
+void SetFP12ArenaLimit(size_t maxRetainedBytesPerThread) {
+    fp12MaxRetainedBytes.store(maxRetainedBytesPerThread, std::memory_order_relaxed);
+}
+
+void SetFP12DebugChecks(bool enabled) {
+    fp12Debug.store(enabled, std::memory_order_relaxed);
+}
+
+void TrimFP12Arena() {
+    FP12Arena& arena = fp12Arena;
+    std::lock_guard<std::mutex> lock(arena.mutex);
+    arena.Trim();
+    arena.trimEpoch = fp12TrimEpoch.load(std::memory_order_relaxed);
+}
+
+void RequestFP12ArenaTrim() {
+    const uint64_t epoch = fp12TrimEpoch.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::lock_guard<std::mutex> lock(fp12RegistryMutex);
+    for (FP12Arena* arena : fp12Arenas) {
+        std::unique_lock<std::mutex> idle(arena->mutex, std::try_to_lock);
+        if (!idle) continue; // in NewFP12 now: trims itself on its next call
+        arena->Trim();
+        arena->trimEpoch = epoch;
+    }
+}
+
+FP12ArenaStats GetFP12ArenaStats() {
+    return fp12Arena.Stats();
+}
+
+std::vector<FP12ArenaStats> GetAllFP12ArenaStats() {
+    std::lock_guard<std::mutex> lock(fp12RegistryMutex);
+    std::vector<FP12ArenaStats> all;
+    all.reserve(fp12Arenas.size());
+    for (const FP12Arena* arena : fp12Arenas) all.push_back(arena->Stats());
+    return all;
+}
+
+// --- Pascal string slab -----------------------------------------------------
+// Short DLL-owned Pascal strings (prefix + body + NUL of at most 256 XCHARs)
+// come from size-class slabs instead of new XCHAR[]: classes of 16, 32, 64,
+// 128 and 256 units, carved from 64 KiB pages aligned to their size, one
+// class per page. Each thread caches freed blocks per class without locking
+// and trades them with a global per-class list in batches, like the
+// ObjectPool magazines; a string may be freed on any thread.
+//
+// A slab string is recognized by its page: page addresses go into a fixed
+// open-addressed table that is only ever appended to (pages are kept for the
+// life of the process and recycled through the free lists), so the lookup in
+// FreeExcelStringBuffer takes no lock and never dereferences a pointer it did
+// not hand out. Once the table is half full, short strings fall back to the
+// heap.
+
+namespace {
+
+const size_t kSlabClassUnits[] = {16, 32, 64, 128, 256};
+const int kSlabClasses = sizeof(kSlabClassUnits) / sizeof(kSlabClassUnits[0]);
+const size_t kSlabPageBytes = 64 * 1024;
+const size_t kSlabPageHeader = 64; // SlabPageHeader, padded
+const int kSlabTableBits = 13;
+const size_t kSlabTableSize = size_t(1) << kSlabTableBits;
+const size_t kSlabMaxPages = kSlabTableSize / 2;
+const size_t kSlabCacheBlocks = 128; // per thread and class
+const size_t kSlabBatch = 64;
+
+struct SlabPageHeader {
+    int cls;
+};
+
+struct SlabBlock {
+    SlabBlock* next;
+};
+
+// Static storage, so all of this is zero-initialized and outlives every
+// thread_local cache (including the main thread's).
+std::atomic<uintptr_t> slabPageTable[kSlabTableSize];
+std::mutex slabMutex;
+SlabBlock* slabFree[kSlabClasses];
+size_t slabFreeCount[kSlabClasses];
+size_t slabPages;
+
+int SlabClassFor(size_t units) {
+    for (int i = 0; i < kSlabClasses; ++i) {
+        if (units <= kSlabClassUnits[i]) return i;
+    }
+    return -1;
+}
+
+size_t SlabSlot(uintptr_t page) {
+    return (size_t)(((uint64_t)(page / kSlabPageBytes) * 0x9E3779B97F4A7C15ull) >> (64 - kSlabTableBits));
+}
+
+// The size class of the slab block `p`, or -1 when p is not in a slab page.
+int SlabClassOf(const void* p) {
+    const uintptr_t page = (uintptr_t)p & ~(uintptr_t)(kSlabPageBytes - 1);
+    size_t i = SlabSlot(page);
+    for (size_t probes = 0; probes < kSlabTableSize; ++probes, i = (i + 1) & (kSlabTableSize - 1)) {
+        const uintptr_t entry = slabPageTable[i].load(std::memory_order_acquire);
+        if (entry == page) return reinterpret_cast<const SlabPageHeader*>(page)->cls;
+        if (entry == 0) return -1;
+    }
+    return -1;
+}
+
+// Carves a new page for `cls` onto the global free list. False when the page
+// table is full or the allocation fails.
+bool SlabNewPageLocked(int cls) {
+    if (slabPages >= kSlabMaxPages) return false;
+    char* page = static_cast<char*>(::operator new(kSlabPageBytes, std::align_val_t{kSlabPageBytes}, std::nothrow));
+    if (!page) return false;
+    reinterpret_cast<SlabPageHeader*>(page)->cls = cls;
+
+    const size_t block = kSlabClassUnits[cls] * sizeof(XCHAR);
+    for (size_t off = kSlabPageHeader; off + block <= kSlabPageBytes; off += block) {
+        SlabBlock* b = reinterpret_cast<SlabBlock*>(page + off);
+        b->next = slabFree[cls];
+        slabFree[cls] = b;
+        ++slabFreeCount[cls];
+    }
+
+    // Publish last: a lookup that finds the page sees its header.
+    size_t i = SlabSlot((uintptr_t)page);
+    while (slabPageTable[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & (kSlabTableSize - 1);
+    slabPageTable[i].store((uintptr_t)page, std::memory_order_release);
+    ++slabPages;
+    return true;
+}
+
+// Moves up to `n` blocks of `cls` from the global list onto `*head`.
+size_t SlabTakeLocked(int cls, SlabBlock** head, size_t n) {
+    size_t moved = 0;
+    while (moved < n && slabFree[cls]) {
+        SlabBlock* b = slabFree[cls];
+        slabFree[cls] = b->next;
+        b->next = *head;
+        *head = b;
+        ++moved;
+    }
+    slabFreeCount[cls] -= moved;
+    return moved;
+}
+
+thread_local bool slabCacheGone = false; // set once the thread's cache is destroyed
+
+// The calling thread's free blocks per class; spilled to the global lists at
+// thread exit.
+struct SlabCache {
+    SlabBlock* head[kSlabClasses] = {};
+    size_t count[kSlabClasses] = {};
+
+    ~SlabCache() {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        for (int cls = 0; cls < kSlabClasses; ++cls) {
+            while (head[cls]) {
+                SlabBlock* b = head[cls];
+                head[cls] = b->next;
+                b->next = slabFree[cls];
+                slabFree[cls] = b;
+                ++slabFreeCount[cls];
+            }
+        }
+        slabCacheGone = true;
+    }
+};
+thread_local SlabCache slabCache;
+
+// A block of class `cls`, or null when no page can be added.
+XCHAR* SlabAlloc(int cls) {
+    if (slabCacheGone) {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        SlabBlock* b = nullptr;
+        if (!slabFree[cls] && !SlabNewPageLocked(cls)) return nullptr;
+        SlabTakeLocked(cls, &b, 1);
+        return reinterpret_cast<XCHAR*>(b);
+    }
+    SlabCache& cache = slabCache;
+    if (!cache.head[cls]) {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        if (!slabFree[cls] && !SlabNewPageLocked(cls)) return nullptr;
+        cache.count[cls] += SlabTakeLocked(cls, &cache.head[cls], kSlabBatch);
+    }
+    SlabBlock* b = cache.head[cls];
+    cache.head[cls] = b->next;
+    --cache.count[cls];
+    return reinterpret_cast<XCHAR*>(b);
+}
+
+void SlabFree(void* p, int cls) {
+    SlabBlock* b = static_cast<SlabBlock*>(p);
+    if (slabCacheGone) {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        b->next = slabFree[cls];
+        slabFree[cls] = b;
+        ++slabFreeCount[cls];
+        return;
+    }
+    SlabCache& cache = slabCache;
+    b->next = cache.head[cls];
+    cache.head[cls] = b;
+    if (++cache.count[cls] > kSlabCacheBlocks) {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        for (size_t i = 0; i < kSlabBatch; ++i) {
+            SlabBlock* out = cache.head[cls];
+            cache.head[cls] = out->next;
+            out->next = slabFree[cls];
+            slabFree[cls] = out;
+        }
+        cache.count[cls] -= kSlabBatch;
+        slabFreeCount[cls] += kSlabBatch;
+    }
+}
+
+} // namespace
+
+ExcelStringSlabStats GetExcelStringSlabStats() {
+    ExcelStringSlabStats stats;
+    {
+        std::lock_guard<std::mutex> lock(slabMutex);
+        stats.pages = slabPages;
+        for (int cls = 0; cls < kSlabClasses; ++cls) stats.freeBlocks += slabFreeCount[cls];
+    }
+    stats.reservedBytes = stats.pages * kSlabPageBytes;
+    if (!slabCacheGone) {
+        for (int cls = 0; cls < kSlabClasses; ++cls) stats.threadCachedBlocks += slabCache.count[cls];
+    }
+    return stats;
+}
+
+// --- Heap blocks -----------------------------------------------------------
+// A slab made while the arena is off, and an arena payload too large for a
+// chunk, is one heap block: a 32-byte header (magic value, byte size, flags)
+// followed by the payload. FreeDllOwnedContents is also handed plain new[]
+// arrays, whose preceding bytes must not be read, so a header is only trusted
+// once the block's address has been found in a fixed open-addressed table.
+// Entries are claimed by CAS and released as tombstones within a bounded
+// probe window, so neither allocation nor free takes a lock and a lookup never
+// dereferences a pointer it did not hand out. Arena chunks are entered in the
+// same table (see below).
+
+namespace {
+
+const size_t kBlockHeader = 32; // keeps the payload 32-byte aligned
+const std::align_val_t kBlockAlign{32};
+const uint64_t kBlockMagic = 0x4B4F4C42584C4C58ull; // "XLLXBLOK"
+const uint32_t kBlockArena = 1;                     // an oversize arena payload
+const int kBlockTableBits = 14;
+const size_t kBlockTableSize = size_t(1) << kBlockTableBits;
+const size_t kBlockProbes = 32;
+const uintptr_t kBlockTombstone = 1;
+
+struct BlockHeader {
+    uint64_t magic;
+    size_t bytes;
+    uint32_t flags;
+};
+static_assert(sizeof(BlockHeader) <= kBlockHeader, "block header must fit its padding");
+
+std::atomic<uintptr_t> blockTable[kBlockTableSize];
+
+size_t BlockSlot(uintptr_t key) {
+    return (size_t)(((uint64_t)(key >> 5) * 0x9E3779B97F4A7C15ull) >> (64 - kBlockTableBits));
+}
+
+bool BlockInsert(uintptr_t key) {
+    size_t i = BlockSlot(key);
+    for (size_t probes = 0; probes < kBlockProbes; ++probes, i = (i + 1) & (kBlockTableSize - 1)) {
+        uintptr_t entry = blockTable[i].load(std::memory_order_relaxed);
+        while (entry == 0 || entry == kBlockTombstone) {
+            if (blockTable[i].compare_exchange_weak(entry, key, std::memory_order_release, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// The slot holding `key`, or null.
+std::atomic<uintptr_t>* BlockFind(uintptr_t key) {
+    size_t i = BlockSlot(key);
+    for (size_t probes = 0; probes < kBlockProbes; ++probes, i = (i + 1) & (kBlockTableSize - 1)) {
+        const uintptr_t entry = blockTable[i].load(std::memory_order_acquire);
+        if (entry == key) return &blockTable[i];
+        if (entry == 0) return nullptr;
+    }
+    return nullptr;
+}
+
+void* AllocHeapBlock(size_t bytes, uint32_t flags = 0) {
+    if (bytes > SIZE_MAX - kBlockHeader) throw std::bad_alloc();
+    char* base = static_cast<char*>(::operator new(kBlockHeader + bytes, kBlockAlign));
+    BlockHeader* h = reinterpret_cast<BlockHeader*>(base);
+    h->magic = kBlockMagic;
+    h->bytes = bytes;
+    h->flags = flags;
+    if (!BlockInsert((uintptr_t)base)) { // probe window full
+        ::operator delete(base, kBlockAlign);
+        throw std::bad_alloc();
+    }
+    return base + kBlockHeader;
+}
+
+// The header of the heap block holding `p`, or null for any other pointer.
+// *slot receives its table entry.
+BlockHeader* FindHeapBlock(void* p, std::atomic<uintptr_t>** slot) {
+    const uintptr_t addr = (uintptr_t)p;
+    if (addr % kBlockHeader != 0 || addr < kBlockHeader) return nullptr;
+    *slot = BlockFind(addr - kBlockHeader);
+    if (!*slot) return nullptr;
+    BlockHeader* h = reinterpret_cast<BlockHeader*>(addr - kBlockHeader);
+    return h->magic == kBlockMagic ? h : nullptr;
+}
+
+void FreeHeapBlock(BlockHeader* h, std::atomic<uintptr_t>* slot) {
+    slot->store(kBlockTombstone, std::memory_order_release);
+    ::operator delete(h, kBlockAlign);
+}
+
+} // namespace
+
+// --- Recalc arena -----------------------------------------------------------
+// While the arena is enabled, string / XLMREF12 buffers and slabs are carved
+// from the calling thread's current chunk, each behind a 32-byte header that
+// holds its size. Chunks are a power of two in size and aligned to it, with
+// their ArenaChunk at the base, and are entered in the block table as
+// `base | log2(size)`: a free masks the payload address with each chunk size
+// in use and looks the result up, again without a lock or a read through a
+// foreign pointer.
+//
+// Arena chunks are bump-allocated by one thread at a time (its "current"
+// chunk) and count their outstanding results. A chunk stops being current
+// when it fills up, when a new recalc epoch starts, or when its thread exits;
+// once such a retired chunk has no outstanding results it goes to a bounded
+// free list for reuse by any thread. Allocation and free touch only the
+// chunk's own atomics; arenaMutex guards the free list and the chunk set,
+// which change when a chunk is made, retired and drained, or freed.
+
+namespace {
+
+struct ArenaChunk {
+    // 2 * outstanding results, + 1 while it is a thread's current chunk. The
+    // party that brings it to 0 recycles the chunk.
+    std::atomic<size_t> state{0};
+    std::atomic<size_t> liveBytes{0};
+    size_t size = 0;
+    int sizeLog2 = 0;
+    // Owned by the thread whose current chunk it is (by arenaMutex otherwise).
+    size_t used = 0;
+    uint64_t epoch = 0;
+};
+
+struct PayloadHeader {
+    size_t bytes;
+};
+
+// Bump-allocation granularity. 32 keeps every XLOPER12 of an arena array
+// inside one cache line and lets the NumGrid fill use aligned 32-byte stores.
+const size_t kArenaAlign = 32;
+const size_t kChunkHeader = 64;   // ArenaChunk, padded
+const size_t kPayloadHeader = 32; // PayloadHeader, padded to kArenaAlign
+const size_t kMinChunkBytes = 4096;
+static_assert(sizeof(ArenaChunk) <= kChunkHeader, "ArenaChunk must fit the chunk header");
+
+std::atomic<bool> arenaEnabled{false};
+std::atomic<uint64_t> arenaEpoch{0};
+std::atomic<size_t> arenaChunkBytes{0};
+std::atomic<uint64_t> chunkSizeMask{0}; // bit n: some chunk of 2^n bytes exists
+
+std::mutex arenaMutex;
+size_t arenaMaxFreeChunks = 0;
+std::vector<ArenaChunk*> allChunks;
+std::vector<ArenaChunk*> freeChunks;
+size_t chunksOfSize[64];
+XlArenaStats arenaStats; // live counts here are oversize payloads only
+
+ArenaChunk* NewChunkLocked(size_t size) {
+    int log2 = 0;
+    while ((size_t(1) << log2) < size) ++log2;
+    void* base = ::operator new(size, std::align_val_t(size));
+    ArenaChunk* chunk = new (base) ArenaChunk();
+    chunk->size = size;
+    chunk->sizeLog2 = log2;
+    try {
+        allChunks.push_back(chunk);
+    } catch (...) {
+        ::operator delete(base, std::align_val_t(size));
+        throw;
+    }
+    if (!BlockInsert((uintptr_t)base | (uintptr_t)log2)) {
+        allChunks.pop_back();
+        ::operator delete(base, std::align_val_t(size));
+        throw std::bad_alloc();
+    }
+    if (chunksOfSize[log2]++ == 0) chunkSizeMask.fetch_or(uint64_t(1) << log2, std::memory_order_release);
+    ++arenaStats.chunks;
+    arenaStats.reservedBytes += size;
+    return chunk;
+}
+
+void DeleteChunkLocked(ArenaChunk* chunk) {
+    const size_t size = chunk->size;
+    const int log2 = chunk->sizeLog2;
+    BlockFind((uintptr_t)chunk | (uintptr_t)log2)->store(kBlockTombstone, std::memory_order_release);
+    if (--chunksOfSize[log2] == 0) chunkSizeMask.fetch_and(~(uint64_t(1) << log2), std::memory_order_relaxed);
+    allChunks.erase(std::find(allChunks.begin(), allChunks.end(), chunk));
+    --arenaStats.chunks;
+    arenaStats.reservedBytes -= size;
+    chunk->~ArenaChunk();
+    ::operator delete(chunk, std::align_val_t(size));
+}
+
+// A retired chunk with nothing outstanding: keep it for reuse if it is a
+// standard-size chunk, the arena is still on and the free list has room,
+// else free it.
+void RecycleLocked(ArenaChunk* chunk) {
+    if (chunk->size == arenaChunkBytes.load(std::memory_order_relaxed) &&
+        arenaEnabled.load(std::memory_order_relaxed) && freeChunks.size() < arenaMaxFreeChunks) {
+        freeChunks.push_back(chunk);
+        ++arenaStats.recycled;
+    } else {
+        DeleteChunkLocked(chunk);
+    }
+}
+
+void Retire(ArenaChunk* chunk) {
+    if (chunk->state.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        RecycleLocked(chunk);
+    }
+}
+
+// The calling thread's current chunk, retired at thread exit.
+struct ThreadArena {
+    ArenaChunk* current = nullptr;
+    ~ThreadArena() {
+        if (current) Retire(current);
+        current = nullptr;
+    }
+};
+thread_local ThreadArena threadArena;
+
+size_t AlignUp(size_t n) {
+    return (n + kArenaAlign - 1) & ~(kArenaAlign - 1);
+}
+
+// A payload larger than a chunk: a heap block of its own, counted as a
+// dedicated chunk.
+void* AllocOversize(size_t bytes) {
+    void* p = AllocHeapBlock(bytes, kBlockArena);
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    ++arenaStats.chunks;
+    arenaStats.reservedBytes += kBlockHeader + bytes;
+    ++arenaStats.liveResults;
+    arenaStats.liveBytes += bytes;
+    return p;
+}
+
+// Carves `bytes` out of the calling thread's current chunk. Takes
+// arenaMutex only to switch chunks.
+void* ArenaAlloc(size_t bytes) {
+    if (bytes > SIZE_MAX - kPayloadHeader - kArenaAlign) throw std::bad_alloc();
+    const size_t need = AlignUp(kPayloadHeader + bytes);
+    const size_t chunkBytes = arenaChunkBytes.load(std::memory_order_relaxed);
+    if (need > chunkBytes - kChunkHeader) return AllocOversize(bytes);
+
+    ArenaChunk*& current = threadArena.current;
+    const uint64_t epoch = arenaEpoch.load(std::memory_order_relaxed);
+    if (current && (current->epoch != epoch || current->size != chunkBytes)) {
+        Retire(current);
+        current = nullptr;
+    }
+    // A current chunk whose results have all come back starts over.
+    if (current && current->state.load(std::memory_order_acquire) == 1) current->used = kChunkHeader;
+    if (current && current->size - current->used < need) {
+        Retire(current);
+        current = nullptr;
+    }
+    if (!current) {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        ArenaChunk* chunk;
+        if (!freeChunks.empty()) {
+            chunk = freeChunks.back();
+            freeChunks.pop_back();
+        } else {
+            chunk = NewChunkLocked(chunkBytes);
+        }
+        chunk->used = kChunkHeader;
+        chunk->epoch = epoch;
+        chunk->state.store(1, std::memory_order_relaxed);
+        current = chunk;
+    }
+    char* p = reinterpret_cast<char*>(current) + current->used;
+    current->used += need;
+    reinterpret_cast<PayloadHeader*>(p)->bytes = bytes;
+    current->liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+    current->state.fetch_add(2, std::memory_order_relaxed);
+    return p + kPayloadHeader;
+}
+
+// A payload from the arena when it is enabled, else a heap block.
+void* AllocPayload(size_t bytes) {
+    return arenaEnabled.load(std::memory_order_acquire) ? ArenaAlloc(bytes) : AllocHeapBlock(bytes);
+}
+
+// The arena chunk holding `p`, or null.
+ArenaChunk* FindChunk(const void* p) {
+    uint64_t sizes = chunkSizeMask.load(std::memory_order_acquire);
+    while (sizes) {
+        int log2 = 0;
+        while (!(sizes & (uint64_t(1) << log2))) ++log2;
+        sizes &= ~(uint64_t(1) << log2);
+        const uintptr_t base = (uintptr_t)p & ~((uintptr_t(1) << log2) - 1);
+        if (BlockFind(base | (uintptr_t)log2)) return reinterpret_cast<ArenaChunk*>(base);
+    }
+    return nullptr;
+}
+
+// Frees `p` if it is an arena payload or a heap block and stores its size in
+// *bytes. Returns false (and does nothing) for any other pointer.
+bool FreeRegisteredPayload(void* p, size_t* bytes = nullptr) {
+    std::atomic<uintptr_t>* slot = nullptr;
+    if (BlockHeader* h = FindHeapBlock(p, &slot)) {
+        if (bytes) *bytes = h->bytes;
+        if (h->flags & kBlockArena) {
+            std::lock_guard<std::mutex> lock(arenaMutex);
+            --arenaStats.chunks;
+            arenaStats.reservedBytes -= kBlockHeader + h->bytes;
+            --arenaStats.liveResults;
+            arenaStats.liveBytes -= h->bytes;
+        }
+        FreeHeapBlock(h, slot);
+        return true;
+    }
+    ArenaChunk* chunk = FindChunk(p);
+    if (!chunk) return false;
+    const size_t size = reinterpret_cast<const PayloadHeader*>(static_cast<char*>(p) - kPayloadHeader)->bytes;
+    if (bytes) *bytes = size;
+    chunk->liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    if (chunk->state.fetch_sub(2, std::memory_order_acq_rel) == 2) {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        RecycleLocked(chunk);
+    }
+    return true;
+}
+
+} // namespace
+
+XLOPER12* NewXLOPER12Slab(size_t count, size_t extraBytes) {
+    if (count > (SIZE_MAX - extraBytes) / sizeof(XLOPER12)) throw std::bad_alloc();
+    void* slab = AllocPayload(count * sizeof(XLOPER12) + extraBytes);
+    CountAlloc(MemKind::Multi, count * sizeof(XLOPER12) + extraBytes);
+    std::memset(slab, 0, count * sizeof(XLOPER12));
+    return static_cast<XLOPER12*>(slab);
+}
+
+XLOPER12* NewXLOPER12Array(size_t count) {
+    XLOPER12* array = new XLOPER12[count];
+    CountAlloc(MemKind::Multi, count * sizeof(XLOPER12));
+    return array;
+}
+
+void FreeXLOPER12Array(XLOPER12* array, size_t count) {
+    if (!array) return;
+    CountFree(MemKind::Multi, count * sizeof(XLOPER12));
+    delete[] array;
+}
+
+XCHAR* NewExcelStringBuffer(size_t units) {
+    if (XlArenaEnabled()) {
+        if (units > SIZE_MAX / sizeof(XCHAR)) throw std::bad_alloc();
+        XCHAR* p = static_cast<XCHAR*>(ArenaAlloc(units * sizeof(XCHAR)));
+        CountAlloc(MemKind::Str, units * sizeof(XCHAR));
+        return p;
+    }
+    const int cls = SlabClassFor(units);
+    if (cls >= 0) {
+        if (XCHAR* p = SlabAlloc(cls)) {
+            CountAlloc(MemKind::Str, kSlabClassUnits[cls] * sizeof(XCHAR));
+            return p;
+        }
+    }
+    // Too long for the slab: a heap block, whose header keeps the size for
+    // the free.
+    if (units > SIZE_MAX / sizeof(XCHAR)) throw std::bad_alloc();
+    XCHAR* p = static_cast<XCHAR*>(AllocHeapBlock(units * sizeof(XCHAR)));
+    CountAlloc(MemKind::Str, units * sizeof(XCHAR));
+    return p;
+}
+
+void FreeExcelStringBuffer(XCHAR* p) {
+    if (!p) return;
+    const int cls = SlabClassOf(p);
+    size_t bytes = 0;
+    if (cls >= 0) {
+        CountFree(MemKind::Str, kSlabClassUnits[cls] * sizeof(XCHAR));
+        SlabFree(p, cls);
+    } else if (FreeRegisteredPayload(p, &bytes)) {
+        CountFree(MemKind::Str, bytes);
+    } else {
+        delete[] p; // a caller's new[] string: not counted
+    }
+}
+
+// A one-rect XLMREF12 fits the smallest slab class, so the common
+// single-area result takes a pooled block rather than a heap allocation.
+static_assert(sizeof(XLMREF12) <= 16 * sizeof(XCHAR), "XLMREF12 must fit the smallest slab class");
+static_assert(alignof(XLMREF12) <= 32, "slab blocks are 32-byte aligned");
+
+LPXLMREF12 NewXLMREF12(size_t refs) {
+    if (refs > (SIZE_MAX - sizeof(XLMREF12)) / sizeof(XLREF12)) throw std::bad_alloc();
+    const size_t bytes = MrefBytes(refs);
+    LPXLMREF12 mref = nullptr;
+    if (XlArenaEnabled()) {
+        mref = static_cast<LPXLMREF12>(ArenaAlloc(bytes));
+    } else if (refs <= 1) {
+        mref = reinterpret_cast<LPXLMREF12>(SlabAlloc(0));
+    }
+    if (!mref) mref = (LPXLMREF12) new char[bytes];
+    CountAlloc(MemKind::Ref, bytes);
+    return mref;
+}
+
+void EnableXlArena(size_t chunkBytes, size_t maxFreeChunks) {
+    size_t bytes = kMinChunkBytes;
+    while (bytes < chunkBytes && bytes <= SIZE_MAX / 4) bytes <<= 1;
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    arenaChunkBytes.store(bytes, std::memory_order_relaxed);
+    arenaMaxFreeChunks = maxFreeChunks;
+    // Free chunks of a previous size are useless now; current ones are
+    // retired lazily by their threads (the size no longer matches).
+    for (ArenaChunk* chunk : freeChunks) DeleteChunkLocked(chunk);
+    freeChunks.clear();
+    arenaEnabled.store(true, std::memory_order_release);
+}
+
+void DisableXlArena() {
+    arenaEnabled.store(false, std::memory_order_relaxed);
+    arenaEpoch.fetch_add(1, std::memory_order_relaxed);
+    if (threadArena.current) {
+        Retire(threadArena.current);
+        threadArena.current = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    for (ArenaChunk* chunk : freeChunks) DeleteChunkLocked(chunk);
+    freeChunks.clear();
+}
+
+bool XlArenaEnabled() {
+    return arenaEnabled.load(std::memory_order_acquire);
+}
+
+void XlArenaBeginEpoch() {
+    arenaEpoch.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        ++arenaStats.epochs;
+    }
+    // The caller's chunk retires now; other threads' on their next allocation.
+    if (threadArena.current) {
+        Retire(threadArena.current);
+        threadArena.current = nullptr;
+    }
+}
+
+void XlArenaTrim() {
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    for (ArenaChunk* chunk : freeChunks) DeleteChunkLocked(chunk);
+    freeChunks.clear();
+}
+
+XlArenaStats GetXlArenaStats() {
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    XlArenaStats stats = arenaStats;
+    for (const ArenaChunk* chunk : allChunks) {
+        stats.liveResults += chunk->state.load(std::memory_order_relaxed) / 2;
+        stats.liveBytes += chunk->liveBytes.load(std::memory_order_relaxed);
+    }
+    stats.freeChunks = freeChunks.size();
+    return stats;
+}
+
 void FreeDllOwnedContents(LPXLOPER12 p) {
     if (!p) return;
 
     if (p->xltype & xltypeStr) {
         if (p->val.str) {
-            delete[] p->val.str;
+            FreeExcelStringBuffer(p->val.str);
             p->val.str = nullptr;
         }
     }
     else if (p->xltype & xltypeMulti) {
-         if (p->val.array.lparray) {
+         size_t bytes = 0;
+         if (p->val.array.lparray && FreeRegisteredPayload(p->val.array.lparray, &bytes)) {
+             // One block holds the elements and every string body: a single
+             // deallocation, no per-element walk.
+             CountFree(MemKind::Multi, bytes);
+             p->val.array.lparray = nullptr;
+         } else if (p->val.array.lparray) {
              size_t count = (size_t)p->val.array.rows * p->val.array.columns;
-             // Ownership contract: an element string is only delete[]'d when
+             // Ownership contract: an element string is only freed when
              // the element carries xlbitDLLFree — the explicit marker set by
              // GridToXLOPER12 (src/converters.cpp) on strings it allocates
-             // via Utf8ToExcelString. An element WITHOUT the bit (e.g. an
+             // via Utf8ToExcelStringBuffer. An element WITHOUT the bit (e.g. an
              // Excel-owned or aliased pointer placed into a cell by other
              // code) is left alone. Excel ignores xlbitDLLFree on inner
              // elements, so the bit is purely our ownership marker; our own
@@ -112,17 +1203,27 @@ void FreeDllOwnedContents(LPXLOPER12 p) {
                  // guard regardless of future producers.
                  const DWORD baseType = elem->xltype & ~(xlbitDLLFree | xlbitXLFree);
                  if (baseType == xltypeStr && (elem->xltype & xlbitDLLFree) && elem->val.str) {
-                      delete[] elem->val.str;
+                      FreeExcelStringBuffer(elem->val.str);
                       elem->val.str = nullptr;
                  }
              }
-             delete[] p->val.array.lparray;
+             FreeXLOPER12Array(p->val.array.lparray, count);
              p->val.array.lparray = nullptr;
          }
     }
     else if (p->xltype & xltypeRef) {
         if (p->val.mref.lpmref) {
-            delete[] (char*)p->val.mref.lpmref;
+            size_t bytes = 0;
+            const int cls = SlabClassOf(p->val.mref.lpmref);
+            if (cls >= 0) {
+                CountFree(MemKind::Ref, MrefBytes(p->val.mref.lpmref->count));
+                SlabFree(p->val.mref.lpmref, cls);
+            } else if (FreeRegisteredPayload(p->val.mref.lpmref, &bytes)) {
+                CountFree(MemKind::Ref, bytes);
+            } else {
+                CountFree(MemKind::Ref, MrefBytes(p->val.mref.lpmref->count));
+                delete[] (char*)p->val.mref.lpmref;
+            }
             p->val.mref.lpmref = nullptr;
         }
     }
@@ -136,5 +1237,5 @@ TYPES_EXCEL_CALLBACK xlAutoFree12(LPXLOPER12 p) {
     FreeDllOwnedContents(p);
 
     // Finally, release the XLOPER12 struct itself back to the pool
-    xloperPool.Release(p);
+    ReleaseXLOPER12(p);
 }
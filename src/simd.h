@@ -0,0 +1,60 @@
+#pragma once
+
+// Internal (not installed) x86 SIMD plumbing shared by the vectorized kernels
+// in src/. Everything here compiles to nothing on non-x86 targets, so every
+// kernel must keep a scalar fallback.
+//
+//   TYPES_SIMD_SSE2      defined when SSE2 is part of the compile baseline
+//                        (always on x64; on x86 only with /arch:SSE2+ or -msse2).
+//   TYPES_SIMD_AVX2      defined when an AVX2 kernel can be compiled. AVX2 is
+//                        NOT assumed at runtime: callers must gate on
+//                        CpuHasAvx2() before calling a TYPES_TARGET_AVX2 function.
+//   TYPES_TARGET_AVX2    function attribute that lets GCC/Clang emit AVX2 code in
+//                        one function without raising the global -m flags. MSVC
+//                        accepts AVX2 intrinsics anywhere, so it expands to nothing.
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define TYPES_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(TYPES_SIMD_SSE2) && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+#define TYPES_SIMD_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TYPES_TARGET_AVX2
+#else
+#define TYPES_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#if defined(TYPES_SIMD_AVX2)
+// True when both the CPU and the OS (XSAVE-enabled YMM state) support AVX2.
+// Evaluated once; the result is cached in a function-local static.
+inline bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    static const bool has = []() {
+        int info[4] = {0, 0, 0, 0};
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false; // XMM + YMM state enabled by the OS
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return has;
+#else
+    static const bool has = []() {
+        __builtin_cpu_init(); // safe even if first reached from a static initializer
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return has;
+#endif
+}
+#else
+inline bool CpuHasAvx2() { return false; }
+#endif
@@ -0,0 +1,113 @@
+#include "types/StringInterner.h"
+#include "types/converters.h"
+#include <algorithm>
+#include <cstring>
+
+StringInterner::StringInterner(size_t tableSize) {
+    size_t cap = 16;
+    while (cap < tableSize) cap <<= 1;
+    slots_.resize(cap);
+}
+
+void StringInterner::Reset() {
+    std::fill(slots_.begin(), slots_.end(), Slot());
+    keys_.clear();
+    used_ = 0;
+    builderSize_ = 0;
+}
+
+void StringInterner::SyncBuilder(const flatbuffers::FlatBufferBuilder& builder) {
+    if (&builder != builder_ || builder.GetSize() < builderSize_) {
+        Reset();
+        builder_ = &builder;
+    }
+}
+
+// FNV-1a over the UTF-16 body; the length is mixed in so "" and a prefix of a
+// longer string never share a probe chain by construction.
+static uint64_t HashPascal(const XCHAR* body, size_t len) {
+    uint64_t h = 1469598103934665603ULL ^ (uint64_t)len;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (uint16_t)body[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Returns the matching slot (*hit = true), the empty slot a miss should be
+// cached in, or nullptr when the string is not cacheable (too long, or the
+// table is at its load limit).
+StringInterner::Slot* StringInterner::Find(const XCHAR* str, bool* hit) {
+    *hit = false;
+    const size_t len = str ? (size_t)str[0] : 0;
+    if (len > kMaxInternLen) return nullptr;
+    const XCHAR* body = str ? str + 1 : nullptr;
+
+    const uint64_t h = HashPascal(body, len);
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = (size_t)h & mask;; i = (i + 1) & mask) {
+        Slot& s = slots_[i];
+        if (s.str == 0) {
+            if ((used_ + 1) * 4 > slots_.size() * 3) return nullptr;
+            return &s;
+        }
+        if (s.hash == h && s.len == len &&
+            (len == 0 || std::memcmp(keys_.data() + s.keyPos, body, len * sizeof(XCHAR)) == 0)) {
+            *hit = true;
+            return &s;
+        }
+    }
+}
+
+void StringInterner::Claim(Slot* slot, const XCHAR* str, flatbuffers::uoffset_t strOff) {
+    const size_t len = str ? (size_t)str[0] : 0;
+    slot->hash = HashPascal(str ? str + 1 : nullptr, len);
+    slot->keyPos = (uint32_t)keys_.size();
+    slot->len = (uint32_t)len;
+    slot->str = strOff;
+    slot->scalar = 0;
+    if (len) keys_.insert(keys_.end(), str + 1, str + 1 + len);
+    ++used_;
+}
+
+flatbuffers::Offset<flatbuffers::String> StringInterner::Intern(flatbuffers::FlatBufferBuilder& builder,
+                                                                const XCHAR* str) {
+    SyncBuilder(builder);
+    bool hit = false;
+    Slot* slot = Find(str, &hit);
+    if (hit) {
+        ++hits_;
+        return flatbuffers::Offset<flatbuffers::String>(slot->str);
+    }
+    ++misses_;
+    auto off = CreateStringFromExcel(builder, str);
+    if (slot) Claim(slot, str, off.o);
+    builderSize_ = builder.GetSize();
+    return off;
+}
+
+flatbuffers::Offset<protocol::Scalar> StringInterner::InternScalar(flatbuffers::FlatBufferBuilder& builder,
+                                                                   const XCHAR* str) {
+    SyncBuilder(builder);
+    bool hit = false;
+    Slot* slot = Find(str, &hit);
+    if (hit && slot->scalar != 0) {
+        ++hits_;
+        return flatbuffers::Offset<protocol::Scalar>(slot->scalar);
+    }
+
+    flatbuffers::Offset<flatbuffers::String> strOff;
+    if (hit) {
+        ++hits_; // string already serialized (via Intern); only the tables are new
+        strOff = flatbuffers::Offset<flatbuffers::String>(slot->str);
+    } else {
+        ++misses_;
+        strOff = CreateStringFromExcel(builder, str);
+        if (slot) Claim(slot, str, strOff.o);
+    }
+    auto scalar =
+        protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, strOff).Union());
+    if (slot) slot->scalar = scalar.o;
+    builderSize_ = builder.GetSize();
+    return scalar;
+}
@@ -0,0 +1,304 @@
+#include "types/transcode.h"
+#include "simd.h"
+#include <cstdint>
+#include <cstring>
+
+// The SIMD kernels load XCHARs as 16-bit lanes.
+static_assert(sizeof(XCHAR) == sizeof(uint16_t), "XCHAR must be a 16-bit UTF-16 code unit");
+
+namespace {
+
+inline bool IsHighSurrogate(uint32_t u) { return u >= 0xD800 && u <= 0xDBFF; }
+inline bool IsLowSurrogate(uint32_t u) { return u >= 0xDC00 && u <= 0xDFFF; }
+
+// Encodes one code point starting at src[i]; advances i past the consumed
+// unit(s) and returns the bytes written. Lone surrogates become U+FFFD.
+inline size_t EncodeOne(const uint16_t* src, size_t len, size_t& i, char* dst) {
+    uint32_t u = src[i++];
+    unsigned char* out = reinterpret_cast<unsigned char*>(dst);
+    if (u < 0x80) {
+        out[0] = (unsigned char)u;
+        return 1;
+    }
+    if (u < 0x800) {
+        out[0] = (unsigned char)(0xC0 | (u >> 6));
+        out[1] = (unsigned char)(0x80 | (u & 0x3F));
+        return 2;
+    }
+    if (IsHighSurrogate(u) && i < len && IsLowSurrogate(src[i])) {
+        uint32_t cp = 0x10000 + ((u - 0xD800) << 10) + (src[i++] - 0xDC00);
+        out[0] = (unsigned char)(0xF0 | (cp >> 18));
+        out[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (unsigned char)(0x80 | (cp & 0x3F));
+        return 4;
+    }
+    if (IsHighSurrogate(u) || IsLowSurrogate(u)) {
+        u = 0xFFFD;
+    }
+    out[0] = (unsigned char)(0xE0 | (u >> 12));
+    out[1] = (unsigned char)(0x80 | ((u >> 6) & 0x3F));
+    out[2] = (unsigned char)(0x80 | (u & 0x3F));
+    return 3;
+}
+
+// Length-only twin of EncodeOne.
+inline size_t MeasureOne(const uint16_t* src, size_t len, size_t& i) {
+    uint32_t u = src[i++];
+    if (u < 0x80) return 1;
+    if (u < 0x800) return 2;
+    if (IsHighSurrogate(u) && i < len && IsLowSurrogate(src[i])) {
+        ++i;
+        return 4;
+    }
+    return 3;
+}
+
+#if defined(TYPES_SIMD_SSE2)
+// Narrows 16 ASCII units to 16 bytes. Returns false (writing nothing) as soon
+// as the block contains a unit >= 0x80.
+inline bool AsciiBlock16(const uint16_t* src, char* dst) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+    __m128i hi = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16((short)0xFF80));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(hi, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(a, b));
+    return true;
+}
+#endif
+
+#if defined(TYPES_SIMD_AVX2)
+// 32-unit AVX2 variant. packus works per 128-bit lane, so the qwords are
+// re-ordered (0,2,1,3) to restore source order before the store.
+TYPES_TARGET_AVX2 size_t Utf16ToUtf8Avx2(const uint16_t* src, size_t len, char* dst) {
+    size_t i = 0;
+    char* out = dst;
+    const __m256i mask = _mm256_set1_epi16((short)0xFF80);
+    while (i < len) {
+        if (len - i >= 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+            if (_mm256_testz_si256(_mm256_or_si256(a, b), mask)) {
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+                i += 32;
+                out += 32;
+                continue;
+            }
+        }
+        if (len - i >= 16 && AsciiBlock16(src + i, out)) {
+            i += 16;
+            out += 16;
+            continue;
+        }
+        // Non-ASCII block (or a short tail): encode scalar up to the next
+        // 16-unit boundary, then retry the vector path.
+        size_t stop = (len - i > 16) ? i + 16 : len;
+        while (i < stop) {
+            out += EncodeOne(src, len, i, out);
+        }
+    }
+    return (size_t)(out - dst);
+}
+#endif
+
+size_t Utf16ToUtf8Portable(const uint16_t* src, size_t len, char* dst) {
+    size_t i = 0;
+    char* out = dst;
+    while (i < len) {
+#if defined(TYPES_SIMD_SSE2)
+        if (len - i >= 16 && AsciiBlock16(src + i, out)) {
+            i += 16;
+            out += 16;
+            continue;
+        }
+        size_t stop = (len - i > 16) ? i + 16 : len;
+#else
+        size_t stop = len;
+#endif
+        while (i < stop) {
+            out += EncodeOne(src, len, i, out);
+        }
+    }
+    return (size_t)(out - dst);
+}
+
+} // namespace
+
+size_t Utf16ToUtf8(const XCHAR* src, size_t len, char* dst) {
+    if (len == 0) return 0;
+    const uint16_t* units = reinterpret_cast<const uint16_t*>(src);
+#if defined(TYPES_SIMD_AVX2)
+    if (len >= 32 && CpuHasAvx2()) {
+        return Utf16ToUtf8Avx2(units, len, dst);
+    }
+#endif
+    return Utf16ToUtf8Portable(units, len, dst);
+}
+
+size_t Utf8LengthOfUtf16(const XCHAR* src, size_t len) {
+    const uint16_t* units = reinterpret_cast<const uint16_t*>(src);
+    size_t i = 0;
+    size_t bytes = 0;
+    while (i < len) {
+#if defined(TYPES_SIMD_SSE2)
+        if (len - i >= 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(units + i));
+            __m128i hi = _mm_and_si128(a, _mm_set1_epi16((short)0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(hi, _mm_setzero_si128())) == 0xFFFF) {
+                i += 8;
+                bytes += 8;
+                continue;
+            }
+        }
+#endif
+        bytes += MeasureOne(units, len, i);
+    }
+    return bytes;
+}
+
+namespace {
+
+inline bool IsCont(unsigned char b) { return (b & 0xC0) == 0x80; }
+
+// Decodes one code point starting at src[i] into out (room >= 1 units);
+// advances i and returns the units written. An ill-formed sequence advances i
+// past its maximal subpart and yields a single U+FFFD (Unicode Table 3-7 gives
+// the legal ranges for the second byte after E0/ED/F0/F4).
+inline size_t DecodeOne(const unsigned char* src, size_t len, size_t& i, uint16_t* out, size_t room) {
+    unsigned char c = src[i];
+    if (c < 0x80) {
+        out[0] = c;
+        ++i;
+        return 1;
+    }
+
+    size_t need; // continuation bytes
+    unsigned char lo = 0x80, hi = 0xBF; // legal range of the first continuation byte
+    uint32_t cp;
+    if (c >= 0xC2 && c <= 0xDF) {
+        need = 1;
+        cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        need = 2;
+        cp = c & 0x0F;
+        if (c == 0xE0) lo = 0xA0; // no overlongs
+        if (c == 0xED) hi = 0x9F; // no encoded surrogates
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        need = 3;
+        cp = c & 0x07;
+        if (c == 0xF0) lo = 0x90; // no overlongs
+        if (c == 0xF4) hi = 0x8F; // <= U+10FFFF
+    } else {
+        out[0] = 0xFFFD; // C0, C1, F5..FF, or a stray continuation byte
+        ++i;
+        return 1;
+    }
+
+    size_t j = i + 1;
+    for (size_t k = 0; k < need; ++k, ++j) {
+        unsigned char b = (j < len) ? src[j] : 0;
+        bool ok = (k == 0) ? (j < len && b >= lo && b <= hi) : (j < len && IsCont(b));
+        if (!ok) {
+            out[0] = 0xFFFD;
+            i = j; // maximal subpart: the lead plus the valid continuations so far
+            return 1;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    i = j;
+
+    if (cp < 0x10000) {
+        out[0] = (uint16_t)cp;
+        return 1;
+    }
+    cp -= 0x10000;
+    out[0] = (uint16_t)(0xD800 + (cp >> 10));
+    if (room < 2) return 1; // clamp splits the pair, as a code-unit truncation would
+    out[1] = (uint16_t)(0xDC00 + (cp & 0x3FF));
+    return 2;
+}
+
+#if defined(TYPES_SIMD_SSE2)
+// Widens 16 ASCII bytes to 16 units. Returns false (writing nothing) as soon as
+// the block contains a byte >= 0x80.
+inline bool AsciiWiden16(const unsigned char* src, uint16_t* dst) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    if (_mm_movemask_epi8(v) != 0) return false;
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(v, zero));
+    return true;
+}
+#endif
+
+#if defined(TYPES_SIMD_AVX2)
+// 32-byte AVX2 variant: one movemask test, then two zero-extending widens.
+TYPES_TARGET_AVX2 size_t Utf8ToUtf16Avx2(const unsigned char* src, size_t len, uint16_t* dst, size_t cap) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len && o < cap) {
+        if (len - i >= 32 && cap - o >= 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            if (_mm256_movemask_epi8(v) == 0) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + o),
+                                    _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + o + 16),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+                i += 32;
+                o += 32;
+                continue;
+            }
+        }
+        if (len - i >= 16 && cap - o >= 16 && AsciiWiden16(src + i, dst + o)) {
+            i += 16;
+            o += 16;
+            continue;
+        }
+        // Non-ASCII block (or a short tail): decode scalar across the next 16
+        // bytes, then retry the vector path.
+        size_t stop = (len - i > 16) ? i + 16 : len;
+        while (i < stop && o < cap) {
+            o += DecodeOne(src, len, i, dst + o, cap - o);
+        }
+    }
+    return o;
+}
+#endif
+
+size_t Utf8ToUtf16Portable(const unsigned char* src, size_t len, uint16_t* dst, size_t cap) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < len && o < cap) {
+#if defined(TYPES_SIMD_SSE2)
+        if (len - i >= 16 && cap - o >= 16 && AsciiWiden16(src + i, dst + o)) {
+            i += 16;
+            o += 16;
+            continue;
+        }
+        size_t stop = (len - i > 16) ? i + 16 : len;
+#else
+        size_t stop = len;
+#endif
+        while (i < stop && o < cap) {
+            o += DecodeOne(src, len, i, dst + o, cap - o);
+        }
+    }
+    return o;
+}
+
+} // namespace
+
+size_t Utf8ToUtf16(const char* src, size_t len, XCHAR* dst, size_t dstCap) {
+    if (len == 0 || dstCap == 0) return 0;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+    uint16_t* units = reinterpret_cast<uint16_t*>(dst);
+#if defined(TYPES_SIMD_AVX2)
+    if (len >= 32 && CpuHasAvx2()) {
+        return Utf8ToUtf16Avx2(bytes, len, units, dstCap);
+    }
+#endif
+    return Utf8ToUtf16Portable(bytes, len, units, dstCap);
+}
@@ -7,9 +7,12 @@
 #include <cstring>
 #include "types/mem.h" // For TempStr12/TempInt12 if needed (actually they use thread local)
 #include "types/pascalstr.h" // Single Excel Pascal wide-string writer
+#include "types/transcode.h" // Built-in UTF-16 <-> UTF-8 kernels
 
 // Limit strings to 10MB to prevent DoS
 static const size_t MAX_STRING_SIZE = 10 * 1024 * 1024;
+// ConvertExcelString transcodes strings up to this many units on the stack.
+static const size_t kConvertScratchUnits = 256;
 
 std::wstring StringToWString(const std::string& str) {
     if (str.empty()) return std::wstring();
@@ -38,11 +41,10 @@ std::string WideToUtf8(const std::wstring& wstr) {
          throw std::length_error("Wide string too long (overflow)");
     }
 
-    int size_needed = WideCharToMultiByte(65001, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-    if (size_needed <= 0) return "";
-
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(65001, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
+    // Arbitrary-length input: size exactly (a cheap SIMD count) rather than
+    // reserving the 3x worst case, then transcode with the built-in kernel.
+    std::string strTo(Utf8LengthOfUtf16(wstr.data(), wstr.size()), 0);
+    Utf16ToUtf8(wstr.data(), wstr.size(), &strTo[0]);
     return strTo;
 }
 
@@ -77,11 +79,17 @@ std::string ConvertExcelString(const wchar_t* wstr) {
         throw std::length_error("String too long for conversion");
     }
 
-    int size_needed = WideCharToMultiByte(65001, 0, actualStr, (int)len, NULL, 0, NULL, NULL);
-    if (size_needed <= 0) return "";
-
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(65001, 0, actualStr, (int)len, &strTo[0], size_needed, NULL, NULL);
+    // The built-in transcoder (SIMD all-ASCII fast path) instead of the two
+    // WideCharToMultiByte calls (size, then convert). The result is sized
+    // exactly, so callers that keep it hold no 3x worst-case slack: short
+    // strings go through a stack scratch buffer and are copied out, longer
+    // ones are counted first, as in WideToUtf8.
+    if (len <= kConvertScratchUnits) {
+        char scratch[kConvertScratchUnits * 3]; // Utf8MaxBytesForUtf16
+        return std::string(scratch, Utf16ToUtf8(actualStr, len, scratch));
+    }
+    std::string strTo(Utf8LengthOfUtf16(actualStr, len), 0);
+    Utf16ToUtf8(actualStr, len, &strTo[0]);
     return strTo;
 }
 
@@ -95,56 +103,24 @@ void Utf8ToExcelString(const char* utf8, XCHAR*& outStr) {
 
     size_t realLen = strlen(utf8);
 
-    // Optimization/Security: Excel 12 strings are limited to 32767 chars.
-    // If the input is huge, we don't need to convert all of it just to truncate it.
-    // 32767 chars can be at most ~132KB (4 bytes per char) in UTF-8.
-    // We clamp the input to a safe margin (200,000 bytes) to prevent allocating
-    // huge temporary buffers (e.g. 20MB) for strings that will be truncated anyway.
-    // This also prevents integer overflow when casting size_t to int.
-    if (realLen > 200000) {
-        realLen = 200000;
-    }
-    int utf8Len = static_cast<int>(realLen);
-
-    // CP_UTF8 = 65001
-    // Optimization: Try to convert using a stack buffer first to avoid double API call.
-    // Most Excel strings are small.
-    XCHAR stackBuf[256];
-    int needed = 0;
-
-    if (utf8Len < 256) {
-        needed = MultiByteToWideChar(65001, 0, utf8, utf8Len, stackBuf, 256);
-    }
+    // One pass, no temporary: a UTF-8 byte never produces more than one UTF-16
+    // unit, so min(bytes, 32767) units always hold the clamped result. The
+    // decoder validates and widens straight into the body and stops at the
+    // Excel limit, so huge inputs are never converted past what is kept.
+    // Caller owns outStr.
+    size_t cap = ClampExcelStringLen(realLen);
+    outStr = new XCHAR[WritePascalWBufferLen(cap)];
+    size_t written = Utf8ToUtf16(utf8, realLen, outStr + 1, cap);
+    StampPascalWString(outStr, written);
+}
 
-    if (needed > 0) {
-        // Successful conversion to stack buffer. `needed` < 256 here, so no
-        // clamp ever triggers, but route through the single writer for one
-        // consistent encoding. Caller owns outStr.
-        outStr = new XCHAR[WritePascalWBufferLen((size_t)needed)];
-        WritePascalWString(outStr, stackBuf, (size_t)needed);
-    } else {
-        // Fallback to double-call (or string too long for stack buffer)
-        needed = MultiByteToWideChar(65001, 0, utf8, utf8Len, NULL, 0);
-
-        // Safety check: Don't allocate huge memory for strings.
-        // Use MAX_STRING_SIZE for consistency (Issue 19)
-        if (needed < 0 || (size_t)needed > MAX_STRING_SIZE || (size_t)needed > SIZE_MAX / sizeof(XCHAR) - 2) {
-            outStr = new XCHAR[2];
-            outStr[0] = 0;
-            outStr[1] = 0;
-        } else {
-            // Convert the full result into a temp body buffer, then let the
-            // single writer clamp to kMaxExcelStringLen and stamp prefix + NUL.
-            // (std::vector avoids manual delete[]; body lives at index 0.)
-            // Routing both the in-range and the > 32767 cases through the same
-            // writer keeps one clamp/encode definition. Caller owns outStr.
-            std::vector<XCHAR> tempVec((size_t)needed);
-            MultiByteToWideChar(65001, 0, utf8, utf8Len, tempVec.data(), needed);
-
-            outStr = new XCHAR[WritePascalWBufferLen((size_t)needed)];
-            WritePascalWString(outStr, tempVec.data(), (size_t)needed);
-        }
-    }
+XCHAR* Utf8ToExcelStringBuffer(const char* utf8) {
+    size_t realLen = utf8 ? strlen(utf8) : 0;
+    size_t cap = ClampExcelStringLen(realLen);
+    XCHAR* out = NewExcelStringBuffer(WritePascalWBufferLen(cap));
+    size_t written = utf8 ? Utf8ToUtf16(utf8, realLen, out + 1, cap) : 0;
+    StampPascalWString(out, written);
+    return out;
 }
 
 // Restoring TempStr12 and TempInt12 as they were removed
@@ -0,0 +1,120 @@
+// BuilderPool (include/types/BuilderPool.h): leases come back cleared and are
+// reused, oversized builders are trimmed on release, the idle list is
+// bounded, and ThreadLocal() gives each thread its own pool.
+
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/BuilderPool.h"
+#include "types/converters.h"
+
+void TestLeaseReuse() {
+    BuilderPool pool;
+    XLOPER12 num;
+    num.xltype = xltypeNum;
+    num.val.num = 42.0;
+
+    const flatbuffers::FlatBufferBuilder* first = nullptr;
+    {
+        auto lease = pool.Acquire();
+        assert(lease && lease->GetSize() == 0);
+        lease->Finish(ConvertAny(&num, *lease));
+        first = lease.get();
+    }
+    assert(pool.Idle() == 1);
+
+    for (int i = 0; i < 9; ++i) {
+        auto lease = pool.Acquire();
+        assert(lease.get() == first);   // same builder handed back
+        assert(lease->GetSize() == 0);  // cleared on release
+        lease->Finish(ConvertAny(&num, *lease));
+        auto* any = flatbuffers::GetRoot<protocol::Any>(lease->GetBufferPointer());
+        assert(any->val_as_Num()->val() == 42.0);
+    }
+    assert(pool.Acquires() == 10);
+    assert(pool.Reuses() == 9);
+    assert(pool.ReuseRate() == 0.9);
+    std::cout << "TestLeaseReuse passed" << std::endl;
+}
+
+// Writes `bytes` of payload into a leased builder.
+static void Fill(BuilderPool::Lease& lease, size_t bytes) {
+    uint8_t* body = nullptr;
+    lease->CreateUninitializedVector(bytes, 1, &body);
+    std::memset(body, 0x5A, bytes);
+}
+
+void TestTrimOversized() {
+    BuilderPool pool(64 * 1024);
+    {
+        auto lease = pool.Acquire();
+        Fill(lease, 1 << 20);
+    }
+    assert(pool.Trimmed() == 1);
+    assert(pool.Idle() == 0);
+
+    {
+        auto lease = pool.Acquire();
+        ReserveBuilder(*lease, 8192);
+        Fill(lease, 4096);
+    }
+    assert(pool.Trimmed() == 1 && pool.Idle() == 1);
+    assert(pool.IdleBytes() >= 4096 && pool.IdleBytes() <= 64 * 1024);
+
+    pool.Trim();
+    assert(pool.Idle() == 0 && pool.IdleBytes() == 0);
+    std::cout << "TestTrimOversized passed" << std::endl;
+}
+
+void TestIdleBoundAndMove() {
+    BuilderPool pool(BuilderPool::kDefaultMaxRetainedBytes, 2);
+    {
+        auto a = pool.Acquire();
+        auto b = pool.Acquire();
+        auto c = pool.Acquire();
+        assert(a.get() != b.get() && b.get() != c.get());
+    }
+    assert(pool.Idle() == 2);
+
+    auto a = pool.Acquire();
+    BuilderPool::Lease moved(std::move(a));
+    assert(!a && moved);
+    BuilderPool::Lease assigned;
+    assigned = std::move(moved);
+    assert(!moved && assigned);
+    assert(pool.Idle() == 1);
+    assigned.Release();
+    assert(!assigned && pool.Idle() == 2);
+    assigned.Release(); // no-op
+    assert(pool.Idle() == 2);
+    std::cout << "TestIdleBoundAndMove passed" << std::endl;
+}
+
+void TestThreadLocal() {
+    BuilderPool* mine = &BuilderPool::ThreadLocal();
+    assert(mine == &BuilderPool::ThreadLocal());
+    BuilderPool* other = nullptr;
+    std::thread t([&] {
+        other = &BuilderPool::ThreadLocal();
+        auto lease = other->Acquire();
+        lease->Finish(lease->CreateString("x"));
+    });
+    t.join();
+    assert(other && other != mine);
+    std::cout << "TestThreadLocal passed" << std::endl;
+}
+
+int main() {
+    TestLeaseReuse();
+    TestTrimOversized();
+    TestIdleBoundAndMove();
+    TestThreadLocal();
+    std::cout << "All builder pool tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,256 @@
+// ChunkAssembler (include/types/ChunkAssembler.h): a message split by
+// SplitIntoChunks comes back byte-for-byte in any chunk order, with
+// duplicates and overlaps ignored, the root verified in place; inconsistent
+// chunks, the per-id and total budgets, timeouts and stale ids are refused,
+// and a refused first chunk can be retried.
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/ChunkAssembler.h"
+
+using Clock = ChunkAssembler::Clock;
+
+// A NumGrid wrapped in an Any, large enough to need several chunks.
+static std::vector<uint8_t> MakeMessage(int rows, int cols) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<double> nums((size_t)rows * cols);
+    for (size_t i = 0; i < nums.size(); ++i) nums[i] = (double)i * 0.5;
+    auto ng = protocol::CreateNumGrid(builder, rows, cols, builder.CreateVector(nums));
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+    return std::vector<uint8_t>(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+}
+
+static std::vector<std::vector<uint8_t>> Split(const std::vector<uint8_t>& msg, uint64_t id, uint32_t msgType, size_t chunkBytes) {
+    std::vector<std::vector<uint8_t>> chunks;
+    flatbuffers::FlatBufferBuilder builder;
+    const size_t n = SplitIntoChunks(builder, id, msgType, msg.data(), msg.size(), chunkBytes,
+                                     [&](const uint8_t* buf, size_t len) { chunks.emplace_back(buf, buf + len); });
+    assert(n == chunks.size() && n == (msg.size() + chunkBytes - 1) / chunkBytes);
+    return chunks;
+}
+
+static void CheckMessage(const AssembledMessage& out, const std::vector<uint8_t>& msg, uint64_t id, uint32_t msgType) {
+    assert(out && out.Id() == id && out.MsgType() == msgType && out.Size() == msg.size());
+    assert(std::memcmp(out.Data(), msg.data(), msg.size()) == 0);
+    assert((reinterpret_cast<uintptr_t>(out.Data()) % AssembledMessage::kAlignment) == 0);
+    const protocol::Any* any = out.Root<protocol::Any>();
+    assert(any && any->val_type() == protocol::AnyValue::NumGrid);
+    assert((const uint8_t*)any >= out.Data() && (const uint8_t*)any < out.Data() + out.Size()); // in place
+}
+
+void TestInOrder() {
+    const std::vector<uint8_t> msg = MakeMessage(40, 50);
+    const auto chunks = Split(msg, 7, 3, 1024);
+    ChunkAssembler assembler;
+    AssembledMessage out;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        ChunkStatus st = assembler.AddBuffer(chunks[i].data(), chunks[i].size(), out);
+        assert(st == (i + 1 < chunks.size() ? ChunkStatus::Accepted : ChunkStatus::Complete));
+        if (i + 1 < chunks.size()) {
+            assert(!out);
+            assert(assembler.GetStats().pending == 1 && assembler.GetStats().pendingBytes == msg.size());
+        }
+    }
+    CheckMessage(out, msg, 7, 3);
+    ChunkAssembler::Stats s = assembler.GetStats();
+    assert(s.pending == 0 && s.pendingBytes == 0 && s.completed == 1 && s.bytesCopied == msg.size());
+
+    // A single-chunk message completes on its only chunk.
+    const auto one = Split(msg, 8, 0, msg.size());
+    assert(one.size() == 1);
+    AssembledMessage single;
+    assert(assembler.AddBuffer(one[0].data(), one[0].size(), single) == ChunkStatus::Complete);
+    CheckMessage(single, msg, 8, 0);
+    std::cout << "TestInOrder passed" << std::endl;
+}
+
+void TestShuffledWithDuplicates() {
+    const std::vector<uint8_t> msg = MakeMessage(64, 33);
+    std::mt19937 rng(2024);
+    for (int round = 0; round < 50; ++round) {
+        auto chunks = Split(msg, 100 + round, 1, 257 + round * 13);
+        const size_t unique = chunks.size();
+        for (size_t i = 0; i < unique; i += 3) chunks.push_back(chunks[i]);
+        std::shuffle(chunks.begin(), chunks.end(), rng);
+
+        ChunkAssembler assembler;
+        AssembledMessage out;
+        size_t completes = 0, dups = 0, stale = 0;
+        for (const auto& c : chunks) {
+            switch (assembler.AddBuffer(c.data(), c.size(), out)) {
+                case ChunkStatus::Complete: ++completes; break;
+                case ChunkStatus::Duplicate: ++dups; break;
+                case ChunkStatus::Stale: ++stale; break; // a copy arriving after completion
+                case ChunkStatus::Accepted: break;
+                default: assert(false);
+            }
+        }
+        assert(completes == 1 && dups + stale == chunks.size() - unique);
+        CheckMessage(out, msg, 100 + round, 1);
+    }
+    std::cout << "TestShuffledWithDuplicates passed" << std::endl;
+}
+
+void TestOverlaps() {
+    const std::vector<uint8_t> msg = MakeMessage(10, 10);
+    const uint32_t total = (uint32_t)msg.size();
+    ChunkAssembler assembler;
+    AssembledMessage out;
+    const Clock::time_point now = Clock::now();
+    assert(assembler.Add(1, total, 100, msg.data() + 100, 200, 0, out, now) == ChunkStatus::Accepted);  // [100, 300)
+    assert(assembler.Add(1, total, 150, msg.data() + 150, 100, 0, out, now) == ChunkStatus::Duplicate); // inside
+    assert(assembler.Add(1, total, 250, msg.data() + 250, 150, 0, out, now) == ChunkStatus::Accepted);  // straddles the end
+    assert(assembler.Add(1, total, 400, msg.data() + 400, 10, 0, out, now) == ChunkStatus::Accepted);   // touches [100, 400)
+    assert(assembler.Add(1, total, 120, msg.data() + 120, 290, 0, out, now) == ChunkStatus::Duplicate); // exactly covered
+    assert(assembler.Add(1, total, 50, msg.data() + 50, total - 50, 0, out, now) == ChunkStatus::Accepted);
+    assert(assembler.Add(1, total, 0, msg.data(), 60, 0, out, now) == ChunkStatus::Complete);
+    CheckMessage(out, msg, 1, 0);
+    assert(assembler.GetStats().duplicates == 2);
+    std::cout << "TestOverlaps passed" << std::endl;
+}
+
+void TestInvalid() {
+    const std::vector<uint8_t> msg = MakeMessage(4, 4);
+    const uint32_t total = (uint32_t)msg.size();
+    ChunkAssembler assembler;
+    AssembledMessage out;
+    const Clock::time_point now = Clock::now();
+
+    assert(assembler.Add(1, 0, 0, msg.data(), 0, 0, out, now) == ChunkStatus::Invalid);           // empty message
+    assert(assembler.Add(2, total, total - 4, msg.data(), 8, 0, out, now) == ChunkStatus::Invalid); // past the end
+    assert(assembler.Add(3, total, 0, nullptr, 8, 0, out, now) == ChunkStatus::Invalid);
+
+    // Disagreeing with the first chunk drops the partial message.
+    assert(assembler.Add(4, total, 0, msg.data(), 16, 9, out, now) == ChunkStatus::Accepted);
+    assert(assembler.Add(4, total + 8, 16, msg.data() + 16, 16, 9, out, now) == ChunkStatus::Invalid);
+    assert(assembler.GetStats().pending == 0 && assembler.GetStats().pendingBytes == 0);
+    assert(assembler.Add(4, total, 16, msg.data() + 16, 16, 9, out, now) == ChunkStatus::Stale);
+    assert(assembler.Add(5, total, 0, msg.data(), 16, 9, out, now) == ChunkStatus::Accepted);
+    assert(assembler.Add(5, total, 16, msg.data() + 16, 16, 8, out, now) == ChunkStatus::Invalid); // msg_type changed
+
+    // Not a Chunk buffer at all.
+    std::vector<uint8_t> junk(64, 0xAB);
+    assert(assembler.AddBuffer(junk.data(), junk.size(), out) == ChunkStatus::Invalid);
+    assert(assembler.AddBuffer(nullptr, 0, out) == ChunkStatus::Invalid);
+    assert(!out);
+    assert(assembler.GetStats().rejected == 7);
+
+    // Reassembles fine, but is not the root type asked for.
+    assert(assembler.Add(6, total, 0, msg.data(), total, 0, out, now) == ChunkStatus::Complete);
+    assert(out.Root<protocol::Any>() != nullptr);
+    std::vector<uint8_t> garbage(32, 0xFF);
+    AssembledMessage bad;
+    assert(assembler.Add(10, 32, 0, garbage.data(), 32, 0, bad, now) == ChunkStatus::Complete);
+    assert(bad.Root<protocol::Any>() == nullptr);
+    std::cout << "TestInvalid passed" << std::endl;
+}
+
+void TestBudgets() {
+    ChunkAssembler::Limits limits;
+    limits.maxMessageBytes = 1000;
+    limits.maxTotalBytes = 1500;
+    limits.timeout = std::chrono::milliseconds(0);
+    ChunkAssembler assembler(limits);
+    std::vector<uint8_t> bytes(1001, 1);
+    AssembledMessage out;
+
+    assert(assembler.Add(1, 1001, 0, bytes.data(), 10, 0, out) == ChunkStatus::OverBudget);
+    assert(assembler.Add(1, 1000, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted); // nothing was held
+    assembler.Clear();
+    assert(assembler.Add(2, 1000, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted);
+    assert(assembler.Add(3, 600, 0, bytes.data(), 10, 0, out) == ChunkStatus::OverBudget); // 1000 + 600 > 1500
+    assert(assembler.Add(4, 500, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted);
+    assert(assembler.GetStats().pendingBytes == 1500);
+
+    // Completing a message returns its reservation.
+    assert(assembler.Add(4, 500, 10, bytes.data(), 490, 0, out) == ChunkStatus::Complete);
+    assert(out.Size() == 500 && assembler.GetStats().pendingBytes == 1000);
+    assert(assembler.Add(5, 500, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted);
+
+    // Id 3 was refused while memory was tight; once id 2 completes, its retry
+    // goes through.
+    assert(assembler.Add(2, 1000, 10, bytes.data(), 990, 0, out) == ChunkStatus::Complete);
+    assert(assembler.Add(3, 600, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted);
+    assert(assembler.Add(3, 600, 10, bytes.data(), 590, 0, out) == ChunkStatus::Complete && out.Size() == 600);
+
+    // A malformed first chunk does not poison the id either.
+    assert(assembler.Add(6, 100, 0, nullptr, 10, 0, out) == ChunkStatus::Invalid);
+    assert(assembler.Add(6, 100, 0, bytes.data(), 100, 0, out) == ChunkStatus::Complete);
+
+    assembler.Clear();
+    assert(assembler.GetStats().pending == 0 && assembler.GetStats().pendingBytes == 0);
+    assert(assembler.Add(2, 600, 0, bytes.data(), 10, 0, out) == ChunkStatus::Accepted); // recent ids forgotten too
+    std::cout << "TestBudgets passed" << std::endl;
+}
+
+void TestTimeouts() {
+    ChunkAssembler::Limits limits;
+    limits.maxTotalBytes = 1000;
+    limits.timeout = std::chrono::milliseconds(100);
+    ChunkAssembler assembler(limits);
+    std::vector<uint8_t> bytes(1000, 2);
+    AssembledMessage out;
+    const Clock::time_point t0 = Clock::now();
+
+    assert(assembler.Add(1, 400, 0, bytes.data(), 10, 0, out, t0) == ChunkStatus::Accepted);
+    assert(assembler.Add(2, 400, 0, bytes.data(), 10, 0, out, t0) == ChunkStatus::Accepted);
+    assert(assembler.ExpireStale(t0 + std::chrono::milliseconds(50)) == 0);
+    assert(assembler.Add(2, 400, 10, bytes.data(), 10, 0, out, t0 + std::chrono::milliseconds(90)) == ChunkStatus::Accepted);
+
+    // Id 1 idles past the timeout; id 2 was refreshed at +90ms.
+    assert(assembler.ExpireStale(t0 + std::chrono::milliseconds(150)) == 1);
+    assert(assembler.GetStats().pending == 1 && assembler.GetStats().expired == 1);
+    assert(assembler.Add(1, 400, 10, bytes.data(), 10, 0, out, t0 + std::chrono::milliseconds(150)) == ChunkStatus::Stale);
+
+    // Budget pressure sweeps timed-out messages before refusing: 400 + 700 >
+    // 1000 until id 2 expires.
+    assert(assembler.Add(3, 700, 0, bytes.data(), 10, 0, out, t0 + std::chrono::milliseconds(160)) == ChunkStatus::OverBudget);
+    assert(assembler.Add(4, 700, 0, bytes.data(), 10, 0, out, t0 + std::chrono::milliseconds(300)) == ChunkStatus::Accepted);
+    assert(assembler.GetStats().pending == 1 && assembler.GetStats().pendingBytes == 700);
+    std::cout << "TestTimeouts passed" << std::endl;
+}
+
+void TestInterleavedIds() {
+    const std::vector<uint8_t> a = MakeMessage(30, 30), b = MakeMessage(17, 9);
+    auto ca = Split(a, 1, 10, 500), cb = Split(b, 2, 20, 300);
+    ChunkAssembler assembler;
+    std::vector<AssembledMessage> done;
+    AssembledMessage out;
+    for (size_t i = 0; i < std::max(ca.size(), cb.size()); ++i) {
+        if (i < ca.size() && assembler.AddBuffer(ca[i].data(), ca[i].size(), out) == ChunkStatus::Complete) done.push_back(std::move(out));
+        if (i < cb.size() && assembler.AddBuffer(cb[i].data(), cb[i].size(), out) == ChunkStatus::Complete) done.push_back(std::move(out));
+    }
+    assert(done.size() == 2);
+    CheckMessage(done[0].Id() == 1 ? done[0] : done[1], a, 1, 10);
+    CheckMessage(done[0].Id() == 2 ? done[0] : done[1], b, 2, 20);
+
+    // The recent-id window is bounded: the oldest ids become usable again.
+    for (uint64_t id = 1000; id < 1000 + ChunkAssembler::kRecentIds + 1; ++id) {
+        assert(assembler.Add(id, 1, 0, a.data(), 1, 0, out) == ChunkStatus::Complete);
+    }
+    assert(assembler.Add(1, 1, 0, a.data(), 1, 0, out) == ChunkStatus::Complete);
+    assert(std::string(ChunkStatusName(ChunkStatus::OverBudget)) == "over budget");
+    std::cout << "TestInterleavedIds passed" << std::endl;
+}
+
+int main() {
+    TestInOrder();
+    TestShuffledWithDuplicates();
+    TestOverlaps();
+    TestInvalid();
+    TestBudgets();
+    TestTimeouts();
+    TestInterleavedIds();
+    std::cout << "All chunk assembler tests passed" << std::endl;
+    return 0;
+}
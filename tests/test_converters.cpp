@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cassert>
 #include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -9,6 +10,7 @@ HINSTANCE g_hModule = NULL;
 
 #include "types/converters.h"
 #include "types/mem.h"
+#include "types/utility.h"
 
 extern "C" void __stdcall xlAutoFree12(LPXLOPER12 p);
 
@@ -124,6 +126,51 @@ void TestStrConversion() {
     std::cout << "TestStrConversion passed" << std::endl;
 }
 
+// CreateStringFromExcel must be byte-identical to the CreateString path it
+// replaces, whatever the builder's current alignment (the in-place reservation
+// pads differently depending on GetSize() and the UTF-8 length).
+void TestCreateStringFromExcelMatchesCreateString() {
+    std::vector<std::wstring> inputs = {L"", L"a", L"abc", L"abcd", L"Hello World",
+                                        std::wstring(40, L'x'), L"H\u00e9llo \u20ac",
+                                        L"\u4e2d\u6587\u5b57\u7b26"};
+    std::wstring pair;
+    pair += (wchar_t)0xD83D;
+    pair += (wchar_t)0xDE00;
+    inputs.push_back(pair);
+    std::wstring lone(1, (wchar_t)0xD800);
+    inputs.push_back(lone);
+
+    for (const auto& w : inputs) {
+        std::vector<XCHAR> pstr(w.size() + 2);
+        pstr[0] = (XCHAR)w.size();
+        for (size_t i = 0; i < w.size(); ++i) pstr[i + 1] = (XCHAR)w[i];
+
+        for (size_t skew = 0; skew < 8; ++skew) {
+            flatbuffers::FlatBufferBuilder a, b;
+            std::vector<uint8_t> filler(skew, 0x5A);
+            a.CreateVector(filler);
+            b.CreateVector(filler);
+            a.CreateString("prev");
+            b.CreateString("prev");
+
+            auto sa = a.CreateString(ConvertExcelString(pstr.data()));
+            auto sb = CreateStringFromExcel(b, pstr.data());
+            assert(sa.o == sb.o);
+            a.Finish(protocol::CreateStr(a, sa));
+            b.Finish(protocol::CreateStr(b, sb));
+            assert(a.GetSize() == b.GetSize());
+            assert(std::memcmp(a.GetBufferPointer(), b.GetBufferPointer(), a.GetSize()) == 0);
+        }
+    }
+
+    // Null input serializes as "".
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(protocol::CreateStr(builder, CreateStringFromExcel(builder, nullptr)));
+    auto* str = flatbuffers::GetRoot<protocol::Str>(builder.GetBufferPointer());
+    assert(str->val() && str->val()->size() == 0);
+    std::cout << "TestCreateStringFromExcelMatchesCreateString passed" << std::endl;
+}
+
 void TestGridConversion() {
     flatbuffers::FlatBufferBuilder builder;
     std::vector<flatbuffers::Offset<protocol::Scalar>> elements;
@@ -174,9 +221,540 @@ void TestNumGridConversion() {
     assert(res->val.array.lparray[3].val.num == 40.0);
 
     xlAutoFree12(res);
+
+    // Bulk fill: every shape's tail (counts not a multiple of 4), bit-exact
+    // values including -0.0, NaN and denormals, and xltypeNum on every cell.
+    const int shapes[][2] = {{1, 1}, {3, 1}, {1, 7}, {5, 5}, {3, 37}};
+    for (const auto& shape : shapes) {
+        const int rows = shape[0], cols = shape[1];
+        std::vector<double> values((size_t)rows * cols);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = (double)i * -1.5;
+        values[0] = -0.0;
+        if (values.size() > 2) values[2] = std::numeric_limits<double>::quiet_NaN();
+        values.back() = std::numeric_limits<double>::denorm_min();
+
+        flatbuffers::FlatBufferBuilder b2;
+        auto g = protocol::CreateNumGrid(b2, rows, cols, b2.CreateVector(values));
+        b2.Finish(protocol::CreateAny(b2, protocol::AnyValue::NumGrid, g.Union()));
+        LPXLOPER12 out = AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(b2.GetBufferPointer()));
+        assert(out->xltype == (xltypeMulti | xlbitDLLFree));
+        for (size_t i = 0; i < values.size(); ++i) {
+            assert(out->val.array.lparray[i].xltype == xltypeNum);
+            assert(std::memcmp(&out->val.array.lparray[i].val.num, &values[i], sizeof(double)) == 0);
+        }
+        xlAutoFree12(out);
+    }
     std::cout << "TestNumGridConversion passed" << std::endl;
 }
 
+void TestColumnGridRoundTrip() {
+    // 3x4, one homogeneous type per column: Str (with a nil), Int, Bool, Err.
+    XCHAR hi[] = {2, L'h', L'i', 0};
+    XCHAR empty[] = {0, 0};
+    XLOPER12 cells[12];
+    std::memset(cells, 0, sizeof(cells));
+    for (int r = 0; r < 3; ++r) {
+        XLOPER12* row = cells + r * 4;
+        if (r == 1) {
+            row[0].xltype = xltypeNil;
+        } else {
+            row[0].xltype = xltypeStr;
+            row[0].val.str = (r == 0) ? hi : empty;
+        }
+        row[1].xltype = xltypeInt;
+        row[1].val.w = 10 * r;
+        row[2].xltype = xltypeBool;
+        row[2].val.xbool = (r != 1);
+        row[3].xltype = xltypeErr;
+        row[3].val.err = (r == 2) ? xlerrNA : xlerrDiv0;
+    }
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = 3;
+    multi.val.array.columns = 4;
+    multi.val.array.lparray = cells;
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertMultiToAny(multi, builder));
+    auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    assert(root->val_type() == protocol::AnyValue::ColumnGrid);
+
+    const auto* cg = root->val_as_ColumnGrid();
+    assert(cg->rows() == 3 && cg->cols() == 4);
+    const auto* strCol = cg->columns()->Get(0);
+    assert(strCol->type() == protocol::ColumnType::Str);
+    assert(strCol->nulls() && strCol->nulls()->Get(0) == 0x02); // row 1 is nil
+    assert(cg->columns()->Get(1)->type() == protocol::ColumnType::Int);
+    assert(!cg->columns()->Get(1)->nulls());
+    assert(cg->columns()->Get(2)->type() == protocol::ColumnType::Bool);
+    assert(cg->columns()->Get(3)->type() == protocol::ColumnType::Err);
+
+    LPXLOPER12 res = AnyToXLOPER12(root);
+    assert(res->xltype == (xltypeMulti | xlbitDLLFree));
+    assert(res->val.array.rows == 3 && res->val.array.columns == 4);
+    const XLOPER12* out = res->val.array.lparray;
+    assert(out[0].xltype == (xltypeStr | xlbitDLLFree));
+    assert(ConvertExcelString(out[0].val.str) == "hi");
+    assert(out[4].xltype == xltypeNil);
+    assert(out[8].xltype == (xltypeStr | xlbitDLLFree) && out[8].val.str[0] == 0);
+    for (int r = 0; r < 3; ++r) {
+        assert(out[r * 4 + 1].xltype == xltypeInt && out[r * 4 + 1].val.w == 10 * r);
+        assert(out[r * 4 + 2].xltype == xltypeBool && out[r * 4 + 2].val.xbool == (r != 1));
+        assert(out[r * 4 + 3].xltype == xltypeErr);
+    }
+    assert(out[3].val.err == xlerrDiv0 && out[11].val.err == xlerrNA);
+
+    xlAutoFree12(res);
+    std::cout << "TestColumnGridRoundTrip passed" << std::endl;
+}
+
+void TestColumnGridSelection() {
+    XCHAR a[] = {1, L'a', 0};
+    XLOPER12 cells[4];
+    std::memset(cells, 0, sizeof(cells));
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.columns = 1;
+    multi.val.array.lparray = cells;
+
+    // Num and Str in one column: mixed, stays on Grid.
+    cells[0].xltype = xltypeNum;
+    cells[0].val.num = 1.0;
+    cells[1].xltype = xltypeStr;
+    cells[1].val.str = a;
+    multi.val.array.rows = 2;
+    {
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(ConvertMultiToAny(multi, builder));
+        auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+        assert(root->val_type() == protocol::AnyValue::Grid);
+    }
+
+    // A single row stays on Grid even when every column is homogeneous.
+    multi.val.array.rows = 1;
+    multi.val.array.columns = 2;
+    {
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(ConvertMultiToAny(multi, builder));
+        auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+        assert(root->val_type() == protocol::AnyValue::Grid);
+    }
+
+    // Nums with a missing cell: no longer all-num, so ColumnGrid with a null.
+    cells[1].xltype = xltypeMissing;
+    multi.val.array.rows = 2;
+    multi.val.array.columns = 1;
+    {
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(ConvertMultiToAny(multi, builder));
+        auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+        assert(root->val_type() == protocol::AnyValue::ColumnGrid);
+        const auto* col = root->val_as_ColumnGrid()->columns()->Get(0);
+        assert(col->type() == protocol::ColumnType::Num);
+        assert(col->nums()->Get(0) == 1.0);
+        assert(col->nulls()->Get(0) == 0x02);
+    }
+    std::cout << "TestColumnGridSelection passed" << std::endl;
+}
+
+void TestColumnGridMalformed() {
+    // Column claims 3 rows' worth of data but holds 2 values.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<double> nums = {1.0, 2.0};
+    auto col = protocol::CreateColumnDirect(builder, protocol::ColumnType::Num, nullptr, &nums);
+    std::vector<flatbuffers::Offset<protocol::Column>> cols = {col};
+    auto cg = protocol::CreateColumnGridDirect(builder, 3, 1, &cols);
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::ColumnGrid, cg.Union()));
+
+    auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    LPXLOPER12 res = AnyToXLOPER12(root);
+    assert(res->xltype == (xltypeErr | xlbitDLLFree));
+    assert(res->val.err == xlerrValue);
+    xlAutoFree12(res);
+
+    // Column count disagreeing with cols.
+    flatbuffers::FlatBufferBuilder b2;
+    std::vector<double> three = {1.0, 2.0, 3.0};
+    std::vector<flatbuffers::Offset<protocol::Column>> one = {
+        protocol::CreateColumnDirect(b2, protocol::ColumnType::Num, nullptr, &three)};
+    b2.Finish(protocol::CreateColumnGridDirect(b2, 3, 2, &one));
+    res = ColumnGridToXLOPER12(flatbuffers::GetRoot<protocol::ColumnGrid>(b2.GetBufferPointer()));
+    assert(res->val.err == xlerrValue);
+    xlAutoFree12(res);
+    std::cout << "TestColumnGridMalformed passed" << std::endl;
+}
+
+void TestNumGridExRoundTrip() {
+    // 4x2 price block with one #N/A and one text cell: too mixed for
+    // NumGrid/ColumnGrid, few enough exceptions for NumGridEx.
+    XCHAR na[] = {3, L'n', L'/', L'a', 0};
+    XLOPER12 cells[8];
+    for (int i = 0; i < 8; ++i) {
+        cells[i].xltype = xltypeNum;
+        cells[i].val.num = 100.0 + i;
+    }
+    cells[3].xltype = xltypeErr;
+    cells[3].val.err = xlerrNA;
+    cells[6].xltype = xltypeStr;
+    cells[6].val.str = na;
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = 4;
+    multi.val.array.columns = 2;
+    multi.val.array.lparray = cells;
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertMultiToAny(multi, builder));
+    auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    assert(root->val_type() == protocol::AnyValue::NumGridEx);
+    const auto* ng = root->val_as_NumGridEx();
+    assert(ng->data()->size() == 8);
+    assert(ng->data()->Get(3) == 0.0 && ng->data()->Get(7) == 107.0);
+    assert(ng->exc_index()->size() == 2);
+    assert(ng->exc_index()->Get(0) == 3 && ng->exc_index()->Get(1) == 6);
+
+    LPXLOPER12 res = AnyToXLOPER12(root);
+    assert(res->xltype == (xltypeMulti | xlbitDLLFree));
+    const XLOPER12* out = res->val.array.lparray;
+    assert(out[0].xltype == xltypeNum && out[0].val.num == 100.0);
+    assert(out[3].xltype == xltypeErr && out[3].val.err == xlerrNA);
+    assert(out[6].xltype == (xltypeStr | xlbitDLLFree));
+    assert(ConvertExcelString(out[6].val.str) == "n/a");
+    assert(out[7].xltype == xltypeNum && out[7].val.num == 107.0);
+    xlAutoFree12(res);
+
+    // Past one exception in four cells the boxed Grid is used instead.
+    cells[0].xltype = xltypeMissing;
+    cells[1].xltype = xltypeMissing;
+    flatbuffers::FlatBufferBuilder b2;
+    b2.Finish(ConvertMultiToAny(multi, b2));
+    assert(flatbuffers::GetRoot<protocol::Any>(b2.GetBufferPointer())->val_type() == protocol::AnyValue::Grid);
+    std::cout << "TestNumGridExRoundTrip passed" << std::endl;
+}
+
+void TestNumGridExMalformed() {
+    // Exception indices out of order.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<double> data = {1.0, 2.0, 3.0, 4.0};
+    std::vector<uint32_t> index = {2, 1};
+    std::vector<flatbuffers::Offset<protocol::Scalar>> values = {
+        protocol::CreateScalar(builder, protocol::ScalarValue::Nil, protocol::CreateNil(builder).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Nil, protocol::CreateNil(builder).Union())};
+    builder.Finish(protocol::CreateNumGridExDirect(builder, 2, 2, &data, &index, &values));
+    LPXLOPER12 res = NumGridExToXLOPER12(flatbuffers::GetRoot<protocol::NumGridEx>(builder.GetBufferPointer()));
+    assert(res->xltype == (xltypeErr | xlbitDLLFree) && res->val.err == xlerrValue);
+    xlAutoFree12(res);
+
+    // More indices than values.
+    flatbuffers::FlatBufferBuilder b2;
+    std::vector<uint32_t> two = {0, 1};
+    std::vector<flatbuffers::Offset<protocol::Scalar>> one = {
+        protocol::CreateScalar(b2, protocol::ScalarValue::Nil, protocol::CreateNil(b2).Union())};
+    b2.Finish(protocol::CreateNumGridExDirect(b2, 2, 2, &data, &two, &one));
+    res = NumGridExToXLOPER12(flatbuffers::GetRoot<protocol::NumGridEx>(b2.GetBufferPointer()));
+    assert(res->val.err == xlerrValue);
+    xlAutoFree12(res);
+    std::cout << "TestNumGridExMalformed passed" << std::endl;
+}
+
+void TestSparseGridRoundTrip() {
+    // A 1000x26 block (think A1:Z1000) with three populated cells.
+    const int rows = 1000, cols = 26;
+    XCHAR hdr[] = {5, L'P', L'r', L'i', L'c', L'e', 0};
+    std::vector<XLOPER12> cells((size_t)rows * cols);
+    for (auto& c : cells) {
+        std::memset(&c, 0, sizeof(c));
+        c.xltype = xltypeMissing;
+    }
+    cells[0].xltype = xltypeStr;
+    cells[0].val.str = hdr;
+    cells[26 + 1].xltype = xltypeNum;
+    cells[26 + 1].val.num = 9.5;
+    cells.back().xltype = xltypeErr;
+    cells.back().val.err = xlerrNA;
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = rows;
+    multi.val.array.columns = cols;
+    multi.val.array.lparray = cells.data();
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertMultiToAny(multi, builder));
+    auto* root = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    assert(root->val_type() == protocol::AnyValue::SparseGrid);
+    const auto* sg = root->val_as_SparseGrid();
+    assert(sg->rows() == rows && sg->cols() == cols);
+    assert(sg->index()->size() == 3 && sg->index()->Get(2) == (uint32_t)(rows * cols - 1));
+    assert(builder.GetSize() < 512); // scales with populated cells, not 26k
+
+    LPXLOPER12 res = AnyToXLOPER12(root);
+    assert(res->xltype == (xltypeMulti | xlbitDLLFree));
+    const XLOPER12* out = res->val.array.lparray;
+    assert(out[0].xltype == (xltypeStr | xlbitDLLFree));
+    assert(ConvertExcelString(out[0].val.str) == "Price");
+    assert(out[1].xltype == xltypeNil);
+    assert(out[27].xltype == xltypeNum && out[27].val.num == 9.5);
+    assert(out[rows * cols - 1].xltype == xltypeErr && out[rows * cols - 1].val.err == xlerrNA);
+    assert(out[rows * cols - 2].xltype == xltypeNil);
+    xlAutoFree12(res);
+
+    // The dense Grid path shares one Nil table across the empty cells.
+    flatbuffers::FlatBufferBuilder b2;
+    b2.Finish(ConvertGrid(&multi, b2));
+    auto* g = flatbuffers::GetRoot<protocol::Grid>(b2.GetBufferPointer());
+    assert(g->data()->Get(1) == g->data()->Get(2));
+    assert(b2.GetSize() < (size_t)rows * cols * 5);
+    std::cout << "TestSparseGridRoundTrip passed" << std::endl;
+}
+
+void TestSparseGridMalformed() {
+    // Repeated cell index.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<uint32_t> index = {3, 3};
+    std::vector<flatbuffers::Offset<protocol::Scalar>> values = {
+        protocol::CreateScalar(builder, protocol::ScalarValue::Num, protocol::CreateNum(builder, 1.0).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Num, protocol::CreateNum(builder, 2.0).Union())};
+    builder.Finish(protocol::CreateSparseGridDirect(builder, 2, 2, &index, &values));
+    LPXLOPER12 res = SparseGridToXLOPER12(flatbuffers::GetRoot<protocol::SparseGrid>(builder.GetBufferPointer()));
+    assert(res->xltype == (xltypeErr | xlbitDLLFree) && res->val.err == xlerrValue);
+    xlAutoFree12(res);
+
+    // No cells at all is a valid, all-empty grid.
+    flatbuffers::FlatBufferBuilder b2;
+    b2.Finish(protocol::CreateSparseGrid(b2, 2, 3));
+    res = SparseGridToXLOPER12(flatbuffers::GetRoot<protocol::SparseGrid>(b2.GetBufferPointer()));
+    assert(res->xltype == (xltypeMulti | xlbitDLLFree));
+    for (int i = 0; i < 6; ++i) assert(res->val.array.lparray[i].xltype == xltypeNil);
+    xlAutoFree12(res);
+    std::cout << "TestSparseGridMalformed passed" << std::endl;
+}
+
+void TestGridProfile() {
+    // 3 x 11: each row takes one eight-cell run plus a three-cell tail.
+    // Column c holds: 0 nums (integral except row 1), 1 ints, 2 bools,
+    // 3 strings, 4 errors, 5 nums/nil, 6 all nil, 7 num/str (mixed),
+    // 8 missing, 9 nums (DLL-owned bit), 10 strings.
+    XCHAR abc[] = {3, L'a', L'b', L'c', 0};
+    const int rows = 3, cols = 11;
+    std::vector<XLOPER12> cells((size_t)rows * cols);
+    std::memset(cells.data(), 0, cells.size() * sizeof(XLOPER12));
+    for (int r = 0; r < rows; ++r) {
+        XLOPER12* row = &cells[(size_t)r * cols];
+        row[0].xltype = xltypeNum;
+        row[0].val.num = (r == 1) ? 2.5 : 4.0 * r;
+        row[1].xltype = xltypeInt;
+        row[2].xltype = xltypeBool;
+        row[3].xltype = xltypeStr;
+        row[3].val.str = abc;
+        row[4].xltype = xltypeErr;
+        row[5].xltype = (r == 0) ? xltypeNum : xltypeNil;
+        row[5].val.num = 3e10; // outside int32
+        row[6].xltype = xltypeNil;
+        row[7].xltype = (r == 2) ? xltypeStr : xltypeNum;
+        row[7].val.str = abc;
+        if (r != 2) row[7].val.num = -7.0;
+        row[8].xltype = xltypeMissing;
+        row[9].xltype = xltypeNum | xlbitDLLFree;
+        row[9].val.num = -0.0;
+        row[10].xltype = xltypeStr;
+        row[10].val.str = nullptr;
+    }
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = rows;
+    multi.val.array.columns = cols;
+    multi.val.array.lparray = cells.data();
+
+    GridProfile p;
+    assert(ProfileGrid(multi, p));
+    assert(p.rows == 3 && p.cols == 11 && p.cells == 33);
+    assert(p.nums == 3 + 1 + 2 + 3);
+    assert(p.ints == 3 && p.bools == 3 && p.errs == 3);
+    assert(p.strs == 3 + 1 + 3);
+    assert(p.nils == 2 + 3 + 3);
+    assert(p.Populated() == 25 && !p.AllNumbers());
+    assert(p.integralNums == 2 + 2 + 3); // 0, 8; -7 twice; -0.0 three times
+    assert(p.strUnits == 3 * 4);
+    assert(p.StrBytesUpperBound() == 36);
+    assert(!p.columnsHomogeneous && p.columnTypes.empty());
+
+    // Without the mixed column every column is typed; the all-nil and
+    // missing columns default to Num.
+    for (int r = 0; r < rows; ++r) cells[(size_t)r * cols + 7].xltype = xltypeNil;
+    assert(ProfileGrid(multi, p));
+    assert(p.columnsHomogeneous && p.columnTypes.size() == 11);
+    assert(p.columnTypes[1] == protocol::ColumnType::Int);
+    assert(p.columnTypes[2] == protocol::ColumnType::Bool);
+    assert(p.columnTypes[3] == protocol::ColumnType::Str);
+    assert(p.columnTypes[4] == protocol::ColumnType::Err);
+    assert(p.columnTypes[6] == protocol::ColumnType::Num);
+    assert(p.columnTypes[9] == protocol::ColumnType::Num);
+
+    // A narrow array (two columns) is counted in runs of eight as well.
+    std::vector<XLOPER12> narrow(2 * 9);
+    std::memset(narrow.data(), 0, narrow.size() * sizeof(XLOPER12));
+    for (size_t i = 0; i < narrow.size(); ++i) {
+        narrow[i].xltype = (i % 2 == 0) ? xltypeNum : xltypeBool;
+        narrow[i].val.num = (double)i;
+    }
+    narrow[17].xltype = xltypeErr;
+    multi.val.array.rows = 9;
+    multi.val.array.columns = 2;
+    multi.val.array.lparray = narrow.data();
+    assert(ProfileGrid(multi, p));
+    assert(p.nums == 9 && p.integralNums == 9 && p.bools == 8 && p.errs == 1);
+    assert(!p.columnsHomogeneous);
+
+    // Invalid input leaves an empty profile.
+    multi.val.array.rows = -1;
+    assert(!ProfileGrid(multi, p) && p.cells == 0);
+    multi.val.array.rows = 2;
+    multi.val.array.lparray = nullptr;
+    assert(!ProfileGrid(multi, p) && p.cells == 0);
+    std::cout << "TestGridProfile passed" << std::endl;
+}
+
+// Counts the buffers a FlatBufferBuilder allocates (growth reallocates
+// through allocate + copy).
+struct CountingAllocator : flatbuffers::DefaultAllocator {
+    int allocations = 0;
+    uint8_t* allocate(size_t size) override {
+        ++allocations;
+        return flatbuffers::DefaultAllocator::allocate(size);
+    }
+};
+
+void TestPresizedConversion() {
+    XCHAR word[] = {5, L'h', L'e', L'l', L'l', L'o', 0};
+    const int rows = 2000, cols = 6;
+    std::vector<XLOPER12> cells((size_t)rows * cols);
+    std::memset(cells.data(), 0, cells.size() * sizeof(XLOPER12));
+    XLOPER12 multi;
+    multi.xltype = xltypeMulti;
+    multi.val.array.rows = rows;
+    multi.val.array.columns = cols;
+    multi.val.array.lparray = cells.data();
+
+    // One fill per encoding ConvertMultiToAny can pick.
+    for (int shape = 0; shape < 5; ++shape) {
+        for (size_t i = 0; i < cells.size(); ++i) {
+            XLOPER12& c = cells[i];
+            c.xltype = xltypeNum;
+            c.val.num = (double)i;
+            if (shape == 1 && i % 10 != 0) c.xltype = xltypeNil;          // SparseGrid
+            if (shape == 2 && i % cols == 1) c.xltype = xltypeStr;        // ColumnGrid
+            if (shape == 3 && i % 7 == 0) c.xltype = xltypeErr;           // NumGridEx
+            if (shape == 4 && i % 3 == 1) c.xltype = (i % 2) ? xltypeStr : xltypeBool; // Grid
+            if (c.xltype == xltypeStr) c.val.str = word;
+            if (c.xltype == xltypeErr) c.val.err = xlerrNA;
+        }
+
+        flatbuffers::FlatBufferBuilder plain;
+        plain.Finish(ConvertAny(&multi, plain));
+        const size_t estimate = EstimateSerializedSize(&multi);
+        assert(estimate >= plain.GetSize());
+        assert(estimate < plain.GetSize() * 2);
+
+        CountingAllocator alloc;
+        flatbuffers::FlatBufferBuilder presized(1024, &alloc);
+        presized.Finish(ConvertAnyPresized(&multi, presized));
+        assert(alloc.allocations == 1);
+        assert(presized.GetSize() == plain.GetSize());
+        assert(std::memcmp(presized.GetBufferPointer(), plain.GetBufferPointer(), plain.GetSize()) == 0);
+
+        CountingAllocator gridAlloc;
+        flatbuffers::FlatBufferBuilder grid(1024, &gridAlloc);
+        grid.Finish(ConvertGridPresized(&multi, grid));
+        assert(gridAlloc.allocations == 1);
+        assert(flatbuffers::GetRoot<protocol::Grid>(grid.GetBufferPointer())->data()->size() == cells.size());
+    }
+
+    // Without pre-sizing the same grid grows the buffer repeatedly.
+    CountingAllocator alloc;
+    flatbuffers::FlatBufferBuilder growing(1024, &alloc);
+    growing.Finish(ConvertGrid(&multi, growing));
+    assert(alloc.allocations > 1);
+
+    // ReserveBuilder leaves an empty builder empty, and a builder that
+    // already holds data untouched.
+    CountingAllocator reserveAlloc;
+    flatbuffers::FlatBufferBuilder reserved(1024, &reserveAlloc);
+    ReserveBuilder(reserved, 100000);
+    assert(reserveAlloc.allocations == 1 && reserved.GetSize() == 0);
+    reserved.Finish(ConvertAny(&multi, reserved));
+    const size_t held = reserved.GetSize();
+    ReserveBuilder(reserved, 1 << 20);
+    assert(reserved.GetSize() == held);
+
+    // Scalars: a string needs room for its worst-case UTF-8 body.
+    XLOPER12 str;
+    str.xltype = xltypeStr;
+    str.val.str = word;
+    assert(EstimateSerializedSize(&str) >= 5 * 3);
+    assert(EstimateSerializedSize(nullptr) == 0);
+    std::cout << "TestPresizedConversion passed" << std::endl;
+}
+
+void TestGridToXLOPER12Slab() {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> cells = {
+        protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, builder.CreateString("hello")).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Num, protocol::CreateNum(builder, 1.5).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, builder.CreateString("\xE2\x82\xAC\xE4\xB8\xAD")).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder, builder.CreateString("")).Union()),
+        protocol::CreateScalar(builder, protocol::ScalarValue::Str, protocol::CreateStr(builder).Union()), // no string
+        protocol::CreateScalar(builder, protocol::ScalarValue::Nil, protocol::CreateNil(builder).Union())};
+    builder.Finish(protocol::CreateGridDirect(builder, 3, 2, &cells));
+    auto* grid = flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer());
+
+    LPXLOPER12 perCell = GridToXLOPER12(grid);
+    LPXLOPER12 slab = GridToXLOPER12(grid, XlGridAlloc::Slab);
+    assert(slab->xltype == (xltypeMulti | xlbitDLLFree));
+    assert(slab->val.array.rows == 3 && slab->val.array.columns == 2);
+
+    // Same values; strings live after the elements inside the one block and
+    // carry no per-element ownership bit.
+    const XLOPER12* a = perCell->val.array.lparray;
+    const XLOPER12* b = slab->val.array.lparray;
+    const XCHAR* bodies = reinterpret_cast<const XCHAR*>(b + 6);
+    for (int i = 0; i < 6; ++i) {
+        const DWORD type = a[i].xltype & ~xlbitDLLFree;
+        assert(b[i].xltype == type);
+        if (type == xltypeStr) {
+            assert(b[i].val.str >= bodies);
+            assert(b[i].val.str[0] == a[i].val.str[0]);
+            assert(std::memcmp(b[i].val.str, a[i].val.str, (a[i].val.str[0] + 2) * sizeof(XCHAR)) == 0);
+        }
+    }
+    assert(ConvertExcelString(b[0].val.str) == "hello");
+    assert(b[2].val.str[0] == 2 && b[2].val.str[1] == 0x20AC && b[2].val.str[2] == 0x4E2D);
+    assert(b[4].val.str[0] == 0 && b[4].val.str[1] == 0);
+    assert(b[1].val.num == 1.5 && b[5].xltype == xltypeNil);
+
+    // One deallocation for the whole array.
+    FreeDllOwnedContents(slab);
+    assert(slab->val.array.lparray == nullptr);
+    ReleaseXLOPER12(slab);
+    xlAutoFree12(perCell);
+
+    // Through AnyToXLOPER12, and freed by xlAutoFree12.
+    flatbuffers::FlatBufferBuilder b2;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> one = {
+        protocol::CreateScalar(b2, protocol::ScalarValue::Str, protocol::CreateStr(b2, b2.CreateString("x")).Union())};
+    b2.Finish(protocol::CreateAny(b2, protocol::AnyValue::Grid, protocol::CreateGridDirect(b2, 1, 1, &one).Union()));
+    LPXLOPER12 res = AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(b2.GetBufferPointer()), XlGridAlloc::Slab);
+    assert(res->val.array.lparray[0].xltype == xltypeStr);
+    xlAutoFree12(res);
+
+    // Empty grids and malformed payloads behave as in PerCell mode.
+    flatbuffers::FlatBufferBuilder b3;
+    b3.Finish(protocol::CreateGrid(b3, 2, 2));
+    res = GridToXLOPER12(flatbuffers::GetRoot<protocol::Grid>(b3.GetBufferPointer()), XlGridAlloc::Slab);
+    assert(res->xltype == (xltypeErr | xlbitDLLFree) && res->val.err == xlerrValue);
+    xlAutoFree12(res);
+    std::cout << "TestGridToXLOPER12Slab passed" << std::endl;
+}
+
 void TestRangeConversion() {
     flatbuffers::FlatBufferBuilder builder;
     std::vector<protocol::Rect> rects;
@@ -381,8 +959,19 @@ int main() {
     TestBoolConversion();
     TestErrConversion();
     TestStrConversion();
+    TestCreateStringFromExcelMatchesCreateString();
     TestGridConversion();
     TestNumGridConversion();
+    TestColumnGridRoundTrip();
+    TestColumnGridSelection();
+    TestColumnGridMalformed();
+    TestNumGridExRoundTrip();
+    TestNumGridExMalformed();
+    TestSparseGridRoundTrip();
+    TestSparseGridMalformed();
+    TestGridProfile();
+    TestPresizedConversion();
+    TestGridToXLOPER12Slab();
     TestRangeConversion();
     TestAnyDateBecomesNum();
     TestGridDateCellBecomesNum();
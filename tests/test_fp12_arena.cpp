@@ -0,0 +1,199 @@
+// Per-thread FP12 arena (NewFP12 in include/types/mem.h): results stay valid
+// for 8 calls, buffers are reused but oversized ones are released, trims free
+// a thread's buffers (an idle thread's too), debug mode quarantines and poisons stale FP12s, and the
+// retained-bytes counters are visible per thread.
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/mem.h"
+
+static void Reset() {
+    SetFP12DebugChecks(false);
+    SetFP12ArenaLimit(kDefaultFP12RetainedBytes);
+    TrimFP12Arena();
+    FP12ArenaStats s = GetFP12ArenaStats();
+    assert(s.retainedBytes == 0 && s.liveBytes == 0);
+}
+
+void TestValidityWindow() {
+    std::vector<FP12*> fps;
+    for (int i = 0; i < 8; ++i) {
+        FP12* fp = NewFP12(2, 3);
+        assert(fp->rows == 2 && fp->columns == 3);
+        for (int k = 0; k < 6; ++k) fp->array[k] = i * 10 + k;
+        fps.push_back(fp);
+    }
+    // The last 8 results are distinct and untouched.
+    for (int i = 0; i < 8; ++i) {
+        assert(CheckFP12(fps[i]) == FP12State::Live);
+        for (int k = 0; k < 6; ++k) assert(fps[i]->array[k] == i * 10 + k);
+    }
+
+    uint64_t gen = 0;
+    const uint64_t before = GetFP12ArenaStats().generation;
+    FP12* ninth = NewFP12(2, 3);
+    assert(CheckFP12(ninth, &gen) == FP12State::Live && gen == before + 1);
+    assert(ninth == fps[0]); // same slot, buffer reused in place
+
+    int local = 0;
+    assert(CheckFP12(reinterpret_cast<FP12*>(&local)) == FP12State::Unknown);
+
+    Reset();
+    std::cout << "TestValidityWindow passed" << std::endl;
+}
+
+void TestReuseAndOversize() {
+    SetFP12ArenaLimit(8 * 4096); // 4 KiB kept per slot
+
+    const FP12ArenaStats start = GetFP12ArenaStats();
+    for (int i = 0; i < 8; ++i) NewFP12(10, 10);
+    FP12ArenaStats s = GetFP12ArenaStats();
+    assert(s.allocations == start.allocations + 8 && s.reuses == start.reuses);
+    for (int i = 0; i < 8; ++i) NewFP12(5, 5); // fits, not oversized
+    s = GetFP12ArenaStats();
+    assert(s.allocations == start.allocations + 8 && s.reuses == start.reuses + 8);
+
+    // A one-off 1000x100 grid (800 KB) is live while in the window...
+    NewFP12(1000, 100);
+    s = GetFP12ArenaStats();
+    assert(s.retainedBytes >= 800000 && s.liveBytes >= 800000);
+    // ...and released once its slot comes round with a small request.
+    for (int i = 0; i < 8; ++i) NewFP12(2, 2);
+    s = GetFP12ArenaStats();
+    assert(s.retainedBytes < 8 * 4096);
+
+    // Too-small buffers are replaced.
+    const size_t allocations = s.allocations;
+    FP12* big = NewFP12(100, 100);
+    big->array[9999] = 1.0;
+    assert(GetFP12ArenaStats().allocations == allocations + 1);
+
+    // Degenerate and invalid shapes.
+    FP12* empty = NewFP12(0, 0);
+    assert(empty->rows == 0 && empty->columns == 0);
+    bool threw = false;
+    try {
+        NewFP12(-1, 4);
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    assert(threw);
+
+    Reset();
+    std::cout << "TestReuseAndOversize passed" << std::endl;
+}
+
+void TestTrim() {
+    for (int i = 0; i < 4; ++i) NewFP12(50, 50);
+    FP12ArenaStats s = GetFP12ArenaStats();
+    assert(s.retainedBytes >= 4 * 2500 * sizeof(double));
+    const size_t trims = s.trims;
+    TrimFP12Arena();
+    s = GetFP12ArenaStats();
+    assert(s.retainedBytes == 0 && s.liveBytes == 0 && s.trims == trims + 1);
+
+    // A requested trim frees an idle arena at once, and only once.
+    NewFP12(50, 50);
+    RequestFP12ArenaTrim();
+    s = GetFP12ArenaStats();
+    assert(s.trims == trims + 2 && s.retainedBytes == 0);
+    FP12* fp = NewFP12(1, 1);
+    s = GetFP12ArenaStats();
+    assert(s.trims == trims + 2 && s.retainedBytes < 50 * 50 * sizeof(double));
+    assert(CheckFP12(fp) == FP12State::Live);
+
+    Reset();
+    std::cout << "TestTrim passed" << std::endl;
+}
+
+void TestDebugStaleDetection() {
+    SetFP12DebugChecks(true);
+    const size_t reuses = GetFP12ArenaStats().reuses;
+
+    FP12* first = NewFP12(2, 2);
+    first->array[0] = 42.0;
+    uint64_t firstGen = 0;
+    assert(CheckFP12(first, &firstGen) == FP12State::Live);
+    for (int i = 0; i < 8; ++i) NewFP12(2, 2);
+
+    // The slot moved on to a fresh buffer; the old one is poisoned.
+    uint64_t gen = 0;
+    assert(CheckFP12(first, &gen) == FP12State::Stale && gen == firstGen);
+    assert(first->rows == -1 && first->columns == -1);
+    assert(std::isnan(first->array[0]));
+
+    // Quarantine is bounded (the oldest buffers are freed, so their addresses
+    // may come back); every buffer still counts as retained.
+    for (int i = 0; i < 200; ++i) NewFP12(2, 2);
+    FP12ArenaStats s = GetFP12ArenaStats();
+    assert(s.reuses == reuses);
+    assert(s.retainedBytes <= (64 + 8) * 64);
+
+    Reset();
+    std::cout << "TestDebugStaleDetection passed" << std::endl;
+}
+
+void TestPerThreadCounters() {
+    Reset();
+    const int kThreads = 4;
+    std::vector<std::thread> workers;
+    std::vector<FP12*> made(kThreads);
+    std::atomic<int> ready{0};
+    std::atomic<bool> done{false};
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            made[t] = NewFP12(100, t + 1);
+            ready.fetch_add(1);
+            while (!done.load()) std::this_thread::yield();
+        });
+    }
+    while (ready.load() < kThreads) std::this_thread::yield();
+
+    // Every worker's arena is listed with its own retained bytes; this
+    // thread's buffers are kept apart from theirs.
+    std::vector<FP12ArenaStats> all = GetAllFP12ArenaStats();
+    size_t workerBytes = 0, workerArenas = 0;
+    for (const FP12ArenaStats& s : all) {
+        if (s.thread == std::this_thread::get_id()) continue;
+        if (s.generation == 1) {
+            ++workerArenas;
+            workerBytes += s.retainedBytes;
+        }
+    }
+    assert(workerArenas == kThreads);
+    assert(workerBytes >= 100 * (1 + 2 + 3 + 4) * sizeof(double));
+    assert(CheckFP12(made[0]) == FP12State::Unknown); // another thread's arena
+    assert(GetFP12ArenaStats().retainedBytes == 0);
+
+    // The workers are idle, so a requested trim frees their buffers now.
+    RequestFP12ArenaTrim();
+    for (const FP12ArenaStats& s : GetAllFP12ArenaStats()) {
+        if (s.generation == 1) assert(s.retainedBytes == 0 && s.liveBytes == 0);
+    }
+
+    done.store(true);
+    for (std::thread& w : workers) w.join();
+    // Exited threads free their buffers and leave the registry.
+    for (const FP12ArenaStats& s : GetAllFP12ArenaStats()) assert(s.generation != 1 || s.thread == std::this_thread::get_id());
+
+    std::cout << "TestPerThreadCounters passed" << std::endl;
+}
+
+int main() {
+    TestValidityWindow();
+    TestReuseAndOversize();
+    TestTrim();
+    TestDebugStaleDetection();
+    TestPerThreadCounters();
+    std::cout << "All FP12 arena tests passed" << std::endl;
+    return 0;
+}
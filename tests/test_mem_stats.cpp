@@ -0,0 +1,221 @@
+// Live-memory accounting (GetMemStats in include/types/mem.h): every
+// DLL-owned payload kind is counted on allocation and on xlAutoFree12, peaks
+// track the high-water mark (also across threads), and a build without
+// TYPES_MEM_STATS reports nothing. Built either way; the assertions follow `enabled`.
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/mem.h"
+#include "types/converters.h"
+
+static MemKindStats Delta(const MemStats& before, const MemStats& after, MemKind kind) {
+    MemKindStats d;
+    d.liveObjects = after[kind].liveObjects - before[kind].liveObjects;
+    d.liveBytes = after[kind].liveBytes - before[kind].liveBytes;
+    d.allocations = after[kind].allocations - before[kind].allocations;
+    d.frees = after[kind].frees - before[kind].frees;
+    return d;
+}
+
+static LPXLOPER12 MakeGrid(int rows, int cols, XlGridAlloc alloc) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> cells;
+    for (int i = 0; i < rows * cols; ++i) {
+        if (i % 2) {
+            cells.push_back(protocol::CreateScalar(builder, protocol::ScalarValue::Str,
+                                                   protocol::CreateStr(builder, builder.CreateString("cell" + std::to_string(i))).Union()));
+        } else {
+            cells.push_back(protocol::CreateScalar(builder, protocol::ScalarValue::Num,
+                                                   protocol::CreateNum(builder, (double)i).Union()));
+        }
+    }
+    builder.Finish(protocol::CreateGrid(builder, rows, cols, builder.CreateVector(cells)));
+    return GridToXLOPER12(flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer()), alloc);
+}
+
+void TestDisabled() {
+    MemStats s = GetMemStats();
+    if (s.enabled) return;
+    LPXLOPER12 str = NewExcelString(L"not counted");
+    s = GetMemStats();
+    for (size_t k = 0; k < kMemKinds; ++k) {
+        assert(s.kinds[k].liveObjects == 0 && s.kinds[k].allocations == 0);
+    }
+    xlAutoFree12(str);
+    std::cout << "TestDisabled passed" << std::endl;
+}
+
+void TestStrings() {
+    if (!GetMemStats().enabled) return;
+    const MemStats before = GetMemStats();
+
+    LPXLOPER12 shortStr = NewExcelString(L"short");                 // slab, 16-unit class
+    LPXLOPER12 longStr = NewExcelString(std::wstring(1000, L'x'));  // heap
+    MemStats mid = GetMemStats();
+    MemKindStats d = Delta(before, mid, MemKind::Str);
+    assert(d.liveObjects == 2 && d.allocations == 2);
+    assert(d.liveBytes == (int64_t)((16 + 1002) * sizeof(XCHAR))); // prefix + body + NUL
+    assert(mid[MemKind::Str].peakObjects >= mid[MemKind::Str].liveObjects);
+    d = Delta(before, mid, MemKind::XLOPER12);
+    assert(d.liveObjects == 2 && d.liveBytes == (int64_t)(2 * sizeof(XLOPER12)));
+
+    xlAutoFree12(shortStr);
+    xlAutoFree12(longStr);
+    MemStats after = GetMemStats();
+    d = Delta(before, after, MemKind::Str);
+    assert(d.liveObjects == 0 && d.liveBytes == 0 && d.frees == 2);
+    assert(Delta(before, after, MemKind::XLOPER12).liveObjects == 0);
+
+    // A foreign new[] string tagged xlbitDLLFree is freed but not counted.
+    LPXLOPER12 foreign = NewXLOPER12();
+    foreign->xltype = xltypeStr | xlbitDLLFree;
+    foreign->val.str = new XCHAR[4]{3, L'a', L'b', L'c'};
+    xlAutoFree12(foreign);
+    assert(Delta(after, GetMemStats(), MemKind::Str).frees == 0);
+
+    std::cout << "TestStrings passed" << std::endl;
+}
+
+void TestGrids() {
+    if (!GetMemStats().enabled) return;
+    const MemStats before = GetMemStats();
+
+    LPXLOPER12 perCell = MakeGrid(4, 5, XlGridAlloc::PerCell);
+    MemStats mid = GetMemStats();
+    MemKindStats d = Delta(before, mid, MemKind::Multi);
+    assert(d.liveObjects == 1 && d.liveBytes == (int64_t)(20 * sizeof(XLOPER12)));
+    assert(Delta(before, mid, MemKind::Str).liveObjects == 10);
+    xlAutoFree12(perCell);
+    MemStats after = GetMemStats();
+    assert(Delta(before, after, MemKind::Multi).liveBytes == 0);
+    assert(Delta(before, after, MemKind::Str).liveObjects == 0);
+
+    // A slab grid is one Multi payload holding the string bodies too.
+    LPXLOPER12 slab = MakeGrid(4, 5, XlGridAlloc::Slab);
+    mid = GetMemStats();
+    d = Delta(after, mid, MemKind::Multi);
+    assert(d.liveObjects == 1 && d.liveBytes > (int64_t)(20 * sizeof(XLOPER12)));
+    assert(Delta(after, mid, MemKind::Str).allocations == 0);
+    xlAutoFree12(slab);
+    d = Delta(after, GetMemStats(), MemKind::Multi);
+    assert(d.liveObjects == 0 && d.liveBytes == 0 && d.frees == 1);
+
+    // NumGrid results fill a plain element array.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<double> nums(12, 2.5);
+    auto ng = protocol::CreateNumGrid(builder, 3, 4, builder.CreateVector(nums));
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+    const MemStats beforeNum = GetMemStats();
+    LPXLOPER12 num = AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer()));
+    assert(Delta(beforeNum, GetMemStats(), MemKind::Multi).liveBytes == (int64_t)(12 * sizeof(XLOPER12)));
+    xlAutoFree12(num);
+    assert(Delta(beforeNum, GetMemStats(), MemKind::Multi).liveBytes == 0);
+
+    std::cout << "TestGrids passed" << std::endl;
+}
+
+void TestRefs() {
+    if (!GetMemStats().enabled) return;
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<protocol::Rect> rects = {protocol::Rect(0, 1, 0, 1), protocol::Rect(4, 4, 2, 3)};
+    builder.Finish(protocol::CreateRange(builder, builder.CreateString(""), builder.CreateVectorOfStructs(rects)));
+
+    const MemStats before = GetMemStats();
+    LPXLOPER12 ref = RangeToXLOPER12(flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer()));
+    assert(ref->xltype == (xltypeRef | xlbitDLLFree));
+    MemKindStats d = Delta(before, GetMemStats(), MemKind::Ref);
+    assert(d.liveObjects == 1 && d.liveBytes == (int64_t)(sizeof(XLMREF12) + sizeof(XLREF12))); // holds one already
+    xlAutoFree12(ref);
+    d = Delta(before, GetMemStats(), MemKind::Ref);
+    assert(d.liveObjects == 0 && d.liveBytes == 0 && d.frees == 1);
+
+    std::cout << "TestRefs passed" << std::endl;
+}
+
+void TestFP12() {
+    if (!GetMemStats().enabled) return;
+    TrimFP12Arena();
+    const MemStats before = GetMemStats();
+
+    FP12* fp = NewFP12(10, 10);
+    assert(fp);
+    MemKindStats d = Delta(before, GetMemStats(), MemKind::FP12);
+    assert(d.liveObjects == 1 && d.liveBytes >= (int64_t)(100 * sizeof(double)));
+
+    // Each new result retires a slot's previous one; trimming retires them all.
+    for (int i = 0; i < 20; ++i) NewFP12(2, 2);
+    assert(GetMemStats()[MemKind::FP12].liveObjects - before[MemKind::FP12].liveObjects <= 8);
+    TrimFP12Arena();
+    d = Delta(before, GetMemStats(), MemKind::FP12);
+    assert(d.liveObjects == 0 && d.liveBytes == 0 && d.allocations == 21 && d.frees == 21);
+
+    std::cout << "TestFP12 passed" << std::endl;
+}
+
+void TestPeaksAndRate() {
+    if (!GetMemStats().enabled) return;
+    const MemStats start = GetMemStats();
+
+    std::vector<LPXLOPER12> held;
+    for (int i = 0; i < 50; ++i) held.push_back(NewExcelString(L"peak"));
+    for (LPXLOPER12 p : held) xlAutoFree12(p);
+    MemStats s = GetMemStats();
+    assert(s[MemKind::Str].peakObjects >= start[MemKind::Str].liveObjects + 50);
+
+    ResetMemStatsPeaks();
+    s = GetMemStats();
+    assert(s[MemKind::Str].peakObjects == s[MemKind::Str].liveObjects);
+    assert(s[MemKind::Str].peakBytes == s[MemKind::Str].liveBytes);
+
+    assert(AllocationsPerSecond(start, s, MemKind::Str) > 0);
+    assert(AllocationsPerSecond(s, start, MemKind::Str) == 0);
+    assert(std::string(MemKindName(MemKind::Multi)) == "multi");
+
+    std::cout << "TestPeaksAndRate passed" << std::endl;
+}
+
+void TestAcrossThreads() {
+    if (!GetMemStats().enabled) return;
+    ResetMemStatsPeaks();
+    const MemStats before = GetMemStats();
+
+    // Allocated on a worker (past several flush batches), freed here.
+    std::vector<LPXLOPER12> made;
+    std::thread worker([&]() {
+        for (int i = 0; i < 300; ++i) made.push_back(NewExcelString(L"worker"));
+        MemKindStats d = Delta(before, GetMemStats(), MemKind::Str);
+        assert(d.liveObjects == 300 && d.allocations == 300);
+    });
+    worker.join(); // exiting folds the worker's counters into the totals
+    MemStats mid = GetMemStats();
+    assert(Delta(before, mid, MemKind::Str).liveObjects == 300);
+    assert(mid[MemKind::Str].peakObjects >= before[MemKind::Str].liveObjects + 300);
+
+    for (LPXLOPER12 p : made) xlAutoFree12(p);
+    MemStats after = GetMemStats();
+    MemKindStats d = Delta(before, after, MemKind::Str);
+    assert(d.liveObjects == 0 && d.liveBytes == 0 && d.allocations == 300 && d.frees == 300);
+    assert(after[MemKind::Str].peakObjects >= before[MemKind::Str].liveObjects + 300);
+
+    std::cout << "TestAcrossThreads passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Memory accounting " << (GetMemStats().enabled ? "enabled" : "disabled") << std::endl;
+    TestDisabled();
+    TestStrings();
+    TestGrids();
+    TestRefs();
+    TestFP12();
+    TestPeaksAndRate();
+    TestAcrossThreads();
+    std::cout << "All memory accounting tests passed" << std::endl;
+    return 0;
+}
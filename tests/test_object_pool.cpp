@@ -0,0 +1,347 @@
+// ObjectPool (include/types/ObjectPool.h): per-thread magazines in front of
+// the sharded pool. Objects are reused without a lock on the same thread,
+// move between threads in half-magazine batches, are spilled back at thread
+// exit and freed by the pool destructor wherever they are held. Shards are
+// bounded by maxPerShard, Trim / TrimIdle free idle objects, and GetStats
+// counts the traffic.
+
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/ObjectPool.h"
+#include "types/mem.h"
+
+struct Counted {
+    static std::atomic<int> live;
+    int value = 0;
+    Counted() { live.fetch_add(1); }
+    ~Counted() { live.fetch_sub(1); }
+};
+std::atomic<int> Counted::live{0};
+
+typedef ObjectPool<Counted, 4, 8> SmallPool; // 8-object magazines
+
+void TestSameThreadReuse() {
+    {
+        SmallPool pool;
+        Counted* a = pool.Acquire();
+        pool.Release(a);
+        assert(pool.Acquire() == a); // LIFO from the magazine
+        pool.Release(a);
+        pool.Release(nullptr);       // ignored
+        assert(Counted::live == 1);
+    }
+    assert(Counted::live == 0);
+    std::cout << "TestSameThreadReuse passed" << std::endl;
+}
+
+void TestSpillAndRefill() {
+    {
+        SmallPool pool;
+        std::vector<Counted*> items;
+        for (int i = 0; i < 40; ++i) items.push_back(pool.Acquire());
+        assert(Counted::live == 40);
+        for (Counted* c : items) pool.Release(c); // spills past 8 in batches of 4
+
+        // Everything is reused: refills pull from the shard, no new objects.
+        std::set<Counted*> seen;
+        for (int i = 0; i < 40; ++i) seen.insert(pool.Acquire());
+        assert(seen.size() == 40 && Counted::live == 40);
+        for (Counted* c : seen) pool.Release(c);
+
+        pool.Clear();
+        assert(Counted::live == 0);
+    }
+    std::cout << "TestSpillAndRefill passed" << std::endl;
+}
+
+void TestCrossThread() {
+    {
+        SmallPool pool;
+        std::vector<Counted*> items;
+        std::thread producer([&]() {
+            for (int i = 0; i < 100; ++i) items.push_back(pool.Acquire());
+        });
+        producer.join();
+
+        // Released on another thread; that thread's exit spills its magazine.
+        std::thread consumer([&]() {
+            for (Counted* c : items) pool.Release(c);
+        });
+        consumer.join();
+        assert(Counted::live == 100);
+
+        // The spilled objects are reachable from a third thread (same shard
+        // or not, nothing is lost or duplicated).
+        const int before = Counted::live;
+        std::thread user([&]() {
+            std::vector<Counted*> got;
+            for (int i = 0; i < 100; ++i) got.push_back(pool.Acquire());
+            for (Counted* c : got) pool.Release(c);
+        });
+        user.join();
+        assert(Counted::live >= before && Counted::live <= before + 100);
+    }
+    assert(Counted::live == 0);
+    std::cout << "TestCrossThread passed" << std::endl;
+}
+
+void TestDestroyWithLiveMagazine() {
+    std::atomic<bool> filled{false}, done{false};
+    std::thread holder;
+    {
+        SmallPool pool;
+        holder = std::thread([&]() {
+            Counted* c[6];
+            for (Counted*& p : c) p = pool.Acquire();
+            for (Counted* p : c) pool.Release(p); // stays in this magazine
+            filled = true;
+            while (!done) std::this_thread::yield();
+        });
+        while (!filled) std::this_thread::yield();
+        assert(Counted::live == 6);
+    } // pool frees the idle holder thread's magazine
+    assert(Counted::live == 0);
+    done = true;
+    holder.join(); // thread exit must not touch the destroyed pool
+
+    // A new pool on the same thread gets its own magazine.
+    SmallPool again;
+    again.Release(again.Acquire());
+    assert(Counted::live == 1);
+    again.Clear();
+    assert(Counted::live == 0);
+    std::cout << "TestDestroyWithLiveMagazine passed" << std::endl;
+}
+
+void TestConcurrentChurn() {
+    {
+        ObjectPool<Counted> pool;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&pool, t]() {
+                std::vector<Counted*> held;
+                for (int i = 0; i < 20000; ++i) {
+                    if (held.size() < 100 && (i % 3 != 0)) {
+                        Counted* c = pool.Acquire();
+                        c->value = t;
+                        held.push_back(c);
+                    } else if (!held.empty()) {
+                        assert(held.back()->value == t);
+                        pool.Release(held.back());
+                        held.pop_back();
+                    }
+                }
+                for (Counted* c : held) pool.Release(c);
+            });
+        }
+        for (auto& th : threads) th.join();
+        assert(Counted::live <= 8 * 100);
+    }
+    assert(Counted::live == 0);
+    std::cout << "TestConcurrentChurn passed" << std::endl;
+}
+
+void TestShardLimit() {
+    {
+        SmallPool pool(6); // at most 6 idle objects per shard
+        std::vector<Counted*> items;
+        for (int i = 0; i < 40; ++i) items.push_back(pool.Acquire());
+        for (Counted* c : items) pool.Release(c);
+
+        // One thread spills into one shard: 6 kept there, 8 in the magazine,
+        // the rest freed on spill.
+        SmallPool::Stats s = pool.GetStats();
+        assert(s.pooled == 6 + 8 && Counted::live == 6 + 8);
+        assert(s.frees == 40 - 14);
+        size_t maxShard = 0;
+        for (size_t n : s.shardSize) maxShard = std::max(maxShard, n);
+        assert(maxShard == 6);
+
+        pool.SetMaxPerShard(2);
+        assert(pool.MaxPerShard() == 2);
+    }
+    assert(Counted::live == 0);
+    std::cout << "TestShardLimit passed" << std::endl;
+}
+
+void TestTrim() {
+    {
+        SmallPool pool;
+        std::vector<Counted*> items;
+        for (int i = 0; i < 100; ++i) items.push_back(pool.Acquire());
+        for (Counted* c : items) pool.Release(c);
+        assert(pool.GetStats().pooled == 100);
+
+        // targetBytes is split across the 4 shards; the magazine is spilled
+        // first, so everything lands in this thread's shard.
+        size_t freed = pool.Trim(4 * 10 * sizeof(Counted));
+        assert(freed == 90 && Counted::live == 10);
+        SmallPool::Stats s = pool.GetStats();
+        assert(s.pooled == 10 && s.pooledBytes == 10 * sizeof(Counted));
+
+        // Recently used shards survive an idle trim; an unused pool drains.
+        assert(pool.TrimIdle(std::chrono::hours(1)) == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        assert(pool.TrimIdle(std::chrono::milliseconds(10)) == 10);
+        assert(Counted::live == 0 && pool.GetStats().pooled == 0);
+    }
+    std::cout << "TestTrim passed" << std::endl;
+}
+
+void TestStats() {
+    {
+        SmallPool pool;
+        Counted* a = pool.Acquire(); // miss
+        pool.Release(a);
+        a = pool.Acquire();          // hit
+        pool.Release(a);
+        std::thread other([&]() {
+            Counted* b = pool.Acquire(); // miss (other shard/magazine)
+            pool.Release(b);
+        });
+        other.join(); // counters of an exited thread are kept
+
+        SmallPool::Stats s = pool.GetStats();
+        assert(s.acquires == 3 && s.hits == 1 && s.misses == 2);
+        assert(s.releases == 3 && s.pooled == 2);
+        size_t spills = 0;
+        for (size_t n : s.shardSpills) spills += n;
+        assert(spills == 1); // the exiting thread's magazine
+    }
+    std::cout << "TestStats passed" << std::endl;
+}
+
+struct Fragile {
+    static int budget; // constructions left before one throws
+    static int live;
+    Fragile() {
+        if (budget-- <= 0) throw std::bad_alloc();
+        ++live;
+    }
+    ~Fragile() { --live; }
+};
+int Fragile::budget = 0;
+int Fragile::live = 0;
+
+void TestBulk() {
+    {
+        SmallPool pool;
+        std::vector<Counted*> items(100);
+        pool.AcquireBulk(items.data(), items.size());
+        assert(Counted::live == 100);
+        assert(std::set<Counted*>(items.begin(), items.end()).size() == 100);
+        SmallPool::Stats s = pool.GetStats();
+        assert(s.acquires == 100 && s.misses == 100);
+
+        // 8 fill the magazine, 92 go to the shard under one lock.
+        items.push_back(nullptr);
+        pool.ReleaseBulk(items.data(), items.size());
+        s = pool.GetStats();
+        assert(s.releases == 100 && s.pooled == 100);
+        size_t spills = 0;
+        for (size_t n : s.shardSpills) spills += n;
+        assert(spills == 1);
+
+        // Everything comes back without allocating, with one shard visit.
+        size_t refillsBefore = 0;
+        for (size_t n : s.shardRefills) refillsBefore += n;
+        std::vector<Counted*> again(100);
+        pool.AcquireBulk(again.data(), again.size());
+        s = pool.GetStats();
+        assert(Counted::live == 100 && s.misses == 100 && s.hits == 100);
+        size_t refills = 0;
+        for (size_t n : s.shardRefills) refills += n;
+        assert(refills == refillsBefore + 1);
+        items.pop_back();
+        assert(std::set<Counted*>(again.begin(), again.end()) == std::set<Counted*>(items.begin(), items.end()));
+
+        // The shard limit applies to bulk releases too.
+        pool.SetMaxPerShard(10);
+        pool.ReleaseBulk(again.data(), again.size());
+        assert(pool.GetStats().pooled == 8 + 10 && Counted::live == 18);
+        pool.AcquireBulk(again.data(), 0);
+        pool.ReleaseBulk(again.data(), 0);
+    }
+    assert(Counted::live == 0);
+
+    {
+        // A throwing constructor leaves nothing leaked or half-counted.
+        ObjectPool<Fragile, 4, 8> pool;
+        std::vector<Fragile*> items(20);
+        Fragile::budget = 12;
+        bool threw = false;
+        try {
+            pool.AcquireBulk(items.data(), items.size());
+        } catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        assert(threw && Fragile::live == 12);
+        auto s = pool.GetStats();
+        assert(s.acquires == 0 && s.pooled == 12);
+        Fragile::budget = 100;
+        pool.AcquireBulk(items.data(), items.size());
+        assert(Fragile::live == 20 && pool.GetStats().misses == 8);
+        pool.ReleaseBulk(items.data(), items.size());
+    }
+    assert(Fragile::live == 0);
+    std::cout << "TestBulk passed" << std::endl;
+}
+
+void TestXLOPER12Pool() {
+    TrimXLOPER12Pool();
+    const XLOPER12Pool::Stats before = GetXLOPER12PoolStats();
+    std::vector<LPXLOPER12> ops;
+    for (int i = 0; i < 200; ++i) ops.push_back(NewXLOPER12());
+    for (LPXLOPER12 p : ops) ReleaseXLOPER12(p);
+    XLOPER12Pool::Stats s = GetXLOPER12PoolStats();
+    assert(s.acquires == before.acquires + 200 && s.releases == before.releases + 200);
+    assert(s.pooled >= 200);
+
+    assert(TrimXLOPER12Pool(0) >= 200);
+    assert(GetXLOPER12PoolStats().pooled == 0);
+
+    // With a limit of 16 per shard, only 16 + one magazine stay pooled.
+    SetXLOPER12PoolLimit(16);
+    ops.clear();
+    for (int i = 0; i < 200; ++i) ops.push_back(NewXLOPER12());
+    for (LPXLOPER12 p : ops) ReleaseXLOPER12(p);
+    assert(GetXLOPER12PoolStats().pooled <= 16 + 64);
+    SetXLOPER12PoolLimit(XLOPER12Pool::kDefaultMaxPerShard);
+    TrimXLOPER12Pool();
+
+    // Batch API: every XLOPER12 comes back zeroed, reused ones included.
+    LPXLOPER12 batch[50];
+    NewXLOPER12Batch(batch, 50);
+    for (LPXLOPER12 p : batch) p->xltype = xltypeNum;
+    ReleaseXLOPER12Batch(batch, 50);
+    NewXLOPER12Batch(batch, 50);
+    for (LPXLOPER12 p : batch) assert(p->xltype == 0 && p->val.num == 0);
+    ReleaseXLOPER12Batch(batch, 50);
+    std::cout << "TestXLOPER12Pool passed" << std::endl;
+}
+
+int main() {
+    TestSameThreadReuse();
+    TestSpillAndRefill();
+    TestCrossThread();
+    TestDestroyWithLiveMagazine();
+    TestConcurrentChurn();
+    TestShardLimit();
+    TestTrim();
+    TestStats();
+    TestBulk();
+    TestXLOPER12Pool();
+    std::cout << "All ObjectPool tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,200 @@
+// ConvertRangeWithValues against a mock Excel12: one xlCoerce per area, the
+// values line up with the rects and use the usual encodings (scalar, NumGrid,
+// Grid), a failed area drops the whole `values` field and reports its code,
+// and ConvertRange itself still sends no values.
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+#include "types/mem.h"
+
+typedef int (PASCAL *EXCEL12PROC) (int xlfn, int coper, LPXLOPER12 *rgpxloper12, LPXLOPER12 xloper12Res);
+extern "C" void pascal SetExcel12EntryPt(EXCEL12PROC pexcel12New);
+
+static int g_coerceCalls = 0;
+static int g_freeCalls = 0;
+static int g_uncalcedRow = -1; // an area starting on this row is not calculated
+static std::vector<std::vector<XLOPER12>> g_arrays;
+static std::vector<XCHAR> g_text = {3, 'a', 'b', 'c'};
+
+static double CellValue(int row, int col) { return row * 1000.0 + col; }
+
+// xlCoerce of a single-area reference: a number per cell; column 9 holds text
+// so that an area spanning it is not all numbers.
+int PASCAL MockExcel12(int xlfn, int coper, LPXLOPER12 *rgpxloper12, LPXLOPER12 xloper12Res) {
+    if (xlfn == xlFree) {
+        ++g_freeCalls;
+        return xlretSuccess;
+    }
+    if (xlfn != xlCoerce) return xlretFailed; // no sheet names here
+    ++g_coerceCalls;
+    assert(coper == 1);
+    const XLOPER12* ref = rgpxloper12[0];
+    XLREF12 r;
+    if (ref->xltype == xltypeSRef) {
+        r = ref->val.sref.ref;
+    } else {
+        assert(ref->xltype == xltypeRef && ref->val.mref.lpmref->count == 1);
+        assert(ref->val.mref.idSheet == 42);
+        r = ref->val.mref.lpmref->reftbl[0];
+    }
+    if (r.rwFirst == g_uncalcedRow) return xlretUncalced;
+
+    const int rows = r.rwLast - r.rwFirst + 1, cols = r.colLast - r.colFirst + 1;
+    if (rows == 1 && cols == 1) {
+        xloper12Res->xltype = xltypeNum;
+        xloper12Res->val.num = CellValue(r.rwFirst, r.colFirst);
+        return xlretSuccess;
+    }
+    g_arrays.emplace_back((size_t)rows * cols);
+    std::vector<XLOPER12>& cells = g_arrays.back();
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            XLOPER12& cell = cells[(size_t)i * cols + j];
+            if (r.colFirst + j == 9) {
+                cell.xltype = xltypeStr;
+                cell.val.str = g_text.data();
+            } else {
+                cell.xltype = xltypeNum;
+                cell.val.num = CellValue(r.rwFirst + i, r.colFirst + j);
+            }
+        }
+    }
+    xloper12Res->xltype = xltypeMulti;
+    xloper12Res->val.array.rows = rows;
+    xloper12Res->val.array.columns = cols;
+    xloper12Res->val.array.lparray = cells.data();
+    return xlretSuccess;
+}
+
+static XLOPER12 RefOn42(XLMREF12* mref) {
+    XLOPER12 op{};
+    op.xltype = xltypeRef;
+    op.val.mref.lpmref = mref;
+    op.val.mref.idSheet = 42;
+    return op;
+}
+
+static void FreeRef(XLOPER12& op) {
+    op.xltype |= xlbitDLLFree;
+    FreeDllOwnedContents(&op);
+}
+
+static const protocol::Range* Finish(flatbuffers::FlatBufferBuilder& builder, flatbuffers::Offset<protocol::Range> off) {
+    builder.Finish(off);
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(), builder.GetSize());
+    assert(verifier.VerifyBuffer<protocol::Range>(nullptr));
+    return flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer());
+}
+
+void TestMultiAreaRef() {
+    XLMREF12* mref = NewXLMREF12(3);
+    mref->count = 3;
+    mref->reftbl[0] = {2, 2, 3, 3};  // one cell
+    mref->reftbl[1] = {0, 2, 0, 1};  // 3 x 2 numbers
+    mref->reftbl[2] = {5, 6, 8, 9};  // 2 x 2 with a text column
+    XLOPER12 op = RefOn42(mref);
+
+    g_coerceCalls = g_freeCalls = 0;
+    flatbuffers::FlatBufferBuilder builder;
+    int ret = -1;
+    const protocol::Range* range = Finish(builder, ConvertRangeWithValues(&op, builder, "0.0", &ret));
+    assert(ret == xlretSuccess);
+    assert(g_coerceCalls == 3);
+    assert(g_freeCalls == 2); // both array results xlFree'd; a scalar owns nothing
+
+    assert(range->refs()->size() == 3 && range->format()->str() == "0.0");
+    assert(range->values() && range->values()->size() == 3);
+
+    const protocol::Any* cell = range->values()->Get(0);
+    assert(cell->val_type() == protocol::AnyValue::Num && cell->val_as_Num()->val() == CellValue(2, 3));
+
+    const protocol::NumGrid* nums = range->values()->Get(1)->val_as_NumGrid();
+    assert(nums && nums->rows() == 3 && nums->cols() == 2);
+    FP12* fp = NumGridToFP12(nums);
+    assert(fp->array[0] == CellValue(0, 0) && fp->array[5] == CellValue(2, 1));
+
+    const protocol::Any* mixed = range->values()->Get(2);
+    assert(mixed->val_type() != protocol::AnyValue::NumGrid && mixed->val_type() != protocol::AnyValue::Nil);
+    LPXLOPER12 back = AnyToXLOPER12(mixed);
+    assert((back->xltype & xltypeMulti) && back->val.array.rows == 2 && back->val.array.columns == 2);
+    assert(back->val.array.lparray[0].val.num == CellValue(5, 8));
+    assert((back->val.array.lparray[1].xltype & ~xlbitDLLFree) == xltypeStr);
+    xlAutoFree12(back);
+
+    FreeRef(op);
+    std::cout << "TestMultiAreaRef passed" << std::endl;
+}
+
+void TestSRef() {
+    XLOPER12 op{};
+    op.xltype = xltypeSRef;
+    op.val.sref.count = 1;
+    op.val.sref.ref = {10, 11, 1, 3};
+
+    g_coerceCalls = 0;
+    flatbuffers::FlatBufferBuilder builder;
+    const protocol::Range* range = Finish(builder, ConvertRangeWithValues(&op, builder));
+    assert(g_coerceCalls == 1);
+    assert(range->values() && range->values()->size() == 1);
+    const protocol::NumGrid* nums = range->values()->Get(0)->val_as_NumGrid();
+    assert(nums && nums->rows() == 2 && nums->cols() == 3);
+    std::cout << "TestSRef passed" << std::endl;
+}
+
+void TestUncalcedDropsValues() {
+    XLMREF12* mref = NewXLMREF12(2);
+    mref->count = 2;
+    mref->reftbl[0] = {0, 0, 0, 0};
+    mref->reftbl[1] = {7, 8, 0, 0};
+    XLOPER12 op = RefOn42(mref);
+
+    g_uncalcedRow = 7;
+    g_coerceCalls = 0;
+    flatbuffers::FlatBufferBuilder builder;
+    int ret = xlretSuccess;
+    const protocol::Range* range = Finish(builder, ConvertRangeWithValues(&op, builder, "", &ret));
+    g_uncalcedRow = -1;
+    assert(ret == xlretUncalced && g_coerceCalls == 2);
+    assert(range->values() == nullptr);                  // all or nothing
+    assert(range->refs() && range->refs()->size() == 2); // the rects still go
+
+    FreeRef(op);
+    std::cout << "TestUncalcedDropsValues passed" << std::endl;
+}
+
+void TestConvertRangeHasNoValues() {
+    XLOPER12 op{};
+    op.xltype = xltypeSRef;
+    op.val.sref.count = 1;
+    op.val.sref.ref = {1, 1, 1, 1};
+    g_coerceCalls = 0;
+    flatbuffers::FlatBufferBuilder builder;
+    const protocol::Range* range = Finish(builder, ConvertRange(&op, builder));
+    assert(range->values() == nullptr && g_coerceCalls == 0);
+
+    // Non-references carry neither rects nor values.
+    XLOPER12 num{};
+    num.xltype = xltypeNum;
+    flatbuffers::FlatBufferBuilder b2;
+    int ret = -1;
+    range = Finish(b2, ConvertRangeWithValues(&num, b2, "", &ret));
+    assert(ret == xlretSuccess && range->values() == nullptr && range->refs() == nullptr);
+    std::cout << "TestConvertRangeHasNoValues passed" << std::endl;
+}
+
+int main() {
+    SetExcel12EntryPt(MockExcel12);
+    TestMultiAreaRef();
+    TestSRef();
+    TestUncalcedDropsValues();
+    TestConvertRangeHasNoValues();
+    std::cout << "All range values tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Rect coalescing (CoalesceRefs / SetRectCoalescing in
+// include/types/converters.h): adjacent strips and overlapping aligned rects
+// merge, contained rects drop, the result is row-major, the covered cells never
+// change, and ConvertRange / RangeToXLOPER12 only coalesce when enabled.
+
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+#include "types/mem.h"
+
+static XLREF12 R(int r0, int r1, int c0, int c1) {
+    XLREF12 r;
+    r.rwFirst = r0;
+    r.rwLast = r1;
+    r.colFirst = c0;
+    r.colLast = c1;
+    return r;
+}
+
+static bool Same(const XLREF12& a, const XLREF12& b) {
+    return a.rwFirst == b.rwFirst && a.rwLast == b.rwLast && a.colFirst == b.colFirst && a.colLast == b.colLast;
+}
+
+static std::set<std::pair<int, int>> Cells(const std::vector<XLREF12>& refs) {
+    std::set<std::pair<int, int>> cells;
+    for (const XLREF12& r : refs) {
+        for (int i = r.rwFirst; i <= r.rwLast; ++i) {
+            for (int j = r.colFirst; j <= r.colLast; ++j) cells.insert({i, j});
+        }
+    }
+    return cells;
+}
+
+static std::vector<XLREF12> Coalesce(std::vector<XLREF12> refs) {
+    refs.resize(CoalesceRefs(refs.data(), refs.size()));
+    return refs;
+}
+
+void TestStrips() {
+    // Twenty single-row strips of A:C, shuffled, become one block.
+    std::vector<XLREF12> refs;
+    for (int i = 19; i >= 0; --i) refs.push_back(R(i, i, 0, 2));
+    std::vector<XLREF12> out = Coalesce(refs);
+    assert(out.size() == 1 && Same(out[0], R(0, 19, 0, 2)));
+
+    // A 3 x 3 block of single cells merges both ways.
+    refs.clear();
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) refs.push_back(R(i, i, j, j));
+    }
+    out = Coalesce(refs);
+    assert(out.size() == 1 && Same(out[0], R(0, 2, 0, 2)));
+    std::cout << "TestStrips passed" << std::endl;
+}
+
+void TestOverlapAndContainment() {
+    std::vector<XLREF12> out = Coalesce({R(0, 5, 0, 0), R(3, 9, 0, 0)}); // overlapping, same column
+    assert(out.size() == 1 && Same(out[0], R(0, 9, 0, 0)));
+
+    out = Coalesce({R(2, 3, 2, 3), R(0, 9, 0, 9), R(2, 3, 2, 3)}); // contained and duplicate
+    assert(out.size() == 1 && Same(out[0], R(0, 9, 0, 9)));
+
+    // Overlapping but misaligned: the union is not a rectangle, both stay,
+    // sorted row-major.
+    out = Coalesce({R(2, 4, 2, 4), R(0, 3, 0, 3)});
+    assert(out.size() == 2 && Same(out[0], R(0, 3, 0, 3)) && Same(out[1], R(2, 4, 2, 4)));
+
+    // Separated by a gap: untouched.
+    out = Coalesce({R(0, 0, 0, 0), R(0, 0, 2, 2)});
+    assert(out.size() == 2);
+
+    // Last row/column of the sheet: no overflow on the adjacency test.
+    out = Coalesce({R(0, 1048575, 16383, 16383), R(0, 1048575, 16382, 16382)});
+    assert(out.size() == 1 && Same(out[0], R(0, 1048575, 16382, 16383)));
+
+    // A malformed rect leaves the list as it was.
+    std::vector<XLREF12> bad = {R(5, 5, 0, 0), R(4, 4, 0, 0), R(3, 1, 0, 0)};
+    assert(CoalesceRefs(bad.data(), bad.size()) == 3 && Same(bad[0], R(5, 5, 0, 0)));
+    std::cout << "TestOverlapAndContainment passed" << std::endl;
+}
+
+void TestRandomPreservesCells() {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> pos(0, 11), len(0, 3), count(1, 24);
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<XLREF12> refs;
+        const int n = count(rng);
+        for (int k = 0; k < n; ++k) {
+            const int r0 = pos(rng), c0 = pos(rng);
+            refs.push_back(R(r0, r0 + len(rng), c0, c0 + len(rng)));
+        }
+        const std::vector<XLREF12> out = Coalesce(refs);
+        assert(!out.empty() && out.size() <= refs.size());
+        assert(Cells(out) == Cells(refs));
+        for (size_t i = 1; i < out.size(); ++i) {
+            const XLREF12& a = out[i - 1];
+            const XLREF12& b = out[i];
+            assert(a.rwFirst < b.rwFirst || (a.rwFirst == b.rwFirst && a.colFirst <= b.colFirst));
+        }
+        // Fixpoint: nothing left that an aligned merge would take.
+        for (size_t i = 0; i < out.size(); ++i) {
+            for (size_t j = 0; j < out.size(); ++j) {
+                if (i == j) continue;
+                const XLREF12& a = out[i];
+                const XLREF12& b = out[j];
+                if (a.rwFirst == b.rwFirst && a.rwLast == b.rwLast) assert(b.colFirst > a.colLast + 1 || a.colFirst > b.colLast + 1);
+                if (a.colFirst == b.colFirst && a.colLast == b.colLast) assert(b.rwFirst > a.rwLast + 1 || a.rwFirst > b.rwLast + 1);
+            }
+        }
+    }
+    std::cout << "TestRandomPreservesCells passed" << std::endl;
+}
+
+void TestConvertersOptIn() {
+    XLMREF12* mref = NewXLMREF12(4);
+    mref->count = 4;
+    mref->reftbl[0] = R(3, 3, 0, 1);
+    mref->reftbl[1] = R(1, 1, 0, 1);
+    mref->reftbl[2] = R(2, 2, 0, 1);
+    mref->reftbl[3] = R(8, 8, 4, 4);
+    XLOPER12 op{};
+    op.xltype = xltypeRef | xlbitDLLFree;
+    op.val.mref.lpmref = mref;
+
+    assert(!RectCoalescingEnabled());
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertRange(&op, builder));
+    assert(flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer())->refs()->size() == 4);
+
+    SetRectCoalescing(true);
+    builder.Clear();
+    builder.Finish(ConvertRange(&op, builder));
+    const protocol::Range* range = flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer());
+    assert(range->refs()->size() == 2);
+    assert(range->refs()->Get(0)->row_first() == 1 && range->refs()->Get(0)->row_last() == 3);
+    assert(range->refs()->Get(1)->row_first() == 8 && range->refs()->Get(1)->col_first() == 4);
+
+    // RangeToXLOPER12 coalesces the incoming rects before sizing the XLMREF12.
+    flatbuffers::FlatBufferBuilder rb;
+    std::vector<protocol::Rect> rects = {protocol::Rect(0, 0, 5, 5), protocol::Rect(0, 0, 6, 9), protocol::Rect(0, 0, 4, 4)};
+    rb.Finish(protocol::CreateRange(rb, 0, rb.CreateVectorOfStructs(rects)));
+    LPXLOPER12 ref = RangeToXLOPER12(flatbuffers::GetRoot<protocol::Range>(rb.GetBufferPointer()));
+    assert(ref->val.mref.lpmref->count == 1 && Same(ref->val.mref.lpmref->reftbl[0], R(0, 0, 4, 9)));
+    xlAutoFree12(ref);
+
+    SetRectCoalescing(false);
+    ref = RangeToXLOPER12(flatbuffers::GetRoot<protocol::Range>(rb.GetBufferPointer()));
+    assert(ref->val.mref.lpmref->count == 3 && Same(ref->val.mref.lpmref->reftbl[0], R(0, 0, 5, 5)));
+    xlAutoFree12(ref);
+
+    FreeDllOwnedContents(&op);
+    std::cout << "TestConvertersOptIn passed" << std::endl;
+}
+
+int main() {
+    TestStrips();
+    TestOverlapAndContainment();
+    TestRandomPreservesCells();
+    TestConvertersOptIn();
+    std::cout << "All rect coalescing tests passed" << std::endl;
+    return 0;
+}
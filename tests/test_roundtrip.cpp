@@ -485,8 +485,8 @@ static void TestNumGrid_2x2() {
         RT_CHECK(BitEqualDouble(out->array[2], 3.0));
         RT_CHECK(BitEqualDouble(out->array[3], 4.0));
     }
-    // FP12 is allocated from a per-thread ring buffer (see mem.cpp's
-    // NewFP12 / fpRingBuffers); no explicit free.
+    // FP12 comes from the per-thread FP12 arena (see mem.cpp's NewFP12);
+    // no explicit free.
 }
 
 static void TestNumGrid_WithSpecials() {
@@ -513,6 +513,75 @@ static void TestNumGrid_WithSpecials() {
     }
 }
 
+// Zero-copy `fp12` layout: NumGridAsFP12 points into the message, the
+// copying readers agree with it, and malformed images are refused.
+static void TestNumGrid_FP12Layout() {
+    const double values[6] = {1.5, -0.0, 3.25, std::numeric_limits<double>::infinity(), 5.0, 6.0};
+
+    flatbuffers::FlatBufferBuilder builder;
+    auto ng = CreateNumGridFP12(builder, 2, 3, values);
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(), builder.GetSize());
+    RT_CHECK(verifier.VerifyBuffer<protocol::Any>(nullptr));
+
+    const auto* any = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    const auto* grid = any->val_as_NumGrid();
+    RT_CHECK(grid->data() == nullptr);
+
+    const FP12* view = NumGridAsFP12(grid);
+    RT_CHECK(view != nullptr);
+    if (view) {
+        RT_CHECK(reinterpret_cast<const uint8_t*>(view) == grid->fp12()->data()); // no copy
+        RT_CHECK_EQ(view->rows, 2);
+        RT_CHECK_EQ(view->columns, 3);
+        for (int i = 0; i < 6; ++i) RT_CHECK(BitEqualDouble(view->array[i], values[i]));
+    }
+
+    FP12* copy = NumGridToFP12(grid);
+    RT_CHECK(copy != nullptr && copy->rows == 2 && copy->columns == 3);
+    if (copy) {
+        for (int i = 0; i < 6; ++i) RT_CHECK(BitEqualDouble(copy->array[i], values[i]));
+    }
+
+    LPXLOPER12 multi = AnyToXLOPER12(any);
+    RT_CHECK_EQ(CoreType(*multi), static_cast<DWORD>(xltypeMulti));
+    RT_CHECK_EQ(multi->val.array.rows, 2);
+    RT_CHECK(BitEqualDouble(multi->val.array.lparray[1].val.num, -0.0));
+    xlAutoFree12(multi);
+
+    // A copy of the message at an address that is 4 mod 8 cannot be viewed
+    // in place, but still converts by copying.
+    std::vector<uint8_t> shifted(builder.GetSize() + 12);
+    uint8_t* base = shifted.data() + (8 - reinterpret_cast<uintptr_t>(shifted.data()) % 8) % 8 + 4;
+    std::memcpy(base, builder.GetBufferPointer(), builder.GetSize());
+    const auto* moved = flatbuffers::GetRoot<protocol::Any>(base)->val_as_NumGrid();
+    RT_CHECK(NumGridAsFP12(moved) == nullptr);
+    FP12* fromMoved = NumGridToFP12(moved);
+    RT_CHECK(fromMoved != nullptr && fromMoved->rows == 2 && BitEqualDouble(fromMoved->array[5], 6.0));
+
+    // Header disagreeing with the table, and a short image: refused everywhere.
+    std::vector<uint8_t> image(8 + 6 * sizeof(double), 0);
+    flatbuffers::WriteScalar<int32_t>(image.data(), 3);
+    flatbuffers::WriteScalar<int32_t>(image.data() + 4, 2);
+    flatbuffers::FlatBufferBuilder bad;
+    auto badGrid = protocol::CreateNumGridDirect(bad, 2, 3, nullptr, &image);
+    bad.Finish(protocol::CreateAny(bad, protocol::AnyValue::NumGrid, badGrid.Union()));
+    const auto* badAny = flatbuffers::GetRoot<protocol::Any>(bad.GetBufferPointer());
+    RT_CHECK(NumGridAsFP12(badAny->val_as_NumGrid()) == nullptr);
+    FP12* badCopy = NumGridToFP12(badAny->val_as_NumGrid());
+    RT_CHECK(badCopy != nullptr && badCopy->rows == 0);
+    LPXLOPER12 badMulti = AnyToXLOPER12(badAny);
+    RT_CHECK_EQ(CoreType(*badMulti), static_cast<DWORD>(xltypeErr));
+    xlAutoFree12(badMulti);
+
+    image.resize(image.size() - 8);
+    flatbuffers::WriteScalar<int32_t>(image.data(), 2);
+    flatbuffers::WriteScalar<int32_t>(image.data() + 4, 3);
+    flatbuffers::FlatBufferBuilder shortImage;
+    shortImage.Finish(protocol::CreateNumGridDirect(shortImage, 2, 3, nullptr, &image));
+    RT_CHECK(NumGridAsFP12(flatbuffers::GetRoot<protocol::NumGrid>(shortImage.GetBufferPointer())) == nullptr);
+}
+
 // ----------------------------------------------------------------------------
 // Range round-trips.
 
@@ -989,6 +1058,7 @@ int main() {
     // NumGrid
     RT_RUN(TestNumGrid_2x2);
     RT_RUN(TestNumGrid_WithSpecials);
+    RT_RUN(TestNumGrid_FP12Layout);
 
     // Range
     RT_RUN(TestRange_Sref_SingleRect);
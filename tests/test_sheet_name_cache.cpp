@@ -0,0 +1,196 @@
+// Sheet-name cache behind ConvertRange (SetSheetNameCacheEnabled in
+// include/types/converters.h), against a mock Excel12: off by default, so a
+// renamed sheet is never served stale; once enabled, names are asked of
+// Excel once per idSheet, xltypeSRef still learns its sheet from xlSheetId,
+// failures are not cached, invalidation and disabling force a fresh lookup,
+// and one builder stores each name once.
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/converters.h"
+#include "types/mem.h"
+
+typedef int (PASCAL *EXCEL12PROC) (int xlfn, int coper, LPXLOPER12 *rgpxloper12, LPXLOPER12 xloper12Res);
+extern "C" void pascal SetExcel12EntryPt(EXCEL12PROC pexcel12New);
+
+static const IDSHEET kActiveSheet = 7;
+static int g_sheetIdCalls = 0;
+static int g_sheetNmCalls = 0;
+static bool g_failSheetNm = false;
+static std::string g_suffix;
+
+// Pascal strings handed back as Excel-owned results (the mock xlFree keeps
+// them).
+static std::vector<std::vector<XCHAR>> g_names;
+
+int PASCAL MockExcel12(int xlfn, int coper, LPXLOPER12 *rgpxloper12, LPXLOPER12 xloper12Res) {
+    if (xlfn == xlSheetId) {
+        ++g_sheetIdCalls;
+        xloper12Res->xltype = xltypeRef;
+        xloper12Res->val.mref.lpmref = nullptr;
+        xloper12Res->val.mref.idSheet = kActiveSheet;
+        return xlretSuccess;
+    }
+    if (xlfn == xlSheetNm) {
+        ++g_sheetNmCalls;
+        if (g_failSheetNm || coper != 1) return xlretFailed;
+        const std::string name = "[Book1]Sheet" + std::to_string((unsigned long long)rgpxloper12[0]->val.mref.idSheet) + g_suffix;
+        std::vector<XCHAR> body(1, (XCHAR)name.size());
+        body.insert(body.end(), name.begin(), name.end());
+        g_names.push_back(body);
+        xloper12Res->xltype = xltypeStr;
+        xloper12Res->val.str = g_names.back().data();
+        return xlretSuccess;
+    }
+    return xlretSuccess; // xlFree
+}
+
+static XLMREF12 g_mref = {1, {{0, 1, 0, 1}}};
+
+static XLOPER12 Ref(IDSHEET id) {
+    XLOPER12 op{};
+    op.xltype = xltypeRef;
+    op.val.mref.lpmref = &g_mref;
+    op.val.mref.idSheet = id;
+    return op;
+}
+
+static XLOPER12 SRef() {
+    XLOPER12 op{};
+    op.xltype = xltypeSRef;
+    op.val.sref.count = 1;
+    return op;
+}
+
+static std::string SheetOf(XLOPER12 op) {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertRange(&op, builder));
+    auto* range = flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer());
+    return range->sheet_name() ? range->sheet_name()->str() : std::string();
+}
+
+static void ResetCounts() {
+    InvalidateSheetNameCache();
+    g_sheetIdCalls = g_sheetNmCalls = 0;
+    g_names.clear();
+}
+
+void TestOffByDefault() {
+    ResetCounts();
+    assert(!SheetNameCacheEnabled());
+    assert(SheetOf(Ref(3)) == "[Book1]Sheet3");
+    g_suffix = " (renamed)";
+    assert(SheetOf(Ref(3)) == "[Book1]Sheet3 (renamed)"); // no invalidation needed
+    g_suffix.clear();
+    assert(g_sheetNmCalls == 2 && GetSheetNameCacheStats().entries == 0);
+    std::cout << "TestOffByDefault passed" << std::endl;
+}
+
+void TestRefHits() {
+    ResetCounts();
+    const SheetNameCacheStats before = GetSheetNameCacheStats();
+    for (int i = 0; i < 5; ++i) {
+        assert(SheetOf(Ref(3)) == "[Book1]Sheet3");
+        assert(SheetOf(Ref(4)) == "[Book1]Sheet4");
+    }
+    assert(g_sheetNmCalls == 2 && g_sheetIdCalls == 0);
+    SheetNameCacheStats s = GetSheetNameCacheStats();
+    assert(s.entries == 2);
+    assert(s.misses - before.misses == 2 && s.hits - before.hits == 8);
+    std::cout << "TestRefHits passed" << std::endl;
+}
+
+void TestSRefStillAsksForSheetId() {
+    ResetCounts();
+    for (int i = 0; i < 3; ++i) assert(SheetOf(SRef()) == "[Book1]Sheet7");
+    assert(g_sheetIdCalls == 3 && g_sheetNmCalls == 1);
+    // The active sheet's name is shared with xltypeRef inputs on it.
+    assert(SheetOf(Ref(kActiveSheet)) == "[Book1]Sheet7" && g_sheetNmCalls == 1);
+    std::cout << "TestSRefStillAsksForSheetId passed" << std::endl;
+}
+
+void TestFailuresNotCached() {
+    ResetCounts();
+    g_failSheetNm = true;
+    assert(SheetOf(Ref(5)).empty());
+    g_failSheetNm = false;
+    assert(SheetOf(Ref(5)) == "[Book1]Sheet5");
+    assert(g_sheetNmCalls == 2 && GetSheetNameCacheStats().entries == 1);
+    std::cout << "TestFailuresNotCached passed" << std::endl;
+}
+
+void TestInvalidateAndDisable() {
+    ResetCounts();
+    assert(SheetOf(Ref(3)) == "[Book1]Sheet3");
+    g_suffix = " (renamed)";
+    assert(SheetOf(Ref(3)) == "[Book1]Sheet3"); // stale until invalidated
+
+    const uint64_t epoch = GetSheetNameCacheStats().epoch;
+    InvalidateSheetNameCache();
+    SheetNameCacheStats s = GetSheetNameCacheStats();
+    assert(s.epoch == epoch + 1 && s.entries == 0);
+    assert(SheetOf(Ref(3)) == "[Book1]Sheet3 (renamed)");
+    assert(g_sheetNmCalls == 2);
+
+    SetSheetNameCacheEnabled(false);
+    assert(GetSheetNameCacheStats().entries == 0);
+    SheetOf(Ref(3));
+    SheetOf(Ref(3));
+    assert(g_sheetNmCalls == 4 && GetSheetNameCacheStats().entries == 0);
+    SetSheetNameCacheEnabled(true);
+    g_suffix.clear();
+    std::cout << "TestInvalidateAndDisable passed" << std::endl;
+}
+
+void TestSharedStringInBuilder() {
+    ResetCounts();
+    XLOPER12 a = Ref(3), b = Ref(3), c = Ref(4);
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<protocol::Range>> ranges = {
+        ConvertRange(&a, builder), ConvertRange(&b, builder), ConvertRange(&c, builder)};
+    builder.Finish(builder.CreateVector(ranges));
+    auto* vec = flatbuffers::GetRoot<flatbuffers::Vector<flatbuffers::Offset<protocol::Range>>>(builder.GetBufferPointer());
+    assert(vec->Get(0)->sheet_name()->str() == "[Book1]Sheet3");
+    assert(vec->Get(0)->sheet_name() == vec->Get(1)->sheet_name()); // one copy
+    assert(vec->Get(2)->sheet_name()->str() == "[Book1]Sheet4");
+    std::cout << "TestSharedStringInBuilder passed" << std::endl;
+}
+
+void TestConcurrentLookups() {
+    ResetCounts();
+    // Prime on this thread: the mock is not thread-safe, hits never call it.
+    for (IDSHEET id = 1; id <= 4; ++id) SheetOf(Ref(id));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 2000; ++i) {
+                const IDSHEET id = 1 + (IDSHEET)((i + t) % 4);
+                assert(SheetOf(Ref(id)) == "[Book1]Sheet" + std::to_string((unsigned long long)id));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    assert(g_sheetNmCalls == 4);
+    std::cout << "TestConcurrentLookups passed" << std::endl;
+}
+
+int main() {
+    SetExcel12EntryPt(MockExcel12);
+    TestOffByDefault();
+    SetSheetNameCacheEnabled(true);
+    TestRefHits();
+    TestSRefStillAsksForSheetId();
+    TestFailuresNotCached();
+    TestInvalidateAndDisable();
+    TestSharedStringInBuilder();
+    TestConcurrentLookups();
+    std::cout << "All sheet name cache tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,213 @@
+// Opt-in string interning for ConvertGrid / ConvertMultiToAny
+// (include/types/StringInterner.h): repeated cells decode identically to the
+// plain conversion, the payload shrinks, and the counters / table limits /
+// builder-reset safety net behave as documented, and a pooled builder's
+// lease-bound interner never serves offsets from a previous lease.
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/BuilderPool.h"
+#include "types/converters.h"
+#include "types/utility.h"
+
+extern "C" void __stdcall xlAutoFree12(LPXLOPER12 p);
+
+// Owns the Pascal buffers behind an xltypeMulti of string cells.
+struct StrGrid {
+    std::vector<std::vector<XCHAR>> bufs;
+    std::vector<XLOPER12> cells;
+    XLOPER12 multi;
+
+    StrGrid(const std::vector<std::wstring>& values, int rows, int cols) {
+        bufs.reserve(values.size());
+        cells.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            const std::wstring& w = values[i];
+            std::vector<XCHAR> b(w.size() + 2, 0);
+            b[0] = (XCHAR)w.size();
+            for (size_t k = 0; k < w.size(); ++k) b[k + 1] = (XCHAR)w[k];
+            bufs.push_back(std::move(b));
+            cells[i].xltype = xltypeStr;
+            cells[i].val.str = bufs.back().data();
+        }
+        multi.xltype = xltypeMulti;
+        multi.val.array.rows = rows;
+        multi.val.array.columns = cols;
+        multi.val.array.lparray = cells.data();
+    }
+};
+
+static std::vector<std::string> GridStrings(const protocol::Grid* g) {
+    std::vector<std::string> out;
+    for (flatbuffers::uoffset_t i = 0; i < g->data()->size(); ++i) {
+        auto s = g->data()->Get(i);
+        assert(s->val_type() == protocol::ScalarValue::Str);
+        out.push_back(s->val_as_Str()->val()->str());
+    }
+    return out;
+}
+
+void TestGridDedupMatchesPlain() {
+    const wchar_t* codes[] = {L"USD", L"EUR", L"JPY", L"GBP", L"€-zone"};
+    std::vector<std::wstring> values;
+    for (int i = 0; i < 1000; ++i) values.push_back(codes[i % 5]);
+    StrGrid grid(values, 500, 2);
+
+    flatbuffers::FlatBufferBuilder plain;
+    plain.Finish(ConvertGrid(&grid.multi, plain));
+
+    flatbuffers::FlatBufferBuilder dedup;
+    StringInterner interner;
+    dedup.Finish(ConvertGrid(&grid.multi, dedup, &interner));
+
+    auto* a = flatbuffers::GetRoot<protocol::Grid>(plain.GetBufferPointer());
+    auto* b = flatbuffers::GetRoot<protocol::Grid>(dedup.GetBufferPointer());
+    assert(a->rows() == b->rows() && a->cols() == b->cols());
+    assert(GridStrings(a) == GridStrings(b));
+
+    assert(interner.Misses() == 5);
+    assert(interner.Hits() == 995);
+    assert(interner.Size() == 5);
+    assert(dedup.GetSize() * 3 < plain.GetSize());
+
+    // And back to Excel: same strings out.
+    LPXLOPER12 res = GridToXLOPER12(b);
+    assert(res->val.array.rows == 500);
+    assert(ConvertExcelString(res->val.array.lparray[4].val.str) == "\xE2\x82\xAC-zone");
+    xlAutoFree12(res);
+    std::cout << "TestGridDedupMatchesPlain passed" << std::endl;
+}
+
+void TestMultiToAnyDedup() {
+    std::vector<std::wstring> values = {L"A", L"B", L"A", L"B", L"", L""};
+    StrGrid grid(values, 3, 2);
+
+    flatbuffers::FlatBufferBuilder builder;
+    StringInterner interner;
+    builder.Finish(ConvertMultiToAny(grid.multi, builder, &interner));
+
+    // Homogeneous string columns select ColumnGrid; its Str columns go
+    // through the same interner.
+    auto* any = flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer());
+    assert(any->val_type() == protocol::AnyValue::ColumnGrid);
+    const auto* columns = any->val_as_ColumnGrid()->columns();
+    assert(columns->size() == 2);
+    assert(columns->Get(0)->strs()->Get(1)->str() == "A");
+    assert(columns->Get(1)->strs()->Get(1)->str() == "B");
+    assert(columns->Get(1)->strs()->Get(2)->str() == "");
+    assert(interner.Misses() == 3);
+    assert(interner.Hits() == 3);
+    std::cout << "TestMultiToAnyDedup passed" << std::endl;
+}
+
+void TestInternStringThenScalar() {
+    std::vector<XCHAR> usd = {3, L'U', L'S', L'D', 0};
+    flatbuffers::FlatBufferBuilder builder;
+    StringInterner interner;
+    auto s1 = interner.Intern(builder, usd.data());
+    auto s2 = interner.Intern(builder, usd.data());
+    assert(s1.o == s2.o);
+    auto c1 = interner.InternScalar(builder, usd.data()); // reuses the string
+    auto c2 = interner.InternScalar(builder, usd.data()); // reuses the table
+    assert(c1.o == c2.o);
+    assert(interner.Misses() == 1);
+    assert(interner.Hits() == 3);
+    std::cout << "TestInternStringThenScalar passed" << std::endl;
+}
+
+void TestLimits() {
+    // Long strings are serialized but never cached.
+    std::vector<std::wstring> longVals(4, std::wstring(StringInterner::kMaxInternLen + 1, L'x'));
+    StrGrid longGrid(longVals, 4, 1);
+    flatbuffers::FlatBufferBuilder b1;
+    StringInterner i1;
+    b1.Finish(ConvertGrid(&longGrid.multi, b1, &i1));
+    assert(i1.Size() == 0 && i1.Hits() == 0 && i1.Misses() == 4);
+
+    // A full table stops caching new strings; cached ones keep hitting.
+    StringInterner i2(16); // 12 entries at the 3/4 load limit
+    assert(i2.TableSize() == 16);
+    std::vector<std::wstring> vals;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < 20; ++i) vals.push_back(std::wstring(1, (wchar_t)(L'a' + i)));
+    }
+    StrGrid grid(vals, 40, 1);
+    flatbuffers::FlatBufferBuilder b2;
+    b2.Finish(ConvertGrid(&grid.multi, b2, &i2));
+    assert(i2.Size() == 12);
+    assert(i2.Hits() == 12);
+    assert(i2.Misses() == 28);
+    auto* g = flatbuffers::GetRoot<protocol::Grid>(b2.GetBufferPointer());
+    assert(GridStrings(g)[39] == "t");
+    std::cout << "TestLimits passed" << std::endl;
+}
+
+void TestBuilderReuseResets() {
+    std::vector<std::wstring> values = {L"X", L"X"};
+    StrGrid grid(values, 2, 1);
+    StringInterner interner;
+
+    flatbuffers::FlatBufferBuilder builder;
+    builder.Finish(ConvertGrid(&grid.multi, builder, &interner));
+    assert(interner.Size() == 1);
+
+    // Cleared builder: stale offsets must not be reused.
+    builder.Clear();
+    builder.Finish(ConvertGrid(&grid.multi, builder, &interner));
+    assert(interner.Misses() == 2);
+    auto* g = flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer());
+    assert(GridStrings(g) == std::vector<std::string>({"X", "X"}));
+
+    // Different builder: likewise.
+    flatbuffers::FlatBufferBuilder other;
+    other.Finish(ConvertGrid(&grid.multi, other, &interner));
+    assert(interner.Misses() == 3);
+
+    interner.Reset();
+    assert(interner.Size() == 0);
+    std::cout << "TestBuilderReuseResets passed" << std::endl;
+}
+
+void TestPooledBuilderReuse() {
+    std::vector<std::wstring> values = {L"CCY", L"CCY", L"FLAG", L"FLAG"};
+    StrGrid grid(values, 4, 1);
+    BuilderPool pool;
+
+    const flatbuffers::FlatBufferBuilder* first = nullptr;
+    {
+        auto lease = pool.Acquire();
+        lease->Finish(ConvertGrid(&grid.multi, *lease, &lease.Interner()));
+        assert(lease.Interner().Size() == 2);
+        first = lease.get();
+    }
+
+    // Same builder, cleared, then regrown past its previous size before the
+    // first Intern: the builder-size check alone would keep the stale offsets.
+    auto lease = pool.Acquire();
+    assert(lease.get() == first);
+    assert(lease.Interner().Size() == 0);
+    std::vector<uint8_t> filler(4096, 0xAB);
+    lease->CreateVector(filler);
+    lease->Finish(ConvertGrid(&grid.multi, *lease, &lease.Interner()));
+    assert(lease.Interner().Misses() == 4);
+    auto* g = flatbuffers::GetRoot<protocol::Grid>(lease->GetBufferPointer());
+    assert(GridStrings(g) == std::vector<std::string>({"CCY", "CCY", "FLAG", "FLAG"}));
+    std::cout << "TestPooledBuilderReuse passed" << std::endl;
+}
+
+int main() {
+    TestGridDedupMatchesPlain();
+    TestMultiToAnyDedup();
+    TestInternStringThenScalar();
+    TestLimits();
+    TestBuilderReuseResets();
+    TestPooledBuilderReuse();
+    std::cout << "All string interner tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Pascal string slab (NewExcelStringBuffer in include/types/mem.h): short
+// buffers come from size-class pages, are recognized and recycled by
+// FreeExcelStringBuffer / xlAutoFree12 on any thread, and larger or foreign
+// buffers keep going through new[] / delete[]. Single-rect XLMREF12s share
+// the smallest class.
+
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/mem.h"
+#include "types/utility.h"
+#include "types/converters.h"
+#include "types/ScopedXLOPER12.h"
+
+void TestSizeClasses() {
+    const size_t before = GetExcelStringSlabStats().pages;
+
+    // Every class hands out distinct, writable blocks of at least `units`.
+    const size_t sizes[] = {1, 2, 16, 17, 32, 33, 64, 100, 128, 200, 256};
+    std::vector<XCHAR*> bufs;
+    for (size_t units : sizes) {
+        XCHAR* p = NewExcelStringBuffer(units);
+        for (size_t i = 0; i < units; ++i) p[i] = (XCHAR)(units + i);
+        bufs.push_back(p);
+    }
+    for (size_t k = 0; k < bufs.size(); ++k) {
+        for (size_t i = 0; i < sizes[k]; ++i) assert(bufs[k][i] == (XCHAR)(sizes[k] + i));
+    }
+    ExcelStringSlabStats s = GetExcelStringSlabStats();
+    assert(s.pages >= before && s.pages <= before + 5);
+    assert(s.reservedBytes == s.pages * 64 * 1024);
+    for (XCHAR* p : bufs) FreeExcelStringBuffer(p);
+
+    // Freed blocks are reused LIFO by the same thread.
+    XCHAR* a = NewExcelStringBuffer(10);
+    FreeExcelStringBuffer(a);
+    assert(NewExcelStringBuffer(12) == a);
+    FreeExcelStringBuffer(a);
+
+    // Above 256 units, and null, go through the heap / are ignored.
+    XCHAR* big = NewExcelStringBuffer(257);
+    big[256] = 1;
+    FreeExcelStringBuffer(big);
+    FreeExcelStringBuffer(nullptr);
+
+    // A foreign new[] buffer is not mistaken for a slab block.
+    XCHAR* foreign = new XCHAR[8];
+    FreeExcelStringBuffer(foreign);
+    std::cout << "TestSizeClasses passed" << std::endl;
+}
+
+void TestProducers() {
+    LPXLOPER12 s = NewExcelString(L"short");
+    assert(s->val.str[0] == 5 && std::memcmp(s->val.str + 1, L"short", 5 * sizeof(XCHAR)) == 0);
+    xlAutoFree12(s);
+
+    XCHAR* u = Utf8ToExcelStringBuffer("H\xC3\xA9llo");
+    assert(u[0] == 5 && u[2] == 0x00E9 && u[6] == 0);
+    FreeExcelStringBuffer(u);
+    XCHAR* empty = Utf8ToExcelStringBuffer(nullptr);
+    assert(empty[0] == 0 && empty[1] == 0);
+    FreeExcelStringBuffer(empty);
+
+    // ScopedXLOPER12 owns a slab buffer and survives moves.
+    ScopedXLOPER12 a(L"scoped");
+    ScopedXLOPER12 b(std::move(a));
+    assert(b.get()->val.str[0] == 6 && b.get()->val.str[1] == L's');
+    ScopedXLOPER12 c(L"other");
+    c = std::move(b);
+    assert(c.get()->val.str[0] == 6);
+    ScopedXLOPER12 copy(static_cast<const XLOPER12*>(c));
+    assert(copy.get()->val.str != c.get()->val.str && copy.get()->val.str[0] == 6);
+
+    // Grid string cells are slab-backed and released by xlAutoFree12.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> cells;
+    for (int i = 0; i < 300; ++i) {
+        std::string text = "cell" + std::to_string(i) + std::string(i % 70, 'x');
+        cells.push_back(protocol::CreateScalar(builder, protocol::ScalarValue::Str,
+                                               protocol::CreateStr(builder, builder.CreateString(text)).Union()));
+    }
+    builder.Finish(protocol::CreateGrid(builder, 100, 3, builder.CreateVector(cells)));
+    const auto* grid = flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer());
+    for (int round = 0; round < 3; ++round) {
+        LPXLOPER12 op = GridToXLOPER12(grid, XlGridAlloc::PerCell);
+        assert(op->val.array.lparray[299].xltype == (xltypeStr | xlbitDLLFree));
+        assert(op->val.array.lparray[299].val.str[0] == 7 + 299 % 70);
+        xlAutoFree12(op);
+    }
+    std::cout << "TestProducers passed" << std::endl;
+}
+
+void TestCrossThread() {
+    // Strings made on workers and freed here (and the reverse) are recycled;
+    // a worker's cached blocks return to the shared lists at thread exit.
+    std::vector<XCHAR*> made;
+    std::thread producer([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            XCHAR* p = NewExcelStringBuffer(20);
+            p[0] = (XCHAR)i;
+            made.push_back(p);
+        }
+    });
+    producer.join();
+    assert(std::set<XCHAR*>(made.begin(), made.end()).size() == made.size());
+    for (XCHAR* p : made) FreeExcelStringBuffer(p);
+
+    std::vector<XCHAR*> more;
+    for (int i = 0; i < 1000; ++i) more.push_back(NewExcelStringBuffer(20));
+    std::thread consumer([&]() {
+        for (XCHAR* p : more) FreeExcelStringBuffer(p);
+    });
+    consumer.join();
+
+    // Reuse keeps the page count flat across many rounds.
+    const size_t pages = GetExcelStringSlabStats().pages;
+    for (int round = 0; round < 20; ++round) {
+        std::thread worker([]() {
+            std::vector<XCHAR*> local;
+            for (int i = 0; i < 1000; ++i) local.push_back(NewExcelStringBuffer(20));
+            for (XCHAR* p : local) FreeExcelStringBuffer(p);
+        });
+        worker.join();
+    }
+    ExcelStringSlabStats s = GetExcelStringSlabStats();
+    assert(s.pages == pages);
+    assert(s.freeBlocks + s.threadCachedBlocks > 0);
+    std::cout << "TestCrossThread passed" << std::endl;
+}
+
+void TestArenaTakesPrecedence() {
+    EnableXlArena(64 * 1024, 1);
+    XCHAR* p = NewExcelStringBuffer(10);
+    assert(GetXlArenaStats().liveResults == 1);
+    FreeExcelStringBuffer(p);
+    assert(GetXlArenaStats().liveResults == 0);
+    DisableXlArena();
+    XlArenaTrim();
+    std::cout << "TestArenaTakesPrecedence passed" << std::endl;
+}
+
+void TestSingleRectRef() {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<protocol::Rect> one = {protocol::Rect(4, 9, 1, 2)};
+    builder.Finish(protocol::CreateRange(builder, 0, builder.CreateVectorOfStructs(one)));
+    const auto* range = flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer());
+
+    // The block a short string just released is the one the XLMREF12 gets
+    // (per-thread LIFO), and it goes back to the slab on free.
+    XCHAR* s = NewExcelStringBuffer(8);
+    FreeExcelStringBuffer(s);
+    LPXLOPER12 ref = RangeToXLOPER12(range);
+    assert(ref->xltype == (xltypeRef | xlbitDLLFree) && ref->val.mref.idSheet == 0);
+    assert((void*)ref->val.mref.lpmref == (void*)s);
+    const XLMREF12* mref = ref->val.mref.lpmref;
+    assert(mref->count == 1 && mref->reftbl[0].rwFirst == 4 && mref->reftbl[0].rwLast == 9);
+    assert(mref->reftbl[0].colFirst == 1 && mref->reftbl[0].colLast == 2);
+    xlAutoFree12(ref);
+    XCHAR* again = NewExcelStringBuffer(8);
+    assert(again == s);
+    FreeExcelStringBuffer(again);
+
+    // Several rects still take an exactly sized heap block.
+    std::vector<protocol::Rect> three = {protocol::Rect(0, 0, 0, 0), protocol::Rect(2, 2, 2, 2), protocol::Rect(4, 4, 4, 4)};
+    builder.Clear();
+    builder.Finish(protocol::CreateRange(builder, 0, builder.CreateVectorOfStructs(three)));
+    ref = RangeToXLOPER12(flatbuffers::GetRoot<protocol::Range>(builder.GetBufferPointer()));
+    assert(ref->val.mref.lpmref->count == 3 && ref->val.mref.lpmref->reftbl[2].colLast == 4);
+    xlAutoFree12(ref);
+    std::cout << "TestSingleRectRef passed" << std::endl;
+}
+
+int main() {
+    TestSizeClasses();
+    TestProducers();
+    TestCrossThread();
+    TestArenaTakesPrecedence();
+    TestSingleRectRef();
+    std::cout << "All string slab tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,301 @@
+// Built-in UTF-16 <-> UTF-8 transcoders (include/types/transcode.h).
+//
+// The reference is WideCharToMultiByte / MultiByteToWideChar(CP_UTF8, 0):
+// every well-formed case is transcoded by both and must be identical, as must
+// lone-surrogate replacement (U+FFFD) on the encode side. Ill-formed UTF-8 is
+// checked against the Unicode Table 3-8 "maximal subpart" expectations
+// directly. Lengths are chosen to straddle the 16-unit SSE2 and 32-unit AVX2
+// block boundaries, with the non-ASCII unit placed at each position of a block.
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/pascalstr.h"
+#include "types/transcode.h"
+#include "types/utility.h"
+
+static int g_failures = 0;
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            std::cerr << "FAIL: " << #cond << " @ " << __FILE__ << ":"         \
+                      << __LINE__ << std::endl;                                \
+            ++g_failures;                                                      \
+        }                                                                      \
+    } while (0)
+
+static std::string Win32Utf8(const std::vector<XCHAR>& src) {
+    if (src.empty()) return std::string();
+    int n = WideCharToMultiByte(CP_UTF8, 0, src.data(), (int)src.size(), NULL, 0, NULL, NULL);
+    std::string out((size_t)n, 0);
+    WideCharToMultiByte(CP_UTF8, 0, src.data(), (int)src.size(), &out[0], n, NULL, NULL);
+    return out;
+}
+
+// Transcodes into a canary-guarded worst-case buffer and compares against the
+// Win32 reference and against Utf8LengthOfUtf16.
+static void check_case(const std::vector<XCHAR>& src) {
+    const char kCanary = (char)0xA5;
+    size_t cap = Utf8MaxBytesForUtf16(src.size());
+    std::vector<char> buf(cap + 2, kCanary);
+    size_t n = Utf16ToUtf8(src.data(), src.size(), buf.data() + 1);
+
+    std::string expected = Win32Utf8(src);
+    CHECK(n == expected.size());
+    CHECK(n <= cap);
+    CHECK(std::memcmp(buf.data() + 1, expected.data(), expected.size()) == 0);
+    CHECK(Utf8LengthOfUtf16(src.data(), src.size()) == expected.size());
+    CHECK(buf.front() == kCanary);
+    CHECK(buf.back() == kCanary || n < cap);
+}
+
+static std::vector<XCHAR> Ascii(size_t len) {
+    std::vector<XCHAR> v(len);
+    for (size_t i = 0; i < len; ++i) v[i] = (XCHAR)(L'A' + (i % 26));
+    return v;
+}
+
+static void TestEmptyAndAscii() {
+    check_case({});
+    for (size_t len = 1; len <= 100; ++len) {
+        check_case(Ascii(len));
+    }
+    check_case(Ascii(32767));
+    std::cout << "TestEmptyAndAscii done" << std::endl;
+}
+
+// One non-ASCII unit at every position of 16/32/33-unit ASCII runs, so the
+// vector fast path has to bail at each lane.
+static void TestNonAsciiAtEveryLane() {
+    const XCHAR kInserts[] = {(XCHAR)0x00E9, (XCHAR)0x07FF, (XCHAR)0x0800, (XCHAR)0x20AC, (XCHAR)0xFFFF,
+                              (XCHAR)0x0080};
+    const size_t kLens[] = {16, 31, 32, 33, 64, 65};
+    for (XCHAR ins : kInserts) {
+        for (size_t len : kLens) {
+            for (size_t pos = 0; pos < len; ++pos) {
+                std::vector<XCHAR> v = Ascii(len);
+                v[pos] = ins;
+                check_case(v);
+            }
+        }
+    }
+    std::cout << "TestNonAsciiAtEveryLane done" << std::endl;
+}
+
+// Surrogate pairs, including pairs split across block boundaries, and lone
+// surrogates (-> U+FFFD) at the start, middle and end.
+static void TestSurrogates() {
+    for (size_t pos = 0; pos + 1 < 40; ++pos) {
+        std::vector<XCHAR> v = Ascii(40);
+        v[pos] = (XCHAR)0xD83D; // U+1F600
+        v[pos + 1] = (XCHAR)0xDE00;
+        check_case(v);
+    }
+    for (size_t pos = 0; pos < 40; ++pos) {
+        std::vector<XCHAR> hi = Ascii(40);
+        hi[pos] = (XCHAR)0xD800; // unpaired high
+        check_case(hi);
+        std::vector<XCHAR> lo = Ascii(40);
+        lo[pos] = (XCHAR)0xDFFF; // unpaired low
+        check_case(lo);
+    }
+    check_case({(XCHAR)0xDC00, (XCHAR)0xD800}); // reversed pair = two lone surrogates
+    check_case({(XCHAR)0xD800, (XCHAR)0xD800, (XCHAR)0xDC00});
+    std::cout << "TestSurrogates done" << std::endl;
+}
+
+// Every BMP code unit on its own, then in a long run, so each 1/2/3-byte
+// encoding branch is exercised against the reference.
+static void TestAllBmpUnits() {
+    std::vector<XCHAR> all;
+    for (uint32_t u = 1; u <= 0xFFFF; ++u) {
+        check_case({(XCHAR)u});
+        all.push_back((XCHAR)u);
+    }
+    check_case(all);
+    std::cout << "TestAllBmpUnits done" << std::endl;
+}
+
+// ConvertExcelString / WideToUtf8 now route through the kernel.
+static void TestCallSites() {
+    std::vector<XCHAR> pstr = {5, L'H', (XCHAR)0x00E9, L'l', L'l', L'o', 0};
+    std::string s = ConvertExcelString(pstr.data());
+    CHECK(s == "H\xC3\xA9llo");
+
+    std::wstring w(1000, L'x');
+    w[500] = (wchar_t)0x20AC;
+    std::string u = WideToUtf8(w);
+    CHECK(u.size() == 1002);
+    CHECK(u.substr(500, 3) == "\xE2\x82\xAC");
+
+    // Results are sized exactly on both sides of the stack-scratch limit:
+    // no 3x worst-case capacity left behind.
+    for (size_t n : {200u, 256u, 257u, 5000u}) {
+        std::vector<XCHAR> p(n + 2, L'a');
+        p[0] = (XCHAR)n;
+        p[n / 2] = (XCHAR)0x20AC;
+        std::string e = ConvertExcelString(p.data());
+        CHECK(e.size() == n + 2);
+        CHECK(e.capacity() < e.size() + e.size() / 2);
+        CHECK(e == WideToUtf8(std::wstring(p.begin() + 1, p.end() - 1)));
+    }
+    std::cout << "TestCallSites done" << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+// UTF-8 -> UTF-16
+// ---------------------------------------------------------------------------
+
+static std::vector<XCHAR> Win32Utf16(const std::string& src) {
+    if (src.empty()) return {};
+    int n = MultiByteToWideChar(CP_UTF8, 0, src.data(), (int)src.size(), NULL, 0);
+    std::vector<XCHAR> out((size_t)n);
+    MultiByteToWideChar(CP_UTF8, 0, src.data(), (int)src.size(), out.data(), n);
+    return out;
+}
+
+static std::vector<XCHAR> Decode(const std::string& src, size_t cap) {
+    std::vector<XCHAR> buf(cap + 2, (XCHAR)0xA5A5);
+    size_t n = Utf8ToUtf16(src.data(), src.size(), buf.data() + 1, cap);
+    CHECK(n <= cap);
+    CHECK(buf.front() == (XCHAR)0xA5A5);
+    CHECK(buf[n + 1] == (XCHAR)0xA5A5); // nothing written past the count
+    return std::vector<XCHAR>(buf.begin() + 1, buf.begin() + 1 + n);
+}
+
+// Well-formed input: identical to MultiByteToWideChar.
+static void check_decode(const std::string& src) {
+    CHECK(Decode(src, src.size()) == Win32Utf16(src));
+}
+
+static std::string AsciiBytes(size_t len) {
+    std::string s(len, 0);
+    for (size_t i = 0; i < len; ++i) s[i] = (char)('a' + (i % 26));
+    return s;
+}
+
+static void TestDecodeAscii() {
+    check_decode("");
+    for (size_t len = 1; len <= 100; ++len) {
+        check_decode(AsciiBytes(len));
+    }
+    check_decode(AsciiBytes(70000));
+    std::cout << "TestDecodeAscii done" << std::endl;
+}
+
+// Each multi-byte form at every byte offset of 16/32/33/64-byte runs.
+static void TestDecodeMultiByteAtEveryLane() {
+    const char* kSeqs[] = {"\xC3\xA9", "\xDF\xBF", "\xE0\xA0\x80", "\xE2\x82\xAC", "\xEF\xBF\xBF",
+                           "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF"};
+    const size_t kLens[] = {16, 32, 33, 64};
+    for (const char* seq : kSeqs) {
+        for (size_t len : kLens) {
+            for (size_t pos = 0; pos < len; ++pos) {
+                std::string s = AsciiBytes(len);
+                s.insert(pos, seq);
+                check_decode(s);
+            }
+        }
+    }
+    std::cout << "TestDecodeMultiByteAtEveryLane done" << std::endl;
+}
+
+// Every BMP scalar value and a sample of supplementary ones, encoded by the
+// UTF-16 -> UTF-8 kernel and decoded back.
+static void TestDecodeRoundTrip() {
+    std::vector<XCHAR> all;
+    for (uint32_t u = 1; u <= 0xFFFF; ++u) {
+        if (u >= 0xD800 && u <= 0xDFFF) continue;
+        all.push_back((XCHAR)u);
+    }
+    for (uint32_t cp = 0x10000; cp <= 0x10FFFF; cp += 0x3FF) {
+        all.push_back((XCHAR)(0xD800 + ((cp - 0x10000) >> 10)));
+        all.push_back((XCHAR)(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+    }
+    std::string utf8(Utf8MaxBytesForUtf16(all.size()), 0);
+    utf8.resize(Utf16ToUtf8(all.data(), all.size(), &utf8[0]));
+    CHECK(Decode(utf8, utf8.size()) == all);
+    check_decode(utf8);
+    std::cout << "TestDecodeRoundTrip done" << std::endl;
+}
+
+// Ill-formed input: one U+FFFD per maximal subpart.
+static void TestDecodeIllFormed() {
+    const XCHAR R = (XCHAR)0xFFFD;
+    // Unicode 15 Table 3-8.
+    CHECK(Decode("\x61\xF1\x80\x80\xE1\x80\xC2\x62\x80\x63\x80\xBF\x64", 13) ==
+          (std::vector<XCHAR>{L'a', R, R, R, L'b', R, L'c', R, R, L'd'}));
+    CHECK(Decode("\xC0\xAF", 2) == (std::vector<XCHAR>{R, R}));           // overlong
+    CHECK(Decode("\xE0\x80\xAF", 3) == (std::vector<XCHAR>{R, R, R}));   // overlong
+    CHECK(Decode("\xED\xA0\x80", 3) == (std::vector<XCHAR>{R, R, R}));   // encoded surrogate
+    CHECK(Decode("\xF4\x90\x80\x80", 4) == (std::vector<XCHAR>{R, R, R, R})); // > U+10FFFF
+    CHECK(Decode("\xF5\xFF", 2) == (std::vector<XCHAR>{R, R}));
+    CHECK(Decode("\xE2\x82", 2) == (std::vector<XCHAR>{R}));              // truncated at end
+    CHECK(Decode("\xF0\x9F\x98", 3) == (std::vector<XCHAR>{R}));
+    // Truncated sequence at the end of an otherwise-ASCII vector block.
+    std::string s = AsciiBytes(31) + "\xE2\x82" + AsciiBytes(40);
+    std::vector<XCHAR> got = Decode(s, s.size());
+    CHECK(got.size() == 72);
+    CHECK(got[31] == R);
+    CHECK(got[32] == L'a');
+    std::cout << "TestDecodeIllFormed done" << std::endl;
+}
+
+// dstCap stops decoding exactly; a supplementary character that does not fit
+// keeps only its high surrogate (code-unit truncation, as the clamp does).
+static void TestDecodeCap() {
+    std::string s = AsciiBytes(100);
+    for (size_t cap = 0; cap <= 100; ++cap) {
+        CHECK(Decode(s, cap).size() == cap);
+    }
+    std::vector<XCHAR> got = Decode("ab\xF0\x9F\x98\x80", 3);
+    CHECK(got == (std::vector<XCHAR>{L'a', L'b', (XCHAR)0xD83D}));
+    got = Decode("ab\xE2\x82\xAC" "cd", 3);
+    CHECK(got == (std::vector<XCHAR>{L'a', L'b', (XCHAR)0x20AC}));
+    std::cout << "TestDecodeCap done" << std::endl;
+}
+
+// Utf8ToExcelString decodes straight into the Pascal buffer.
+static void TestUtf8ToExcelStringInPlace() {
+    XCHAR* out = nullptr;
+    Utf8ToExcelString("H\xC3\xA9llo \xE2\x82\xAC", out);
+    CHECK(out[0] == 7);
+    CHECK(out[2] == (XCHAR)0x00E9);
+    CHECK(out[7] == (XCHAR)0x20AC);
+    CHECK(out[8] == 0);
+    delete[] out;
+
+    // Clamp lands mid-pair: 32766 ASCII + U+1F600 -> 32767 units.
+    std::string big = AsciiBytes(kMaxExcelStringLen - 1) + "\xF0\x9F\x98\x80";
+    Utf8ToExcelString(big.c_str(), out);
+    CHECK((size_t)out[0] == kMaxExcelStringLen);
+    CHECK(out[kMaxExcelStringLen] == (XCHAR)0xD83D);
+    CHECK(out[kMaxExcelStringLen + 1] == 0);
+    delete[] out;
+    std::cout << "TestUtf8ToExcelStringInPlace done" << std::endl;
+}
+
+int main() {
+    TestEmptyAndAscii();
+    TestNonAsciiAtEveryLane();
+    TestSurrogates();
+    TestAllBmpUnits();
+    TestCallSites();
+    TestDecodeAscii();
+    TestDecodeMultiByteAtEveryLane();
+    TestDecodeRoundTrip();
+    TestDecodeIllFormed();
+    TestDecodeCap();
+    TestUtf8ToExcelStringInPlace();
+    if (g_failures) {
+        std::cerr << g_failures << " failure(s)" << std::endl;
+        return 1;
+    }
+    std::cout << "All transcode tests passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,390 @@
+// Per-thread XLOPER12 payload arena (EnableXlArena in include/types/mem.h):
+// results carve their payloads from the arena and are counted until
+// xlAutoFree12, chunks are recycled only once retired AND drained, oversize
+// payloads get their own chunk, every grid encoding lands in one arena block,
+// and a result may be freed on another thread while its chunk is still in use.
+
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <windows.h>
+HINSTANCE g_hModule = NULL;
+
+#include "types/mem.h"
+#include "types/converters.h"
+
+static const size_t kChunk = 64 * 1024;
+
+static LPXLOPER12 MakeGridResult(int rows, int cols) {
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<flatbuffers::Offset<protocol::Scalar>> cells;
+    for (int i = 0; i < rows * cols; ++i) {
+        if (i % 2) {
+            cells.push_back(protocol::CreateScalar(builder, protocol::ScalarValue::Str,
+                                                   protocol::CreateStr(builder, builder.CreateString("cell" + std::to_string(i))).Union()));
+        } else {
+            cells.push_back(protocol::CreateScalar(builder, protocol::ScalarValue::Num,
+                                                   protocol::CreateNum(builder, (double)i).Union()));
+        }
+    }
+    auto grid = protocol::CreateGrid(builder, rows, cols, builder.CreateVector(cells));
+    builder.Finish(grid);
+    return GridToXLOPER12(flatbuffers::GetRoot<protocol::Grid>(builder.GetBufferPointer()));
+}
+
+static void Reset() {
+    DisableXlArena();
+    XlArenaTrim();
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.liveBytes == 0);
+    assert(s.chunks == 0 && s.reservedBytes == 0);
+}
+
+void TestDisabledUsesHeap() {
+    assert(!XlArenaEnabled());
+    LPXLOPER12 str = NewExcelString(L"heap");
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.chunks == 0 && s.liveResults == 0);
+    xlAutoFree12(str);
+    std::cout << "TestDisabledUsesHeap passed" << std::endl;
+}
+
+void TestLiveResultsAndStats() {
+    EnableXlArena(kChunk, 4);
+    assert(XlArenaEnabled());
+
+    LPXLOPER12 str = NewExcelString(L"arena");
+    assert(str->val.str[0] == 5 && std::memcmp(str->val.str + 1, L"arena", 5 * sizeof(XCHAR)) == 0);
+    LPXLOPER12 grid = MakeGridResult(4, 4);
+    assert(grid->xltype == (xltypeMulti | xlbitDLLFree));
+    assert(grid->val.array.lparray[1].xltype == xltypeStr); // slab layout: no per-cell bit
+
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.chunks == 1 && s.reservedBytes == kChunk);
+    assert(s.liveResults == 2 && s.liveBytes > 16 * sizeof(XLOPER12));
+
+    const XCHAR* first = str->val.str;
+    xlAutoFree12(str);
+    xlAutoFree12(grid);
+    s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.liveBytes == 0);
+    assert(s.chunks == 1); // still this thread's current chunk
+
+    // A drained current chunk is reused from the start.
+    LPXLOPER12 again = NewExcelString(L"arena");
+    assert(again->val.str == first && GetXlArenaStats().chunks == 1);
+    xlAutoFree12(again);
+
+    Reset();
+    std::cout << "TestLiveResultsAndStats passed" << std::endl;
+}
+
+void TestEpochRecyclesDrainedChunks() {
+    EnableXlArena(kChunk, 4);
+
+    LPXLOPER12 a = NewExcelString(L"first recalc");
+    XlArenaBeginEpoch();
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.epochs >= 1);
+    assert(s.chunks == 1 && s.freeChunks == 0); // retired but a is outstanding
+
+    LPXLOPER12 b = NewExcelString(L"second recalc");
+    s = GetXlArenaStats();
+    assert(s.chunks == 2 && s.liveResults == 2);
+
+    const size_t recycled = s.recycled;
+    xlAutoFree12(a); // drains the retired chunk
+    s = GetXlArenaStats();
+    assert(s.freeChunks == 1 && s.recycled == recycled + 1);
+
+    // The next epoch's chunk comes off the free list.
+    XlArenaBeginEpoch();
+    LPXLOPER12 c = NewExcelString(L"third recalc");
+    s = GetXlArenaStats();
+    assert(s.chunks == 2 && s.freeChunks == 0);
+    xlAutoFree12(b);
+    xlAutoFree12(c);
+
+    Reset();
+    std::cout << "TestEpochRecyclesDrainedChunks passed" << std::endl;
+}
+
+void TestOutstandingBlocksReuse() {
+    EnableXlArena(4096, 4);
+
+    // Fill several chunks; every full chunk is retired but pinned by one result.
+    std::vector<LPXLOPER12> results;
+    const std::wstring body(500, L'x'); // ~1 KiB per payload
+    for (int i = 0; i < 16; ++i) results.push_back(NewExcelString(body));
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.chunks >= 4 && s.freeChunks == 0 && s.liveResults == 16);
+
+    // Payloads never overlap while outstanding.
+    for (size_t i = 0; i < results.size(); ++i) {
+        assert(results[i]->val.str[0] == 500 && results[i]->val.str[500] == L'x');
+        results[i]->val.str[1] = (XCHAR)i;
+    }
+    for (size_t i = 0; i < results.size(); ++i) assert(results[i]->val.str[1] == (XCHAR)i);
+
+    // Every retired chunk drains and is kept; the current one holds the last result.
+    const size_t chunks = s.chunks;
+    for (size_t i = 0; i + 1 < results.size(); ++i) xlAutoFree12(results[i]);
+    s = GetXlArenaStats();
+    assert(s.liveResults == 1);
+    assert(s.freeChunks == (chunks - 1 < 4 ? chunks - 1 : 4)); // bounded by maxFreeChunks
+    xlAutoFree12(results.back());
+
+    XlArenaTrim();
+    assert(GetXlArenaStats().freeChunks == 0);
+
+    Reset();
+    std::cout << "TestOutstandingBlocksReuse passed" << std::endl;
+}
+
+void TestOversizePayload() {
+    EnableXlArena(4096, 4);
+
+    LPXLOPER12 big = MakeGridResult(100, 10); // far larger than one chunk
+    assert(big->xltype == (xltypeMulti | xlbitDLLFree));
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.liveResults == 1 && s.reservedBytes >= 1000 * sizeof(XLOPER12));
+    xlAutoFree12(big);
+    s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.chunks == 0 && s.freeChunks == 0); // dedicated chunk freed
+
+    // A numeric grid and a range also come from the arena.
+    flatbuffers::FlatBufferBuilder builder;
+    std::vector<double> nums(6, 1.5);
+    auto ng = protocol::CreateNumGrid(builder, 2, 3, builder.CreateVector(nums));
+    builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+    LPXLOPER12 num = AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer()));
+    assert(num->xltype == (xltypeMulti | xlbitDLLFree) && num->val.array.lparray[5].val.num == 1.5);
+
+    flatbuffers::FlatBufferBuilder rb;
+    std::vector<protocol::Rect> rects = {protocol::Rect(0, 1, 0, 1), protocol::Rect(4, 4, 2, 3)};
+    rb.Finish(protocol::CreateRange(rb, rb.CreateString(""), rb.CreateVectorOfStructs(rects)));
+    LPXLOPER12 ref = RangeToXLOPER12(flatbuffers::GetRoot<protocol::Range>(rb.GetBufferPointer()));
+    assert(ref->xltype == (xltypeRef | xlbitDLLFree) && ref->val.mref.lpmref->count == 2);
+    assert(ref->val.mref.lpmref->reftbl[1].rwFirst == 4);
+
+    assert(GetXlArenaStats().liveResults == 2);
+    xlAutoFree12(num);
+    xlAutoFree12(ref);
+    assert(GetXlArenaStats().liveResults == 0);
+
+    Reset();
+    std::cout << "TestOversizePayload passed" << std::endl;
+}
+
+void TestNumGridFromArena() {
+    EnableXlArena(kChunk, 4);
+
+    // Arena arrays are 32-byte aligned; 200 x 200 cells (1.25 MiB) also takes
+    // the streaming-store fill.
+    const int shapes[][2] = {{3, 3}, {200, 200}};
+    for (const auto& shape : shapes) {
+        const int rows = shape[0], cols = shape[1];
+        std::vector<double> values((size_t)rows * cols);
+        for (size_t i = 0; i < values.size(); ++i) values[i] = (double)i + 0.5;
+        flatbuffers::FlatBufferBuilder builder;
+        auto ng = protocol::CreateNumGrid(builder, rows, cols, builder.CreateVector(values));
+        builder.Finish(protocol::CreateAny(builder, protocol::AnyValue::NumGrid, ng.Union()));
+        LPXLOPER12 op = AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer()));
+        assert(op->xltype == (xltypeMulti | xlbitDLLFree));
+        assert(reinterpret_cast<uintptr_t>(op->val.array.lparray) % 32 == 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            assert(op->val.array.lparray[i].xltype == xltypeNum);
+            assert(op->val.array.lparray[i].val.num == values[i]);
+        }
+        xlAutoFree12(op);
+    }
+
+    Reset();
+    std::cout << "TestNumGridFromArena passed" << std::endl;
+}
+
+static LPXLOPER12 FinishAny(flatbuffers::FlatBufferBuilder& builder, protocol::AnyValue type,
+                            flatbuffers::Offset<void> val) {
+    builder.Finish(protocol::CreateAny(builder, type, val));
+    return AnyToXLOPER12(flatbuffers::GetRoot<protocol::Any>(builder.GetBufferPointer()));
+}
+
+static flatbuffers::Offset<protocol::Scalar> StrScalar(flatbuffers::FlatBufferBuilder& builder, const char* s) {
+    return protocol::CreateScalar(builder, protocol::ScalarValue::Str,
+                                  protocol::CreateStr(builder, builder.CreateString(s)).Union());
+}
+
+// The result is one arena block holding the elements and every string body:
+// one live result, no per-cell xlbitDLLFree, and the string at `strCell`.
+static void CheckArenaGrid(LPXLOPER12 op, size_t count, size_t strCell, const wchar_t* expect) {
+    assert(op->xltype == (xltypeMulti | xlbitDLLFree));
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.liveResults == 1);
+    assert(s.liveBytes >= count * sizeof(XLOPER12));
+    const XLOPER12& cell = op->val.array.lparray[strCell];
+    assert(cell.xltype == xltypeStr);
+    size_t len = 0;
+    while (expect[len]) ++len;
+    assert((size_t)cell.val.str[0] == len && std::memcmp(cell.val.str + 1, expect, len * sizeof(XCHAR)) == 0);
+    const char* body = reinterpret_cast<const char*>(cell.val.str);
+    const char* block = reinterpret_cast<const char*>(op->val.array.lparray);
+    assert(body >= block + count * sizeof(XLOPER12) && body < block + s.liveBytes);
+    xlAutoFree12(op);
+    s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.liveBytes == 0);
+}
+
+void TestGridEncodingsFromArena() {
+    EnableXlArena(kChunk, 4);
+    const int rows = 4, cols = 3;
+    const size_t count = (size_t)rows * cols;
+
+    {   // NumGridEx: numbers with a string exception.
+        flatbuffers::FlatBufferBuilder builder;
+        std::vector<double> data(count, 1.5);
+        std::vector<uint32_t> excIndex = {2, 7};
+        std::vector<flatbuffers::Offset<protocol::Scalar>> excValues = {
+            StrScalar(builder, "n/a"), StrScalar(builder, "ex\xC3\xA9")};
+        auto ng = protocol::CreateNumGridEx(builder, rows, cols, builder.CreateVector(data),
+                                            builder.CreateVector(excIndex), builder.CreateVector(excValues));
+        LPXLOPER12 op = FinishAny(builder, protocol::AnyValue::NumGridEx, ng.Union());
+        assert(op->val.array.lparray[0].xltype == xltypeNum && op->val.array.lparray[0].val.num == 1.5);
+        assert(op->val.array.lparray[2].xltype == xltypeStr);
+        CheckArenaGrid(op, count, 7, L"ex\u00E9");
+    }
+
+    {   // SparseGrid: nils with a few strings.
+        flatbuffers::FlatBufferBuilder builder;
+        std::vector<uint32_t> index = {0, 11};
+        std::vector<flatbuffers::Offset<protocol::Scalar>> values = {StrScalar(builder, "first"),
+                                                                     StrScalar(builder, "last")};
+        auto sg = protocol::CreateSparseGrid(builder, rows, cols, builder.CreateVector(index),
+                                             builder.CreateVector(values));
+        LPXLOPER12 op = FinishAny(builder, protocol::AnyValue::SparseGrid, sg.Union());
+        assert(op->val.array.lparray[5].xltype == xltypeNil);
+        CheckArenaGrid(op, count, 11, L"last");
+    }
+
+    {   // ColumnGrid: a Num column and a Str column (one null) per row.
+        flatbuffers::FlatBufferBuilder builder;
+        std::vector<double> nums = {1, 2, 3, 4};
+        std::vector<flatbuffers::Offset<flatbuffers::String>> strs = {
+            builder.CreateString("a"), builder.CreateString("bb"), builder.CreateString(""),
+            builder.CreateString("dddd")};
+        std::vector<uint8_t> nulls = {0x04}; // row 2 of the Str column
+        std::vector<flatbuffers::Offset<protocol::Column>> columns = {
+            protocol::CreateColumn(builder, protocol::ColumnType::Num, 0, builder.CreateVector(nums)),
+            protocol::CreateColumn(builder, protocol::ColumnType::Str, builder.CreateVector(nulls), 0, 0, 0,
+                                   builder.CreateVector(strs)),
+            protocol::CreateColumn(builder, protocol::ColumnType::Num, 0, builder.CreateVector(nums))};
+        auto cg = protocol::CreateColumnGrid(builder, rows, cols, builder.CreateVector(columns));
+        LPXLOPER12 op = FinishAny(builder, protocol::AnyValue::ColumnGrid, cg.Union());
+        assert(op->val.array.lparray[2 * cols + 1].xltype == xltypeNil);
+        assert(op->val.array.lparray[3 * cols + 2].val.num == 4);
+        CheckArenaGrid(op, count, 3 * cols + 1, L"dddd");
+    }
+
+    Reset();
+    std::cout << "TestGridEncodingsFromArena passed" << std::endl;
+}
+
+void TestDisableWithOutstanding() {
+    EnableXlArena(kChunk, 4);
+    LPXLOPER12 str = NewExcelString(L"outlives the arena");
+    DisableXlArena();
+    assert(!XlArenaEnabled());
+    assert(GetXlArenaStats().chunks == 1);
+
+    LPXLOPER12 heap = NewExcelString(L"heap");
+    assert(GetXlArenaStats().liveResults == 1);
+    xlAutoFree12(heap);
+    xlAutoFree12(str); // chunk freed, not kept: the arena is off
+    Reset();
+    std::cout << "TestDisableWithOutstanding passed" << std::endl;
+}
+
+void TestCrossThreadFree() {
+    EnableXlArena(kChunk, 4);
+
+    std::vector<LPXLOPER12> made;
+    std::thread producer([&]() {
+        for (int i = 0; i < 8; ++i) made.push_back(NewExcelString(L"from worker"));
+    }); // thread exit retires the worker's chunk
+    producer.join();
+
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.chunks == 1 && s.liveResults == 8 && s.freeChunks == 0);
+    for (LPXLOPER12 p : made) xlAutoFree12(p);
+    s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.freeChunks == 1);
+
+    Reset();
+    std::cout << "TestCrossThreadFree passed" << std::endl;
+}
+
+void TestChunkSizeRoundsToPowerOfTwo() {
+    EnableXlArena(5000, 4);
+    LPXLOPER12 str = NewExcelString(L"rounded");
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.chunks == 1 && s.reservedBytes == 8192);
+    xlAutoFree12(str);
+    Reset();
+    std::cout << "TestChunkSizeRoundsToPowerOfTwo passed" << std::endl;
+}
+
+void TestConcurrentProducersAndFreer() {
+    EnableXlArena(4096, 4);
+
+    // Workers keep allocating into their current chunks while another thread
+    // frees their earlier results.
+    const int kWorkers = 4, kPerWorker = 2000;
+    std::vector<std::atomic<LPXLOPER12>> slots(kWorkers * kPerWorker);
+    for (auto& slot : slots) slot.store(nullptr);
+    std::vector<std::thread> workers;
+    for (int w = 0; w < kWorkers; ++w) {
+        workers.emplace_back([&, w]() {
+            for (int i = 0; i < kPerWorker; ++i) {
+                LPXLOPER12 p = NewExcelString(i % 16 ? L"small" : std::wstring(300, L'y'));
+                p->val.str[1] = (XCHAR)w;
+                slots[w * kPerWorker + i].store(p, std::memory_order_release);
+            }
+        });
+    }
+    std::thread freer([&]() {
+        for (auto& slot : slots) {
+            LPXLOPER12 p;
+            while (!(p = slot.load(std::memory_order_acquire))) std::this_thread::yield();
+            xlAutoFree12(p);
+        }
+    });
+    for (auto& t : workers) t.join();
+    freer.join();
+
+    XlArenaStats s = GetXlArenaStats();
+    assert(s.liveResults == 0 && s.liveBytes == 0);
+    assert(s.freeChunks <= 4);
+    Reset();
+    std::cout << "TestConcurrentProducersAndFreer passed" << std::endl;
+}
+
+int main() {
+    TestDisabledUsesHeap();
+    TestLiveResultsAndStats();
+    TestEpochRecyclesDrainedChunks();
+    TestOutstandingBlocksReuse();
+    TestOversizePayload();
+    TestNumGridFromArena();
+    TestGridEncodingsFromArena();
+    TestDisableWithOutstanding();
+    TestCrossThreadFree();
+    TestChunkSizeRoundsToPowerOfTwo();
+    TestConcurrentProducersAndFreer();
+    std::cout << "All XLOPER12 arena tests passed" << std::endl;
+    return 0;
+}